@@ -122,6 +122,24 @@ int main(int argc, char *argv[]) {
   auto prediction = K->predict(test_points, weights);
   cout << "# prediction took " << timer.elapsed() << endl;
 
+  cout << endl << "# treecode prediction start..." << endl;
+  timer.start();
+  Treecode<scalar_t> tc(*K, weights, hss_opts.rel_tol());
+  cout << "# treecode construction took " << timer.elapsed() << endl
+       << "# treecode max rank = " << tc.max_rank()
+       << ", memory = " << tc.memory() / 1e6 << " MB" << endl;
+  timer.start();
+  auto tc_prediction = tc.predict(test_points);
+  cout << "# treecode prediction took " << timer.elapsed() << endl;
+  scalar_t err = 0., nrm = 0.;
+  for (size_t i=0; i<m; i++) {
+    err += (prediction[i] - tc_prediction[i]) *
+      (prediction[i] - tc_prediction[i]);
+    nrm += prediction[i] * prediction[i];
+  }
+  cout << "# ||prediction - treecode||_2 / ||prediction||_2 = "
+       << std::sqrt(err / nrm) << endl;
+
   // compute accuracy score of prediction
   size_t incorrect_quant = 0;
   for (size_t i=0; i<m; i++)
@@ -141,6 +141,13 @@ int main(int argc, char *argv[]) {
     auto prediction = K->predict(test_points, weights);
     if (c.is_root()) cout << "# prediction took " << timer.elapsed() << endl;
     check(prediction);
+
+    if (c.is_root()) cout << "# HSS treecode prediction start..." << endl;
+    timer.start();
+    Treecode<scalar_t> tc(*K, weights, opts.rel_tol());
+    prediction = tc.predict(c, test_points);
+    if (c.is_root()) cout << "# prediction took " << timer.elapsed() << endl;
+    check(prediction);
   }
 
 #if defined(STRUMPACK_USE_BPACK)
@@ -618,6 +618,9 @@ namespace strumpack {
       B11.piv_.resize(B11.rows());
       auto rb = B11.rowblocks();
       auto rb2 = B21.rowblocks();
+      // with an empty A22, the Schur complement update of A22 is left
+      // to the caller, for instance to build it one tile at a time
+      auto rb22 = A22.rows() ? rb2 : 0;
       //#pragma omp parallel if(!omp_in_parallel())
       //#pragma omp single nowait
       {
@@ -742,8 +745,8 @@ namespace strumpack {
                   }
                 }
               }
-              for (std::size_t j=0; j<rb2; j++) {
-                for (std::size_t k=0; k<rb2; k++) {
+              for (std::size_t j=0; j<rb22; j++) {
+                for (std::size_t k=0; k<rb22; k++) {
 #if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
                   std::size_t ij2 = i+lrb*(rb+j), k2i = (rb+k)+lrb*i,
                     k2j2 = (rb+k)+lrb*(rb+j);
@@ -858,8 +861,8 @@ namespace strumpack {
             }
           }
           if (opts.BLR_factor_algorithm() != BLRFactorAlgorithm::RL) {
-            for (std::size_t i=0; i<rb2; i++) {
-              for (std::size_t j=0; j<rb2; j++) {
+            for (std::size_t i=0; i<rb22; i++) {
+              for (std::size_t j=0; j<rb22; j++) {
                 if (opts.BLR_factor_algorithm() == BLRFactorAlgorithm::LL) {
                   for (std::size_t k=0; k<rb; k++) {
 #if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
@@ -27,6 +27,8 @@
  */
 #include "BLROptions.hpp"
 #include "StrumpackConfig.hpp"
+#include <cmath>
+#include <algorithm>
 #if defined(STRUMPACK_USE_GETOPT)
 #include <vector>
 #include <sstream>
@@ -75,6 +77,23 @@ namespace strumpack {
       }
     }
 
+    std::string get_name(Tiling a) {
+      switch (a) {
+      case Tiling::UNIFORM: return "uniform";
+      case Tiling::ADAPTIVE: return "adaptive";
+      default: return "unknown";
+      }
+    }
+
+    template<typename scalar_t> std::size_t
+    BLROptions<scalar_t>::tile_size(std::size_t m, double r) const {
+      if (tiling_ == Tiling::UNIFORM) return this->leaf_size();
+      if (r <= 0.) r = this->leaf_size() / 16.;
+      double b = std::sqrt(double(m) * std::max(r, 1.));
+      return std::max(std::size_t(min_leaf_), std::min
+                      (std::size_t(max_leaf_), std::size_t(std::round(b))));
+    }
+
     template<typename scalar_t> void
     BLROptions<scalar_t>::set_from_command_line
     (int argc, const char* const* cargv) {
@@ -96,6 +115,11 @@ namespace strumpack {
          {"blr_BACA_blocksize",        required_argument, 0, 7},
          {"blr_factor_algorithm",      required_argument, 0, 8},
          {"blr_compression_kernel",    required_argument, 0, 9},
+         {"blr_tiling",                required_argument, 0, 10},
+         {"blr_min_leaf_size",         required_argument, 0, 11},
+         {"blr_max_leaf_size",         required_argument, 0, 12},
+         {"blr_enable_cb_compression", no_argument, 0, 13},
+         {"blr_disable_cb_compression", no_argument, 0, 14},
          {"blr_verbose",               no_argument, 0, 'v'},
          {"blr_quiet",                 no_argument, 0, 'q'},
          {"help",                      no_argument, 0, 'h'},
@@ -187,6 +211,30 @@ namespace strumpack {
                       << " recognized, use 'full' or 'half'."
                       << std::endl;
         } break;
+        case 10: {
+          std::istringstream iss(optarg);
+          std::string s; iss >> s;
+          if (s == "uniform")
+            set_tiling(Tiling::UNIFORM);
+          else if (s == "adaptive")
+            set_tiling(Tiling::ADAPTIVE);
+          else
+            std::cerr << "# WARNING: tiling not"
+                      << " recognized, use 'uniform' or 'adaptive'."
+                      << std::endl;
+        } break;
+        case 11: {
+          std::istringstream iss(optarg);
+          iss >> min_leaf_;
+          set_min_leaf_size(min_leaf_);
+        } break;
+        case 12: {
+          std::istringstream iss(optarg);
+          iss >> max_leaf_;
+          set_max_leaf_size(max_leaf_);
+        } break;
+        case 13: enable_CB_compression(); break;
+        case 14: disable_CB_compression(); break;
         case 'v': this->set_verbose(true); break;
         case 'q': this->set_verbose(false); break;
         case 'h': describe_options(); break;
@@ -223,6 +271,26 @@ namespace strumpack {
                 << "#   --blr_compression_kernel (default "
                 << get_name(crn_krnl_) << ")" << std::endl
                 << "#      should be [full|half]" << std::endl
+                << "#   --blr_tiling (default "
+                << get_name(tiling_) << ")" << std::endl
+                << "#      should be [uniform|adaptive], adaptive picks"
+                << std::endl
+                << "#      the tile size (and admissibility) per front"
+                << std::endl
+                << "#   --blr_min_leaf_size int (default "
+                << min_leaf_size() << ")" << std::endl
+                << "#      smallest tile size with adaptive tiling"
+                << std::endl
+                << "#   --blr_max_leaf_size int (default "
+                << max_leaf_size() << ")" << std::endl
+                << "#      largest tile size with adaptive tiling"
+                << std::endl
+                << "#   --blr_enable_cb_compression (default "
+                << CB_compression() << ")" << std::endl
+                << "#      keep the contribution blocks of BLR fronts"
+                << " compressed" << std::endl
+                << "#   --blr_disable_cb_compression (default "
+                << !CB_compression() << ")" << std::endl
                 << "#   --blr_BACA_blocksize int (default "
                 << BACA_blocksize() << ")" << std::endl
                 << "#   --blr_verbose or -v (default "
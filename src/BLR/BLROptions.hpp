@@ -68,6 +68,17 @@ namespace strumpack {
     enum class CompressionKernel { HALF, FULL };
     std::string get_name(CompressionKernel a);
 
+    /**
+     * Enumeration of strategies to select the tile size of the BLR
+     * fronts in the sparse solver.
+     * \ingroup Enumerations
+     */
+    enum class Tiling {
+      UNIFORM,  /*!< all tiles have (about) size leaf_size()      */
+      ADAPTIVE  /*!< tile size chosen per front, see tile_size() */
+    };
+    std::string get_name(Tiling a);
+
 
     /**
      * \class BLROptions
@@ -113,12 +124,43 @@ namespace strumpack {
       void set_compression_kernel(CompressionKernel a) {
         crn_krnl_ = a;
       }
+      void set_tiling(Tiling t) { tiling_ = t; }
+      void set_min_leaf_size(int s) { assert(s > 0); min_leaf_ = s; }
+      void set_max_leaf_size(int s) { assert(s > 0); max_leaf_ = s; }
+      /**
+       * Keep the contribution block (Schur complement) of a BLR
+       * front in BLR form, with compressed off-diagonal tiles, until
+       * it is assembled in the parent front. This reduces the peak
+       * memory, at the cost of an extra compression of the
+       * contribution block.
+       */
+      void enable_CB_compression() { cb_compression_ = true; }
+      void disable_CB_compression() { cb_compression_ = false; }
 
       LowRankAlgorithm low_rank_algorithm() const { return lr_algo_; }
       Admissibility admissibility() const { return adm_; }
       int BACA_blocksize() const { return BACA_blocksize_; }
       BLRFactorAlgorithm BLR_factor_algorithm() const { return blr_algo_; }
       CompressionKernel compression_kernel() const { return crn_krnl_; }
+      Tiling tiling() const { return tiling_; }
+      int min_leaf_size() const { return min_leaf_; }
+      int max_leaf_size() const { return max_leaf_; }
+      bool CB_compression() const { return cb_compression_; }
+
+      /**
+       * Tile size for a front of dimension m. With Tiling::UNIFORM
+       * this is leaf_size(). With Tiling::ADAPTIVE this is
+       * sqrt(m*r), clamped to [min_leaf_size(), max_leaf_size()],
+       * which minimizes the BLR factorization cost for tiles of
+       * rank r. When no ranks are known, r = leaf_size()/16 is used,
+       * so leaf_size() is then the tile size for a front of
+       * dimension 16*leaf_size().
+       *
+       * \param m dimension of the front
+       * \param r (average) rank of the low-rank tiles, for instance
+       * observed in a previous factorization, or <= 0 if unknown
+       */
+      std::size_t tile_size(std::size_t m, double r=0.) const;
 
       void set_from_command_line(int argc, const char* const* cargv) override;
 
@@ -131,6 +173,9 @@ namespace strumpack {
       Admissibility adm_ = Admissibility::WEAK;
       BLRFactorAlgorithm blr_algo_ = BLRFactorAlgorithm::RL;
       CompressionKernel crn_krnl_ = CompressionKernel::HALF;
+      Tiling tiling_ = Tiling::UNIFORM;
+      int min_leaf_ = 32, max_leaf_ = 1024;
+      bool cb_compression_ = false;
 
       void set_defaults() {
         this->rel_tol_ = default_BLR_rel_tol<real_t>();
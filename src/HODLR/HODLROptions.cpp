@@ -91,6 +91,8 @@ namespace strumpack {
          {"hodlr_disable_less_adapt",    no_argument, 0, 17},
          {"hodlr_enable_BF_entry_n15",     no_argument, 0, 18},
          {"hodlr_disable_BF_entry_n15",    no_argument, 0, 19},
+         {"hodlr_enable_balanced_clustering",  no_argument, 0, 20},
+         {"hodlr_disable_balanced_clustering", no_argument, 0, 21},
          {"hodlr_verbose",               no_argument, 0, 'v'},
          {"hodlr_quiet",                 no_argument, 0, 'q'},
          {"help",                        no_argument, 0, 'h'},
@@ -181,6 +183,8 @@ namespace strumpack {
         case 17: set_less_adapt(false); break;
         case 18: set_BF_entry_n15(true); break;
         case 19: set_BF_entry_n15(false); break;
+        case 20: set_balanced_clustering(true); break;
+        case 21: set_balanced_clustering(false); break;
         case 'v': this->set_verbose(true); break;
         case 'q': this->set_verbose(false); break;
         case 'h': describe_options(); break;
@@ -211,6 +215,10 @@ namespace strumpack {
                 << rank_rate() << ")" << std::endl
                 << "#   --hodlr_clustering_algorithm natural|2means|kdtree|pca|cobble (default "
                 << get_name(clustering_algorithm()) << ")" << std::endl
+                << "#   --hodlr_enable_balanced_clustering (default "
+                << balanced_clustering() << ")" << std::endl
+                << "#   --hodlr_disable_balanced_clustering (default "
+                << !balanced_clustering() << ")" << std::endl
                 << "#   --hodlr_butterfly_levels int (default "
                 << butterfly_levels() << ")" << std::endl
                 << "#   --hodlr_compression sampling|extraction (default "
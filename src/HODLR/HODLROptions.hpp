@@ -162,6 +162,15 @@ namespace strumpack {
         clustering_algo_ = a;
       }
 
+      /**
+       * Always split clusters in two halves when constructing the
+       * cluster tree of a kernel matrix. This gives balanced leaf
+       * sizes, and hence better load balance.
+       */
+      void set_balanced_clustering(bool b) {
+        balanced_clustering_ = b;
+      }
+
       /**
        * Specify the compression algorithm to be used.
        */
@@ -267,6 +276,13 @@ namespace strumpack {
         return clustering_algo_;
       }
 
+      /**
+       * Use balanced clustering?
+       * \return True if clusters are always split in two halves
+       * \see set_balanced_clustering
+       */
+      bool balanced_clustering() const { return balanced_clustering_; }
+
       /**
        * Get the compression algorithm to be used.
        * \return compression algorithm
@@ -345,6 +361,7 @@ namespace strumpack {
       int rank_guess_ = 128;
       double rank_rate_ = 2.;
       ClusteringAlgorithm clustering_algo_ = ClusteringAlgorithm::COBBLE;
+      bool balanced_clustering_ = false;
       int butterfly_levels_ = 0;
       CompressionAlgorithm compression_algo_ = CompressionAlgorithm::ELEMENT_EXTRACTION;
       int BACA_block_size_ = 16;
@@ -0,0 +1,243 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <algorithm>
+
+#include "NativeHODLRMatrix.hpp"
+#include "StrumpackParameters.hpp"
+
+namespace strumpack {
+  namespace HODLR {
+
+    template<typename scalar_t> NativeHODLRMatrix<scalar_t>::NativeHODLRMatrix
+    (const structured::ClusterTree& t, const DenseM_t& A,
+     const opts_t& opts, int task_depth)
+      : rows_(t.size), rel_tol_(opts.rel_tol()), abs_tol_(opts.abs_tol()),
+        max_rank_(opts.max_rank()) {
+      assert(A.rows() == rows_ && A.cols() == rows_);
+      if (t.c.empty()) {
+        D_ = A;
+        return;
+      }
+      std::size_t n0 = t.c[0].size, n1 = t.c[1].size;
+      auto A11 = ConstDenseMatrixWrapperPtr(n0, n0, A, 0, 0);
+      auto A12 = ConstDenseMatrixWrapperPtr(n0, n1, A, 0, n0);
+      auto A21 = ConstDenseMatrixWrapperPtr(n1, n0, A, n0, 0);
+      auto A22 = ConstDenseMatrixWrapperPtr(n1, n1, A, n0, n0);
+      ch_.resize(2);
+      bool tasked = task_depth < params::task_recursion_cutoff_level;
+#pragma omp task default(shared) if(tasked) final(!tasked) mergeable
+      ch_[0] = NativeHODLRMatrix<scalar_t>(t.c[0], *A11, opts, task_depth+1);
+#pragma omp task default(shared) if(tasked) final(!tasked) mergeable
+      ch_[1] = NativeHODLRMatrix<scalar_t>(t.c[1], *A22, opts, task_depth+1);
+#pragma omp task default(shared) if(tasked) final(!tasked) mergeable
+      compress(*A12, U12_, V12_, task_depth+1);
+#pragma omp task default(shared) if(tasked) final(!tasked) mergeable
+      compress(*A21, U21_, V21_, task_depth+1);
+#pragma omp taskwait
+    }
+
+    template<typename scalar_t> void NativeHODLRMatrix<scalar_t>::compress
+    (const DenseM_t& A, DenseM_t& U, DenseM_t& V, int task_depth) const {
+      if (A.rows() == 0 || A.cols() == 0) {
+        U = DenseM_t(A.rows(), 0);
+        V = DenseM_t(0, A.cols());
+        return;
+      }
+      A.low_rank(U, V, rel_tol_, abs_tol_, max_rank_, task_depth);
+      if (int(U.cols()) > max_rank_) {
+        U.resize(U.rows(), max_rank_);
+        V.resize(max_rank_, V.cols());
+      }
+    }
+
+    template<typename scalar_t> void NativeHODLRMatrix<scalar_t>::recompress
+    (DenseM_t& U, DenseM_t& V, int task_depth) const {
+      if (U.cols() == 0) return;
+      // U = Q R, with Q orthonormal, then compress R V
+      DenseM_t Q, R;
+      U.low_rank(Q, R, real_t(0.), real_t(0.), max_rank_, task_depth);
+      DenseM_t RV(R.rows(), V.cols());
+      gemm(Trans::N, Trans::N, scalar_t(1.), R, V,
+           scalar_t(0.), RV, task_depth);
+      DenseM_t W;
+      compress(RV, W, V, task_depth);
+      U = DenseM_t(Q.rows(), W.cols());
+      gemm(Trans::N, Trans::N, scalar_t(1.), Q, W,
+           scalar_t(0.), U, task_depth);
+    }
+
+    template<typename scalar_t> std::size_t
+    NativeHODLRMatrix<scalar_t>::rank() const {
+      if (leaf()) return 0;
+      return std::max({U12_.cols(), X_.cols(), U21_.cols(),
+            ch_[0].rank(), ch_[1].rank()});
+    }
+
+    template<typename scalar_t> std::size_t
+    NativeHODLRMatrix<scalar_t>::nonzeros() const {
+      if (leaf()) return D_.nonzeros();
+      return U12_.nonzeros() + V12_.nonzeros() + U21_.nonzeros()
+        + V21_.nonzeros() + X_.nonzeros()
+        + ch_[0].nonzeros() + ch_[1].nonzeros();
+    }
+
+    template<typename scalar_t> DenseMatrix<scalar_t>
+    NativeHODLRMatrix<scalar_t>::dense() const {
+      if (leaf()) return D_;
+      DenseM_t A(rows_, rows_);
+      std::size_t n0 = ch_[0].rows();
+      copy(ch_[0].dense(), A, 0, 0);
+      copy(ch_[1].dense(), A, n0, n0);
+      DenseMW_t A12(n0, rows_-n0, A, 0, n0), A21(rows_-n0, n0, A, n0, 0);
+      gemm(Trans::N, Trans::N, scalar_t(1.), U12_, V12_, scalar_t(0.), A12);
+      gemm(Trans::N, Trans::N, scalar_t(1.), U21_, V21_, scalar_t(0.), A21);
+      return A;
+    }
+
+    template<typename scalar_t> void NativeHODLRMatrix<scalar_t>::mult
+    (const DenseM_t& X, DenseM_t& Y, int task_depth) const {
+      if (leaf()) {
+        gemm(Trans::N, Trans::N, scalar_t(1.), D_, X,
+             scalar_t(0.), Y, task_depth);
+        return;
+      }
+      std::size_t n0 = ch_[0].rows(), n1 = rows_ - n0, c = X.cols();
+      auto X0 = ConstDenseMatrixWrapperPtr(n0, c, X, 0, 0);
+      auto X1 = ConstDenseMatrixWrapperPtr(n1, c, X, n0, 0);
+      DenseMW_t Y0(n0, c, Y, 0, 0), Y1(n1, c, Y, n0, 0);
+      ch_[0].mult(*X0, Y0, task_depth);
+      ch_[1].mult(*X1, Y1, task_depth);
+      DenseM_t T12(V12_.rows(), c), T21(V21_.rows(), c);
+      gemm(Trans::N, Trans::N, scalar_t(1.), V12_, *X1,
+           scalar_t(0.), T12, task_depth);
+      gemm(Trans::N, Trans::N, scalar_t(1.), U12_, T12,
+           scalar_t(1.), Y0, task_depth);
+      gemm(Trans::N, Trans::N, scalar_t(1.), V21_, *X0,
+           scalar_t(0.), T21, task_depth);
+      gemm(Trans::N, Trans::N, scalar_t(1.), U21_, T21,
+           scalar_t(1.), Y1, task_depth);
+    }
+
+    template<typename scalar_t> void NativeHODLRMatrix<scalar_t>::add_low_rank
+    (const DenseM_t& U, const DenseM_t& V, int task_depth) {
+      if (U.cols() == 0) return;
+      if (leaf()) {
+        gemm(Trans::N, Trans::N, scalar_t(1.), U, V,
+             scalar_t(1.), D_, task_depth);
+        return;
+      }
+      std::size_t n0 = ch_[0].rows(), n1 = rows_ - n0, k = U.cols();
+      DenseM_t U0(n0, k, U, 0, 0), U1(n1, k, U, n0, 0),
+        V0(k, n0, V, 0, 0), V1(k, n1, V, 0, n0);
+      bool tasked = task_depth < params::task_recursion_cutoff_level;
+#pragma omp task default(shared) if(tasked) final(!tasked) mergeable
+      ch_[0].add_low_rank(U0, V0, task_depth+1);
+#pragma omp task default(shared) if(tasked) final(!tasked) mergeable
+      ch_[1].add_low_rank(U1, V1, task_depth+1);
+#pragma omp task default(shared) if(tasked) final(!tasked) mergeable
+      {
+        U12_ = hconcat(U12_, U0);
+        V12_ = vconcat(V12_, V1);
+        recompress(U12_, V12_, task_depth+1);
+      }
+#pragma omp task default(shared) if(tasked) final(!tasked) mergeable
+      {
+        U21_ = hconcat(U21_, U1);
+        V21_ = vconcat(V21_, V0);
+        recompress(U21_, V21_, task_depth+1);
+      }
+#pragma omp taskwait
+    }
+
+    template<typename scalar_t> int NativeHODLRMatrix<scalar_t>::factor
+    (real_t pivot_threshold, int task_depth) {
+      if (leaf()) {
+        int info = D_.LU(piv_, task_depth);
+        if (pivot_threshold > real_t(0.))
+          for (std::size_t i=0; i<D_.rows(); i++)
+            if (std::abs(D_(i,i)) < pivot_threshold)
+              D_(i,i) = (std::real(D_(i,i)) < 0) ?
+                -pivot_threshold : pivot_threshold;
+        return info;
+      }
+      int info = ch_[0].factor(pivot_threshold, task_depth);
+      if (U12_.cols()) {
+        X_ = U12_;
+        ch_[0].solve(X_, task_depth);
+      }
+      if (X_.cols() && U21_.cols()) {
+        // A22 - A21 inv(A11) A12 = A22 - U21 (V21 X) V12
+        DenseM_t W(V21_.rows(), X_.cols());
+        gemm(Trans::N, Trans::N, scalar_t(1.), V21_, X_,
+             scalar_t(0.), W, task_depth);
+        DenseM_t UW(U21_.rows(), W.cols());
+        gemm(Trans::N, Trans::N, scalar_t(-1.), U21_, W,
+             scalar_t(0.), UW, task_depth);
+        ch_[1].add_low_rank(UW, V12_, task_depth);
+      }
+      int info1 = ch_[1].factor(pivot_threshold, task_depth);
+      // U12_ is no longer needed, X_ is used in the solve
+      U12_ = DenseM_t();
+      return info ? info : info1;
+    }
+
+    template<typename scalar_t> void NativeHODLRMatrix<scalar_t>::solve
+    (DenseM_t& B, int task_depth) const {
+      if (leaf()) {
+        D_.solve_LU_in_place(B, piv_, task_depth);
+        return;
+      }
+      std::size_t n0 = ch_[0].rows(), n1 = rows_ - n0, c = B.cols();
+      DenseMW_t B0(n0, c, B, 0, 0), B1(n1, c, B, n0, 0);
+      ch_[0].solve(B0, task_depth);
+      if (U21_.cols()) {
+        DenseM_t T(V21_.rows(), c);
+        gemm(Trans::N, Trans::N, scalar_t(1.), V21_, B0,
+             scalar_t(0.), T, task_depth);
+        gemm(Trans::N, Trans::N, scalar_t(-1.), U21_, T,
+             scalar_t(1.), B1, task_depth);
+      }
+      ch_[1].solve(B1, task_depth);
+      if (X_.cols()) {
+        DenseM_t T(V12_.rows(), c);
+        gemm(Trans::N, Trans::N, scalar_t(1.), V12_, B1,
+             scalar_t(0.), T, task_depth);
+        gemm(Trans::N, Trans::N, scalar_t(-1.), X_, T,
+             scalar_t(1.), B0, task_depth);
+      }
+    }
+
+    // explicit template instantiations
+    template class NativeHODLRMatrix<float>;
+    template class NativeHODLRMatrix<double>;
+    template class NativeHODLRMatrix<std::complex<float>>;
+    template class NativeHODLRMatrix<std::complex<double>>;
+
+  } // end namespace HODLR
+} // end namespace strumpack
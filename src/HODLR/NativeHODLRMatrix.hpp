@@ -0,0 +1,172 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/**
+ * \file NativeHODLRMatrix.hpp
+ * \brief Shared-memory HODLR matrix, does not require ButterflyPACK.
+ */
+#ifndef STRUMPACK_NATIVE_HODLR_MATRIX_HPP
+#define STRUMPACK_NATIVE_HODLR_MATRIX_HPP
+
+#include <vector>
+
+#include "dense/DenseMatrix.hpp"
+#include "structured/ClusterTree.hpp"
+#include "HODLROptions.hpp"
+
+namespace strumpack {
+  namespace HODLR {
+
+    /**
+     * \class NativeHODLRMatrix
+     *
+     * \brief Square Hierarchically Off-Diagonal Low-Rank matrix,
+     * implemented in C++ on top of DenseMatrix and OpenMP tasks.
+     *
+     * Unlike HODLRMatrix, this does not wrap ButterflyPACK, it does
+     * not require MPI, and it supports all four scalar types. It is
+     * constructed from a dense matrix, so it does not reduce the
+     * peak memory usage compared to that dense matrix.
+     *
+     * The matrix is recursively split in 2x2 blocks, following a
+     * cluster tree. The off-diagonal blocks are stored as A12 = U12
+     * V12 and A21 = U21 V21, the diagonal blocks are again HODLR
+     * matrices, which are dense at the leaves. The LU factorization
+     * is computed in place: the Schur complement update of the
+     * trailing diagonal block is a low-rank update, which is added to
+     * the trailing HODLR block and recompressed, before that block is
+     * factored.
+     *
+     * \tparam scalar_t Can be float, double, std::complex<float> or
+     * std::complex<double>.
+     */
+    template<typename scalar_t> class NativeHODLRMatrix {
+      using DenseM_t = DenseMatrix<scalar_t>;
+      using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+      using real_t = typename RealType<scalar_t>::value_type;
+      using opts_t = HODLROptions<scalar_t>;
+
+    public:
+      /**
+       * Default constructor, creates an empty 0 x 0 matrix.
+       */
+      NativeHODLRMatrix() = default;
+
+      /**
+       * Construct a HODLR approximation of a dense matrix. The
+       * off-diagonal blocks are compressed with a rank-revealing QR,
+       * using the relative and absolute tolerances from opts.
+       *
+       * \param t cluster tree, t.size should equal A.rows()
+       * \param A dense square matrix to compress, not modified
+       * \param opts HODLR options, rel_tol, abs_tol and max_rank are
+       * used
+       * \param task_depth current OpenMP task recursion depth
+       */
+      NativeHODLRMatrix(const structured::ClusterTree& t, const DenseM_t& A,
+                        const opts_t& opts, int task_depth=0);
+
+      std::size_t rows() const { return rows_; }
+      std::size_t cols() const { return rows_; }
+
+      /**
+       * Return the maximum rank of the off-diagonal blocks.
+       */
+      std::size_t rank() const;
+
+      /**
+       * Return the number of scalars stored, ie, in the dense
+       * diagonal blocks and the low-rank generators.
+       */
+      std::size_t nonzeros() const;
+
+      /**
+       * Return the memory (in bytes) used by this matrix.
+       */
+      std::size_t memory() const { return nonzeros() * sizeof(scalar_t); }
+
+      /**
+       * Reconstruct the dense matrix, only valid before factor().
+       */
+      DenseM_t dense() const;
+
+      /**
+       * Compute Y = this * X, only valid before factor().
+       */
+      void mult(const DenseM_t& X, DenseM_t& Y, int task_depth=0) const;
+
+      /**
+       * Add a low-rank matrix, this = this + U V. The off-diagonal
+       * blocks are recompressed. This is only valid before factor().
+       *
+       * \param U matrix of size rows() x k
+       * \param V matrix of size k x cols()
+       */
+      void add_low_rank(const DenseM_t& U, const DenseM_t& V,
+                        int task_depth=0);
+
+      /**
+       * Compute the LU factorization, in place.
+       *
+       * \param pivot_threshold if positive, pivots smaller than this
+       * in absolute value are replaced by +/- pivot_threshold
+       * \return 0 on success, nonzero if an exactly zero pivot was
+       * encountered
+       */
+      int factor(real_t pivot_threshold=real_t(0.), int task_depth=0);
+
+      /**
+       * Solve a linear system with this (factored) matrix, B is
+       * overwritten with the solution.
+       */
+      void solve(DenseM_t& B, int task_depth=0) const;
+
+    private:
+      std::size_t rows_ = 0;
+      std::vector<NativeHODLRMatrix<scalar_t>> ch_;
+      // dense diagonal block at the leaves
+      DenseM_t D_;
+      std::vector<int> piv_;
+      // off-diagonal blocks A12 = U12_ V12_, A21 = U21_ V21_
+      DenseM_t U12_, V12_, U21_, V21_;
+      // after factorization: X_ = inv(A11) U12_
+      DenseM_t X_;
+      real_t rel_tol_ = real_t(0.), abs_tol_ = real_t(0.);
+      int max_rank_ = 0;
+
+      bool leaf() const { return ch_.empty(); }
+
+      void compress(const DenseM_t& A, DenseM_t& U, DenseM_t& V,
+                    int task_depth) const;
+      void recompress(DenseM_t& U, DenseM_t& V, int task_depth) const;
+    };
+
+  } // end namespace HODLR
+} // end namespace strumpack
+
+#endif // STRUMPACK_NATIVE_HODLR_MATRIX_HPP
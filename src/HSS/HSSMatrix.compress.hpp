@@ -164,6 +164,68 @@ namespace strumpack {
                   << total_nnz << std::endl;
     }
 
+    template<typename scalar_t> void HSSMatrix<scalar_t>::compress_warm
+    (const mult_t& Amult, const elem_t& Aelem, const opts_t& opts) {
+      if (!this->is_compressed() || opts.p() == 0 ||
+          opts.compression_algorithm() != CompressionAlgorithm::ORIGINAL ||
+          (!opts.user_defined_random() &&
+           opts.compression_sketch() != CompressionSketch::GAUSSIAN)) {
+        reset();
+        compress(Amult, Aelem, opts);
+        return;
+      }
+      TIMER_TIME(TaskType::HSS_COMPRESS, 0, t_compress);
+      // checking the old bases only needs the p oversampling
+      // samples, more are only drawn once a node is rejected
+      int d_old = 0, d = opts.p();
+      auto n = this->cols();
+      DenseM_t Rr, Rc, Sr, Sc;
+      std::unique_ptr<random::RandomGeneratorBase<real_t>> rgen;
+      if (!opts.user_defined_random())
+        rgen = random::make_random_generator<real_t>
+          (opts.random_engine(), opts.random_distribution());
+      WorkCompress<scalar_t> w;
+      do {
+        Rr.resize(n, d);
+        Rc.resize(n, d);
+        Sr.resize(n, d);
+        Sc.resize(n, d);
+        DenseMW_t Rr_new(n, d-d_old, Rr, 0, d_old);
+        DenseMW_t Rc_new(n, d-d_old, Rc, 0, d_old);
+        if (!opts.user_defined_random()) {
+          Rr_new.random(*rgen);
+          STRUMPACK_RANDOM_FLOPS
+            (rgen->flops_per_prng() * Rr_new.rows() * Rr_new.cols());
+          Rc_new.copy(Rr_new);
+        }
+        DenseMW_t Sr_new(n, d-d_old, Sr, 0, d_old);
+        DenseMW_t Sc_new(n, d-d_old, Sc, 0, d_old);
+        Amult(Rr_new, Rc_new, Sr_new, Sc_new);
+        if (opts.verbose())
+          std::cout << "# compressing with d = " << d-opts.p()
+                    << " + " << opts.p() << " (original"
+                    << (d_old ? ")" : ", warm start)") << std::endl;
+        // the first pass checks the old bases, nodes where that
+        // fails continue as in compress_original
+#pragma omp parallel if(!omp_in_parallel())
+#pragma omp single nowait
+        {
+          if (d_old == 0)
+            compress_recursive_warm
+              (Rr, Rc, Sr, Sc, Aelem, opts, w, this->openmp_task_depth_);
+          else
+            compress_recursive_original
+              (Rr, Rc, Sr, Sc, Aelem, opts, w, d-d_old,
+               this->openmp_task_depth_);
+        }
+        if (!this->is_compressed()) {
+          d_old = d;
+          d = (d_old == opts.p()) ? opts.d0() + opts.p() :
+            2 * (d_old - opts.p()) + opts.p();
+        }
+      } while (!this->is_compressed());
+    }
+
     template<typename scalar_t> void
     HSSMatrix<scalar_t>::compress_hard_restart
     (const DenseM_t& A, const opts_t& opts) {
@@ -367,6 +429,89 @@ namespace strumpack {
       }
     }
 
+    template<typename scalar_t> bool
+    HSSMatrix<scalar_t>::compress_recursive_warm
+    (DenseM_t& Rr, DenseM_t& Rc, DenseM_t& Sr, DenseM_t& Sc,
+     const elem_t& Aelem, const opts_t& opts,
+     WorkCompress<scalar_t>& w, int depth) {
+      // the old bases of a node can only be kept if its children
+      // kept theirs, otherwise the skeleton has changed
+      bool keep = true;
+      reused_ = false;
+      this->U_state_ = this->V_state_ = State::UNTOUCHED;
+      if (this->leaf()) {
+        std::vector<std::size_t> I, J;
+        I.reserve(this->rows());
+        J.reserve(this->cols());
+        for (std::size_t i=0; i<this->rows(); i++)
+          I.push_back(i+w.offset.first);
+        for (std::size_t j=0; j<this->cols(); j++)
+          J.push_back(j+w.offset.second);
+        D_ = DenseM_t(this->rows(), this->cols());
+        Aelem(I, J, D_);
+      } else {
+        w.split(child(0)->dims());
+        bool tasked = depth < params::task_recursion_cutoff_level,
+          keep0 = false, keep1 = false;
+        if (tasked) {
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+          keep0 = child(0)->compress_recursive_warm
+            (Rr, Rc, Sr, Sc, Aelem, opts, w.c[0], depth+1);
+#pragma omp task default(shared)                                        \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+          keep1 = child(1)->compress_recursive_warm
+            (Rr, Rc, Sr, Sc, Aelem, opts, w.c[1], depth+1);
+#pragma omp taskwait
+        } else {
+          keep0 = child(0)->compress_recursive_warm
+            (Rr, Rc, Sr, Sc, Aelem, opts, w.c[0], depth+1);
+          keep1 = child(1)->compress_recursive_warm
+            (Rr, Rc, Sr, Sc, Aelem, opts, w.c[1], depth+1);
+        }
+        if (!child(0)->is_compressed() ||
+            !child(1)->is_compressed()) return false;
+        keep = keep0 && keep1;
+#pragma omp task default(shared) if(tasked)                             \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        {
+          B01_ = DenseM_t(child(0)->U_rank(), child(1)->V_rank());
+          Aelem(w.c[0].Ir, w.c[1].Ic, B01_);
+        }
+#pragma omp task default(shared) if(tasked)                             \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        {
+          B10_ = DenseM_t(child(1)->U_rank(), child(0)->V_rank());
+          Aelem(w.c[1].Ir, w.c[0].Ic, B10_);
+        }
+#pragma omp taskwait
+      }
+      if (w.lvl == 0) {
+        this->U_state_ = this->V_state_ = State::COMPRESSED;
+        return keep;
+      }
+      auto d = Rr.cols();
+      compute_local_samples(Rr, Rc, Sr, Sc, w, 0, d, depth);
+      if (keep && check_U_V_bases(Sr, Sc, opts, w, d)) {
+        w.Jr = Jr_;
+        w.Jc = Jc_;
+        set_skeleton(w);
+        reused_ = true;
+      } else {
+        keep = false;
+        // with only the oversampling samples, the bases can not be
+        // computed, more samples are drawn in compress_warm
+        if (int(d) <= opts.p() ||
+            !compute_U_V_bases(Sr, Sc, opts, w, d, depth)) {
+          this->U_state_ = this->V_state_ = State::PARTIALLY_COMPRESSED;
+          return false;
+        }
+      }
+      reduce_local_samples(Rr, Rc, w, 0, d, depth);
+      this->U_state_ = this->V_state_ = State::COMPRESSED;
+      return keep;
+    }
+
     template<typename scalar_t> void
     HSSMatrix<scalar_t>::compress_level_original
     (DenseM_t& Rr, DenseM_t& Rc, DenseM_t& Sr, DenseM_t& Sc,
@@ -663,21 +808,9 @@ namespace strumpack {
       if (d-opts.p() >= opts.max_rank() ||
           (int(U_.cols()) < d - opts.p() &&
            int(V_.cols()) < d - opts.p())) {
-        this->U_rank_ = U_.cols();  this->U_rows_ = U_.rows();
-        this->V_rank_ = V_.cols();  this->V_rows_ = V_.rows();
-        w.Ir.reserve(U_.cols());
-        w.Ic.reserve(V_.cols());
-        if (this->leaf()) {
-          for (auto i : w.Jr) w.Ir.push_back(w.offset.first + i);
-          for (auto j : w.Jc) w.Ic.push_back(w.offset.second + j);
-        } else {
-          auto r0 = w.c[0].Ir.size();
-          for (auto i : w.Jr)
-            w.Ir.push_back((i < r0) ? w.c[0].Ir[i] : w.c[1].Ir[i-r0]);
-          r0 = w.c[0].Ic.size();
-          for (auto j : w.Jc)
-            w.Ic.push_back((j < r0) ? w.c[0].Ic[j] : w.c[1].Ic[j-r0]);
-        }
+        Jr_ = w.Jr;
+        Jc_ = w.Jc;
+        set_skeleton(w);
         return true;
       } else {
         w.Jr.clear();
@@ -686,6 +819,62 @@ namespace strumpack {
       }
     }
 
+    // check whether the bases U_/V_, with skeleton Jr_/Jc_, from a
+    // previous compression still interpolate the new local samples
+    // S. This uses the stopping criterion of the pivoted QR in
+    // compute_U_V_bases: the largest row norm of S - U S(Jr,:)
+    // should be below max(rtol * (largest row norm of S), atol).
+    template<typename scalar_t> bool HSSMatrix<scalar_t>::check_U_V_bases
+    (DenseM_t& Sr, DenseM_t& Sc, const opts_t& opts,
+     WorkCompress<scalar_t>& w, int d) const {
+      auto u_rows = this->leaf() ? this->rows() :
+        child(0)->U_rank()+child(1)->U_rank();
+      auto v_rows = this->leaf() ? this->cols() :
+        child(0)->V_rank()+child(1)->V_rank();
+      if (U_.rows() != u_rows || V_.rows() != v_rows ||
+          Jr_.size() != U_.cols() || Jc_.size() != V_.cols())
+        return false;
+      auto rtol = opts.rel_tol() / w.lvl;
+      auto atol = opts.abs_tol() / w.lvl;
+      auto max_row_norm = [](const DenseM_t& X) {
+        std::vector<real_t> nrm(X.rows(), real_t(0.));
+        for (std::size_t j=0; j<X.cols(); j++)
+          for (std::size_t i=0; i<X.rows(); i++)
+            nrm[i] += std::norm(X(i, j));
+        return nrm.empty() ? real_t(0.) :
+          std::sqrt(*std::max_element(nrm.begin(), nrm.end()));
+      };
+      auto check = [&](const HSSBasisID<scalar_t>& B,
+                       const std::vector<std::size_t>& J,
+                       DenseM_t& S, std::size_t m) {
+        DenseMW_t wS(m, d, S, w.offset.second, 0);
+        auto E = B.apply(wS.extract_rows(J));
+        E.scaled_add(scalar_t(-1.), wS);
+        STRUMPACK_ID_FLOPS(B.apply_flops(d) + m * d);
+        return max_row_norm(E) <= std::max(rtol * max_row_norm(wS), atol);
+      };
+      return check(U_, Jr_, Sr, u_rows) && check(V_, Jc_, Sc, v_rows);
+    }
+
+    template<typename scalar_t> void
+    HSSMatrix<scalar_t>::set_skeleton(WorkCompress<scalar_t>& w) {
+      this->U_rank_ = U_.cols();  this->U_rows_ = U_.rows();
+      this->V_rank_ = V_.cols();  this->V_rows_ = V_.rows();
+      w.Ir.reserve(U_.cols());
+      w.Ic.reserve(V_.cols());
+      if (this->leaf()) {
+        for (auto i : w.Jr) w.Ir.push_back(w.offset.first + i);
+        for (auto j : w.Jc) w.Ic.push_back(w.offset.second + j);
+      } else {
+        auto r0 = w.c[0].Ir.size();
+        for (auto i : w.Jr)
+          w.Ir.push_back((i < r0) ? w.c[0].Ir[i] : w.c[1].Ir[i-r0]);
+        r0 = w.c[0].Ic.size();
+        for (auto j : w.Jc)
+          w.Ic.push_back((j < r0) ? w.c[0].Ic[j] : w.c[1].Ic[j-r0]);
+      }
+    }
+
     template<typename scalar_t> void HSSMatrix<scalar_t>::reduce_local_samples
     (DenseM_t& Rr, DenseM_t& Rc, WorkCompress<scalar_t>& w,
      int d0, int d, int depth) {
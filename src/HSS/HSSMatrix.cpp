@@ -91,8 +91,10 @@ namespace strumpack {
       TaskTimer timer("clustering");
       timer.start();
       auto t = binary_tree_clustering
-        (opts.clustering_algorithm(), K.data(), K.permutation(), opts.leaf_size());
+        (opts.clustering_algorithm(), K.data(), K.permutation(),
+         opts.leaf_size(), opts.balanced_clustering());
       K.permute();
+      K.cluster_tree() = t;
       if (opts.verbose())
         std::cout << "# clustering (" << get_name(opts.clustering_algorithm())
                   << ") time = " << timer.elapsed() << std::endl;
@@ -119,6 +121,8 @@ namespace strumpack {
       D_ = other.D_;
       B01_ = other.B01_;
       B10_ = other.B10_;
+      Jr_ = other.Jr_;
+      Jc_ = other.Jc_;
     }
 
     template<typename scalar_t> HSSMatrix<scalar_t>&
@@ -129,6 +133,8 @@ namespace strumpack {
       D_ = other.D_;
       B01_ = other.B01_;
       B10_ = other.B10_;
+      Jr_ = other.Jr_;
+      Jc_ = other.Jc_;
       return *this;
     }
 
@@ -145,6 +151,22 @@ namespace strumpack {
       HSSMatrixBase<scalar_t>::delete_trailing_block();
     }
 
+    template<typename scalar_t> void
+    HSSMatrix<scalar_t>::delete_trailing_block_generators() {
+      B01_.clear();
+      B10_.clear();
+      if (this->ch_.size() == 2) child(1)->delete_generators();
+    }
+
+    template<typename scalar_t> void
+    HSSMatrix<scalar_t>::delete_generators() {
+      D_.clear();
+      B01_.clear();
+      B10_.clear();
+      for (std::size_t c=0; c<this->ch_.size(); c++)
+        child(c)->delete_generators();
+    }
+
     template<typename scalar_t> void
     HSSMatrix<scalar_t>::compress(const DenseM_t& A, const opts_t& opts) {
       TIMER_TIME(TaskType::HSS_COMPRESS, 0, t_compress);
@@ -181,6 +203,9 @@ namespace strumpack {
       D_.clear();
       B01_.clear();
       B10_.clear();
+      Jr_.clear();
+      Jc_.clear();
+      reused_ = false;
       HSSMatrixBase<scalar_t>::reset();
     }
 
@@ -294,6 +319,15 @@ namespace strumpack {
       return rank;
     }
 
+    template<typename scalar_t> std::size_t
+    HSSMatrix<scalar_t>::reused_nodes() const {
+      if (!this->active()) return 0;
+      std::size_t n = reused_ ? 1 : 0;
+      if (!this->leaf())
+        n += child(0)->reused_nodes() + child(1)->reused_nodes();
+      return n;
+    }
+
     template<typename scalar_t> std::size_t
     HSSMatrix<scalar_t>::memory() const {
       if (!this->active()) return 0;
@@ -276,6 +276,48 @@ namespace strumpack {
                                              DenseM_t& B)>& Aelem,
                     const opts_t& opts);
 
+      /**
+       * Recompress this HSS matrix, which was compressed before,
+       * for a new matrix with the same HSS partitioning, for instance
+       * after a small change in the values. The row and column
+       * bases, and the skeleton indices, of the previous compression
+       * are checked against HSSOptions::p() new random samples. Only
+       * the nodes for which the old bases no longer satisfy the
+       * compression tolerance are recompressed, together with their
+       * ancestors, after drawing HSSOptions::d0() more samples, and
+       * more if needed as in compress. The generators D and B are
+       * always extracted again. If this matrix was not compressed
+       * before, or when the options select a compression algorithm
+       * other than CompressionAlgorithm::ORIGINAL, a sketch other
+       * than CompressionSketch::GAUSSIAN, or no oversampling (p ==
+       * 0), this does a regular compression.
+       *
+       * \param Amult matrix-(multiple)vector product routine, see
+       * compress
+       * \param Aelem element extraction routine, see compress
+       * \param opts object containing a number of options for HSS
+       * compression
+       * \see compress, HSSOptions
+       */
+      void compress_warm(const std::function<void(DenseM_t& Rr,
+                                                  DenseM_t& Rc,
+                                                  DenseM_t& Sr,
+                                                  DenseM_t& Sc)>& Amult,
+                         const std::function
+                         <void(const std::vector<std::size_t>& I,
+                               const std::vector<std::size_t>& J,
+                               DenseM_t& B)>& Aelem,
+                         const opts_t& opts);
+
+      /**
+       * Number of HSS nodes of which the row and column bases from
+       * the previous compression were kept by the last call to
+       * compress_warm.
+       *
+       * \see compress_warm
+       */
+      std::size_t reused_nodes() const;
+
 
       /**
        * Initialize this HSS matrix as the compressed HSS
@@ -472,6 +514,10 @@ namespace strumpack {
                                   const DenseM_t& Sc2,
                                   DenseM_t& Sr, DenseM_t& Sc) const;
       void delete_trailing_block() override;
+      // like delete_trailing_block, but only releases the generators
+      // (D, B) of the trailing block, its bases and skeleton indices
+      // are kept for compress_warm
+      void delete_trailing_block_generators();
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
       std::size_t rank() const override;
@@ -523,6 +569,11 @@ namespace strumpack {
 
       HSSBasisID<scalar_t> U_, V_;
       DenseM_t D_, B01_, B10_;
+      // skeleton rows of the local row/column samples, kept from the
+      // last compression, used in compress_warm
+      std::vector<std::size_t> Jr_, Jc_;
+      // the bases of this node were kept by the last compress_warm
+      bool reused_ = false;
 
       void compress_original(const DenseM_t& A,
                              const opts_t& opts);
@@ -560,6 +611,14 @@ namespace strumpack {
                                  SJLTMatrix<scalar_t, int>* S=nullptr);
       bool compute_U_V_bases(DenseM_t& Sr, DenseM_t& Sc, const opts_t& opts,
                              WorkCompress<scalar_t>& w, int d, int depth);
+      bool compress_recursive_warm(DenseM_t& Rr, DenseM_t& Rc,
+                                   DenseM_t& Sr, DenseM_t& Sc,
+                                   const elem_t& Aelem, const opts_t& opts,
+                                   WorkCompress<scalar_t>& w, int depth);
+      bool check_U_V_bases(DenseM_t& Sr, DenseM_t& Sc, const opts_t& opts,
+                           WorkCompress<scalar_t>& w, int d) const;
+      void set_skeleton(WorkCompress<scalar_t>& w);
+      void delete_generators();
       void compute_U_basis_stable(DenseM_t& Sr, const opts_t& opts,
                                   WorkCompress<scalar_t>& w,
                                   int d, int dd, int depth);
@@ -59,7 +59,8 @@ namespace strumpack {
         TaskTimer timer("approximate_neighbors");
         timer.start();
         find_approximate_neighbors
-          (K.data(), opts.ann_iterations(), ann_number, ann, scores);
+          (Comm(), K.data(), opts.ann_iterations(), ann_number,
+           ann, scores);
         if (opts.verbose() && Comm().is_root())
           std::cout << "# k-ANN=" << ann_number
                     << ", approximate neighbor search time = "
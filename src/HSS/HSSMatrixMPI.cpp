@@ -105,7 +105,9 @@ namespace strumpack {
       TaskTimer timer("clustering");
       timer.start();
       auto t = binary_tree_clustering
-        (opts.clustering_algorithm(), K.data(), K.permutation(), opts.leaf_size());
+        (Comm(), opts.clustering_algorithm(), K.data(), K.permutation(),
+         opts.leaf_size(), opts.balanced_clustering());
+      K.cluster_tree() = t;
       if (opts.verbose() && Comm().is_root())
         std::cout << "# clustering (" << get_name(opts.clustering_algorithm())
                   << ") time = " << timer.elapsed() << std::endl;
@@ -97,6 +97,8 @@ namespace strumpack {
          {"hss_enable_sync",           no_argument, 0, 19},
          {"hss_disable_sync",          no_argument, 0, 20},
          {"hss_log_ranks",             no_argument, 0, 21},
+         {"hss_enable_balanced_clustering",  no_argument, 0, 22},
+         {"hss_disable_balanced_clustering", no_argument, 0, 23},
          {"hss_verbose",               no_argument, 0, 'v'},
          {"hss_quiet",                 no_argument, 0, 'q'},
          {"help",                      no_argument, 0, 'h'},
@@ -228,6 +230,8 @@ namespace strumpack {
         case 19: { set_synchronized_compression(true); } break;
         case 20: { set_synchronized_compression(false); } break;
         case 21: { set_log_ranks(true); } break;
+        case 22: { set_balanced_clustering(true); } break;
+        case 23: { set_balanced_clustering(false); } break;
         case 'v': this->set_verbose(true); break;
         case 'q': this->set_verbose(false); break;
         case 'h': describe_options(); break;
@@ -269,6 +273,10 @@ namespace strumpack {
                 << get_name(SJLT_algo()) << ")" << std::endl
                 << "#   --hss_clustering_algorithm natural|2means|kdtree|pca|cobble (default "
                 << get_name(clustering_algorithm()) << ")" << std::endl
+                << "#   --hss_enable_balanced_clustering (default "
+                << balanced_clustering() << ")" << std::endl
+                << "#   --hss_disable_balanced_clustering (default "
+                << !balanced_clustering() << ")" << std::endl
                 << "#   --hss_user_defined_random (default "
                 << user_defined_random() << ")" << std::endl
                 << "#   --hss_approximate_neighbors int (default "
@@ -259,6 +259,18 @@ namespace strumpack {
         clustering_algo_ = a;
       }
 
+      /**
+       * Always split clusters in two halves when constructing the
+       * cluster tree of a kernel matrix. This gives balanced leaf
+       * sizes, and hence better load balance.
+       *
+       * \param b Use balanced clustering
+       * \see binary_tree_clustering
+       */
+      void set_balanced_clustering(bool b) {
+        balanced_clustering_ = b;
+      }
+
       /**
        * Set the number of approximate nearest neighbors used in the
        * HSS compression algorithm for kernel matrices.
@@ -396,6 +408,13 @@ namespace strumpack {
         return clustering_algo_;
       }
 
+      /**
+       * Use balanced clustering?
+       * \return True if clusters are always split in two halves
+       * \see set_balanced_clustering
+       */
+      bool balanced_clustering() const { return balanced_clustering_; }
+
       /**
        * Get the number of approximate nearest neighbors used in the
        * HSS compression algorithm for kernel matrices.
@@ -478,6 +497,7 @@ namespace strumpack {
       SJLTAlgo sjlt_algo_ = SJLTAlgo::CHUNK;
       bool sync_ = false;
       ClusteringAlgorithm clustering_algo_ = ClusteringAlgorithm::TWO_MEANS;
+      bool balanced_clustering_ = false;
       int approximate_neighbors_ = 64;
       int ann_iterations_ = 5;
 
@@ -58,8 +58,12 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::setup_tree() {
-    tree_.reset(new EliminationTree<scalar_t,integer_t>
-                (opts_, *mat_, nd_->tree()));
+    if (symb_)
+      tree_.reset(new EliminationTree<scalar_t,integer_t>
+                  (opts_, *mat_, nd_->tree(), symb_->upd()));
+    else
+      tree_.reset(new EliminationTree<scalar_t,integer_t>
+                  (opts_, *mat_, nd_->tree()));
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -70,7 +74,12 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> int
   SparseSolver<scalar_t,integer_t>::compute_reordering
   (const int* p, int base, int nx, int ny, int nz,
-   int components, int width) {
+   int components, int width, const SeparatorTree<integer_t>* sep_tree) {
+    if (symb_)
+      return nd_->set_reordering
+        (opts_, *mat_, symb_->perm(), symb_->iperm(), symb_->tree());
+    if (p && sep_tree)
+      return nd_->set_separator_tree(opts_, *mat_, p, *sep_tree, base);
     if (p) return nd_->set_permutation(opts_, *mat_, p, base);
     return nd_->nested_dissection
       (opts_, *mat_, nx, ny, nz, components, width);
@@ -81,10 +90,45 @@ namespace strumpack {
     nd_->separator_reordering(opts_, *mat_, tree_->root());
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::reorder
+  (std::shared_ptr<const SymbolicAnalysis<integer_t>> analysis) {
+    if (!analysis) return ReturnCode::REORDERING_ERROR;
+    return this->reorder_internal
+      (nullptr, 0, 1, 1, 1, 1, 1, nullptr, analysis);
+  }
+
+  template<typename scalar_t,typename integer_t>
+  std::shared_ptr<const SymbolicAnalysis<integer_t>>
+  SparseSolver<scalar_t,integer_t>::symbolic_analysis() {
+    if (!reordered_) return nullptr;
+    if (!symb_) {
+      // perm and the update indices in the fronts include the
+      // separator reordering, if any, which is also a valid nested
+      // dissection ordering
+      auto job = opts_.matching();
+      std::vector<integer_t> Q;
+      std::vector<double> R, C;
+      if (job != MatchingJob::NONE) Q = matching_.Q;
+      if (job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING) {
+        R.assign(matching_.R.begin(), matching_.R.end());
+        C.assign(matching_.C.begin(), matching_.C.end());
+      }
+      symb_ = std::make_shared<const SymbolicAnalysis<integer_t>>
+        (mat_->nnz(), this->pattern_hash_, job, std::move(Q),
+         std::move(R), std::move(C), nd_->perm(), nd_->iperm(),
+         nd_->tree(), tree_->update_indices());
+    }
+    return symb_;
+  }
+
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::set_matrix
   (const CSRMatrix<scalar_t,integer_t>& A) {
     mat_.reset(new CSRMatrix<scalar_t,integer_t>(A));
+    this->clear_value_map();
+    this->clear_low_rank_update();
+    this->changed_.clear();
     factored_ = reordered_ = false;
   }
 
@@ -96,8 +140,8 @@ namespace strumpack {
       this->print_wrong_sparsity_error();
       return;
     }
-    mat_.reset(new CSRMatrix<scalar_t,integer_t>(A));
-    permute_matrix_values();
+    update_matrix_values
+      (A.size(), A.ptr(), A.ind(), A.val(), A.symm_sparse());
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -106,6 +150,9 @@ namespace strumpack {
    const scalar_t* values, bool symmetric_pattern) {
     mat_.reset(new CSRMatrix<scalar_t,integer_t>
                (N, row_ptr, col_ind, values, symmetric_pattern));
+    this->clear_value_map();
+    this->clear_low_rank_update();
+    this->changed_.clear();
     factored_ = reordered_ = false;
   }
 
@@ -118,21 +165,46 @@ namespace strumpack {
       this->print_wrong_sparsity_error();
       return;
     }
-    mat_.reset(new CSRMatrix<scalar_t,integer_t>
-               (N, row_ptr, col_ind, values, symmetric_pattern));
-    permute_matrix_values();
-  }
-
-  template<typename scalar_t,typename integer_t> void
-  SparseSolver<scalar_t,integer_t>::permute_matrix_values() {
     if (reordered_) {
-      matrix()->apply_matching(matching_);
-      matrix()->equilibrate(equil_);
-      matrix()->symmetrize_sparsity();
-      matrix()->permute(reordering()->iperm(), reordering()->perm());
-      if (opts_.compression() != CompressionType::NONE)
-        separator_reordering();
-    }
+      // first update after reordering: record where each user
+      // nonzero ends up in the permuted/scaled/symmetrized matrix
+      if ((val_map_.empty() || row_ptr[N]-row_ptr[0] != val_map_nnz_) &&
+          !this->setup_value_map
+          (N, row_ptr, col_ind, reordering()->perm().data(),
+           reordering()->perm().data())) {
+        this->print_wrong_sparsity_error();
+        return;
+      }
+      auto& changed = this->changed_;
+      std::vector<scalar_t> old_values;
+      if (!changed.empty())
+        old_values.assign(mat_->val(), mat_->val() + mat_->nnz());
+      this->gather_matrix_values(values);
+      if (opts_.compression() != CompressionType::NONE) {
+        if (!this->hss_warm_start_) {
+          // the structured fronts need to be partitioned again. The
+          // map is only rebuilt if this changes the permutation,
+          // which it does not when no front is compressed.
+          auto perm = reordering()->perm();
+          separator_reordering();
+          if (perm != reordering()->perm())
+            this->clear_value_map();
+        }
+        changed.clear();
+      } else if (!changed.empty()) {
+        // a changed nonzero (i,j) is assembled in the front of
+        // separator index min(i,j)
+        auto ptr = mat_->ptr();
+        auto ind = mat_->ind();
+        auto val = mat_->val();
+        for (integer_t i=0; i<N; i++)
+          for (auto k=ptr[i]; k<ptr[i+1]; k++)
+            if (val[k] != old_values[k])
+              changed[std::min(i, ind[k])] = true;
+      }
+    } else
+      mat_.reset(new CSRMatrix<scalar_t,integer_t>
+                 (N, row_ptr, col_ind, values, symmetric_pattern));
     factored_ = false;
   }
 
@@ -272,7 +344,14 @@ namespace strumpack {
 
     switch (opts_.Krylov_solver()) {
     case KrylovSolver::AUTO: {
-      if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
+      if (opts_.mixed_precision_fronts() && x.cols() == 1)
+        iterative::GMResIR<scalar_t>
+          (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
+           opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+           opts_.gmres_restart(), opts_.GramSchmidt_type(),
+           use_initial_guess, opts_.verbose() && is_root_);
+      else if (opts_.compression() != CompressionType::NONE &&
+               x.cols() == 1)
         iterative::GMRes<scalar_t>
           (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
            opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
@@ -296,7 +375,9 @@ namespace strumpack {
          Krylov_its_, opts_.maxit(), use_initial_guess,
          opts_.verbose() && is_root_);
     }; break;
-    case KrylovSolver::PREC_GMRES: {
+    case KrylovSolver::PREC_GMRES:
+    case KrylovSolver::PIPELINED_GMRES: {
+      // no global reductions to hide in the sequential solver
       assert(x.cols() == 1);
       iterative::GMRes<scalar_t>
         (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
@@ -304,6 +385,31 @@ namespace strumpack {
          opts_.gmres_restart(), opts_.GramSchmidt_type(),
          use_initial_guess, opts_.verbose() && is_root_);
     }; break;
+    case KrylovSolver::PREC_FGMRES: {
+      assert(x.cols() == 1);
+      iterative::FGMRes<scalar_t>
+        (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
+         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+         opts_.gmres_restart(), opts_.GramSchmidt_type(),
+         use_initial_guess, opts_.verbose() && is_root_);
+    }; break;
+    case KrylovSolver::PREC_GCRODR: {
+      assert(x.cols() == 1);
+      iterative::GCRODR<scalar_t>
+        (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
+         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+         opts_.gmres_restart(), opts_.gcrodr_recycle(),
+         this->Krylov_recycle_, opts_.GramSchmidt_type(),
+         use_initial_guess, opts_.verbose() && is_root_);
+    }; break;
+    case KrylovSolver::PREC_GMRES_IR: {
+      assert(x.cols() == 1);
+      iterative::GMResIR<scalar_t>
+        (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
+         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+         opts_.gmres_restart(), opts_.GramSchmidt_type(),
+         use_initial_guess, opts_.verbose() && is_root_);
+    }; break;
     case KrylovSolver::PREC_BICGSTAB: {
       assert(x.cols() == 1);
       iterative::BiCGStab<scalar_t>
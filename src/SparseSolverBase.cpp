@@ -25,6 +25,8 @@
  *             (Lawrence Berkeley National Lab, Computational Research
  *             Division).
  */
+#include <algorithm>
+
 #include "SparseSolverBase.hpp"
 
 #if defined(STRUMPACK_USE_PAPI)
@@ -33,6 +35,7 @@
 
 #include "misc/Tools.hpp"
 #include "misc/TaskTimer.hpp"
+#include "misc/FrontTrace.hpp"
 #include "StrumpackOptions.hpp"
 #include "sparse/ordering/MatrixReordering.hpp"
 #include "sparse/EliminationTree.hpp"
@@ -139,6 +142,31 @@ namespace strumpack {
     return Krylov_its_;
   }
 
+  template<typename scalar_t,typename integer_t> int
+  SparseSolverBase<scalar_t,integer_t>::refactored_fronts() const {
+    if (refactored_fronts_ >= 0) return refactored_fronts_;
+    return tree()->front_counter().total();
+  }
+
+  template<typename scalar_t,typename integer_t> long long
+  SparseSolverBase<scalar_t,integer_t>::HSS_random_samples() const {
+    long long samples, reused;
+    tree()->HSS_compression_counts(samples, reused);
+    return samples;
+  }
+
+  template<typename scalar_t,typename integer_t> long long
+  SparseSolverBase<scalar_t,integer_t>::HSS_reused_nodes() const {
+    long long samples, reused;
+    tree()->HSS_compression_counts(samples, reused);
+    return reused;
+  }
+
+  template<typename scalar_t,typename integer_t> long long
+  SparseSolverBase<scalar_t,integer_t>::CB_nonzeros() const {
+    return tree()->CB_nonzeros();
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolverBase<scalar_t,integer_t>::inertia
   (integer_t& neg, integer_t& zero, integer_t& pos) {
@@ -299,6 +327,70 @@ namespace strumpack {
       << std::endl;
   }
 
+  template<typename scalar_t,typename integer_t> bool
+  SparseSolverBase<scalar_t,integer_t>::setup_value_map
+  (integer_t lrows, const integer_t* ptr, const integer_t* ind,
+   const integer_t* rperm, const integer_t* cperm) {
+    using real_t = typename RealType<scalar_t>::value_type;
+    auto A = matrix();
+    const auto Aptr = A->ptr();
+    const auto Aind = A->ind();
+    const auto Annz = Aptr[lrows] - Aptr[0];
+    const auto& M = matching_;
+    const auto& E = equil_;
+    std::vector<integer_t> Qinv;
+    if (M.job != MatchingJob::NONE) {
+      Qinv.resize(M.Q.size());
+      for (std::size_t i=0; i<M.Q.size(); i++) Qinv[M.Q[i]] = i;
+    }
+    val_map_.assign(Annz, -1);
+    val_scale_.assign(Annz, real_t(0.));
+    bool ok = true;
+#pragma omp parallel for reduction(&&:ok)
+    for (integer_t i=0; i<lrows; i++) {
+      // the rows of matrix() are not necessarily sorted
+      auto r = rperm ? rperm[i] : i;
+      std::vector<std::pair<integer_t,integer_t>> row;
+      row.reserve(Aptr[r+1] - Aptr[r]);
+      for (auto k=Aptr[r]; k<Aptr[r+1]; k++)
+        row.emplace_back(Aind[k], k);
+      std::sort(row.begin(), row.end());
+      for (auto p=ptr[i]-ptr[0]; p<ptr[i+1]-ptr[0]; p++) {
+        auto j = ind[p];
+        real_t s(1.);
+        if (M.job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
+          s *= M.R[i] * M.C[j];
+        if (!Qinv.empty()) j = Qinv[j];
+        if (E.type == EquilibrationType::ROW ||
+            E.type == EquilibrationType::BOTH) s *= E.R[i];
+        if (E.type == EquilibrationType::COLUMN ||
+            E.type == EquilibrationType::BOTH) s *= E.C[j];
+        auto c = cperm ? cperm[j] : j;
+        auto e = std::lower_bound
+          (row.begin(), row.end(), std::make_pair(c, integer_t(0)));
+        if (e == row.end() || e->first != c) { ok = false; break; }
+        val_map_[e->second] = p;
+        val_scale_[e->second] = s;
+      }
+    }
+    if (!ok) clear_value_map();
+    else val_map_nnz_ = ptr[lrows] - ptr[0];
+    return ok;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolverBase<scalar_t,integer_t>::gather_matrix_values
+  (const scalar_t* values) {
+    auto Aval = matrix()->val();
+    integer_t Annz = val_map_.size();
+#pragma omp parallel for
+    for (integer_t k=0; k<Annz; k++)
+      Aval[k] = (val_map_[k] < 0) ? scalar_t(0.) :
+        values[val_map_[k]] * val_scale_[k];
+    STRUMPACK_FLOPS((is_complex<scalar_t>()?2:1)*
+                    static_cast<long long int>(double(Annz)));
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolverBase<scalar_t,integer_t>::reorder
   (int nx, int ny, int nz, int components, int width) {
@@ -311,18 +403,41 @@ namespace strumpack {
     return reorder_internal(p, base, 1, 1, 1, 1, 1);
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::reorder
+  (const int* p, const SeparatorTree<integer_t>& tree, int base) {
+    return reorder_internal(p, base, 1, 1, 1, 1, 1, &tree);
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolverBase<scalar_t,integer_t>::reorder_internal
   (const int* p, int base, int nx, int ny, int nz,
-   int components, int width) {
+   int components, int width, const SeparatorTree<integer_t>* sep_tree,
+   std::shared_ptr<const SymbolicAnalysis<integer_t>> symb) {
     if (!matrix()) return ReturnCode::MATRIX_NOT_SET;
     if (reordered_) return ReturnCode::SUCCESS;
+    symb_ = symb;
+    // the solve and the value updates check the matching option
+    if (symb_) opts_.set_matching(symb_->matching_job());
     TaskTimer t1("permute-scale");
     int ierr;
     if (opts_.verbose() && is_root_)
       std::cout << "# matching job: " << get_description(opts_.matching())
                 << std::endl;
-    if (opts_.matching() != MatchingJob::NONE) {
+    if (symb_) {
+      if (symb_->size() != matrix()->size()) {
+        if (is_root_)
+          std::cerr << "ERROR: matrix size does not match the"
+                    << " symbolic analysis" << std::endl;
+        return ReturnCode::REORDERING_ERROR;
+      }
+      if (opts_.matching() != MatchingJob::NONE) {
+        t1.time([&](){
+          matching_ = symb_->template matching<scalar_t>();
+          matrix()->apply_matching(matching_);
+        });
+      }
+    } else if (opts_.matching() != MatchingJob::NONE) {
       try {
         t1.time([&](){ matching_ = matrix()->matching(opts_.matching()); });
       } catch (std::exception& e) {
@@ -345,6 +460,14 @@ namespace strumpack {
     auto old_nnz = matrix()->nnz();
     TaskTimer t2("sparsity-symmetrization",
                  [&](){ matrix()->symmetrize_sparsity(); });
+    pattern_hash_ = matrix()->pattern_hash();
+    if (symb_ && (matrix()->nnz() != symb_->nnz() ||
+                  pattern_hash_ != symb_->pattern_hash())) {
+      if (is_root_)
+        std::cerr << "ERROR: sparsity pattern does not match the"
+                  << " symbolic analysis" << std::endl;
+      return ReturnCode::REORDERING_ERROR;
+    }
     if (matrix()->nnz() != old_nnz && opts_.verbose() && is_root_) {
       std::cout << "# Matrix padded with zeros to get symmetric pattern."
                 << std::endl;
@@ -358,13 +481,14 @@ namespace strumpack {
     perf_counters_start();
     t3.start();
     setup_reordering();
-    ierr = compute_reordering(p, base, nx, ny, nz, components, width);
+    ierr = compute_reordering
+      (p, base, nx, ny, nz, components, width, sep_tree);
     if (ierr) {
       std::cerr << "ERROR: nested dissection went wrong, ierr="
                 << ierr << std::endl;
       return ReturnCode::REORDERING_ERROR;
     }
-    matrix()->permute(reordering()->iperm(), reordering()->perm());
+    matrix()->permute_in_place(reordering()->iperm(), reordering()->perm());
     t3.stop();
     if (opts_.verbose() && is_root_) {
       std::cout << "#   - nd time = " << t3.elapsed() << std::endl;
@@ -386,6 +510,9 @@ namespace strumpack {
         std::cout << "# symbolic factorization:" << std::endl;
         std::cout << "#   - nr of dense Frontal matrices = "
                   << number_format_with_commas(fc.dense) << std::endl;
+        if (opts_.mixed_precision_fronts())
+          std::cout << "#   - nr of mixed precision Frontal matrices = "
+                    << number_format_with_commas(fc.mixed) << std::endl;
         switch (opts_.compression()) {
         case CompressionType::HSS:
           std::cout << "#   - nr of HSS Frontal matrices = "
@@ -418,6 +545,18 @@ namespace strumpack {
           std::cout << "#   - nr of lossy/lossless Frontal matrices = "
                     << number_format_with_commas(fc.lossy) << std::endl;
           break;
+        case CompressionType::AUTO:
+          std::cout << "#   - nr of HSS Frontal matrices = "
+                    << number_format_with_commas(fc.HSS) << std::endl;
+          std::cout << "#   - nr of BLR Frontal matrices = "
+                    << number_format_with_commas(fc.BLR) << std::endl;
+          std::cout << "#   - nr of HODLR Frontal matrices = "
+                    << number_format_with_commas(fc.HODLR) << std::endl;
+          std::cout << "#   - predicted factor flops = "
+                    << fc.flops << std::endl;
+          std::cout << "#   - predicted factor nonzeros = "
+                    << number_format_with_commas(static_cast<long long>(fc.memory)) << std::endl;
+          break;
         case CompressionType::NONE:
         default: break;
         }
@@ -457,6 +596,9 @@ namespace strumpack {
     }
 
     reordered_ = true;
+    changed_.clear();
+    // the recycle space is in the old (permuted) ordering
+    Krylov_recycle_.clear();
     return ReturnCode::SUCCESS;
   }
 
@@ -568,27 +710,58 @@ namespace strumpack {
         std::cout << "#   - replacing of small pivots is "
                   << (opts_.replace_tiny_pivots() ? "" : "not")
                   << " enabled" << std::endl;
+        if (opts_.incremental_factorization() && !changed_.empty())
+          std::cout << "#   - incremental refactorization, "
+                    << std::count(changed_.begin(), changed_.end(), true)
+                    << " changed rows/columns" << std::endl;
       }
     }
     perf_counters_start();
     flop_breakdown_reset();
+    if (!opts_.front_trace().empty()) FrontTrace::start();
     ReturnCode err_code;
     TaskTimer t1("Sparse-factorization", [&]() {
       // TODO add shift if opts_.replace...
       // auto shifted_mat = matrix_nonzero_diag();
       // err_code = tree()->multifrontal_factorization(*shifted_mat, opts_);
-      err_code = tree()->multifrontal_factorization(*matrix(), opts_);
+      // A^{-1} U has to be recomputed
+      lr_W_.clear();
+      if (opts_.incremental_factorization() && !changed_.empty())
+        err_code = tree()->multifrontal_refactorization
+          (*matrix(), opts_, changed_, refactored_fronts_);
+      else {
+        err_code = tree()->multifrontal_factorization(*matrix(), opts_);
+        refactored_fronts_ = -1;
+      }
     });
+    // the contribution blocks are kept, the next factorization can
+    // be incremental, see update_matrix_values
+    if (opts_.incremental_factorization() &&
+        opts_.compression() == CompressionType::NONE &&
+        err_code == ReturnCode::SUCCESS)
+      changed_.assign(matrix()->size(), false);
+    else changed_.clear();
+    hss_warm_start_ = opts_.HSS_warm_start() &&
+      opts_.compression() == CompressionType::HSS &&
+      err_code == ReturnCode::SUCCESS;
     perf_counters_stop("numerical factorization");
+    if (FrontTrace::enabled()) {
+      FrontTrace::stop();
+      FrontTrace::write(opts_.front_trace());
+    }
     if (opts_.verbose()) {
       auto fnnz = factor_nonzeros();
       auto max_rank = maximum_rank();
+      auto fc = tree()->front_counter();
 #if defined(STRUMPACK_COUNT_FLOPS)
       auto peak_max = max_peak_memory();
       auto peak_min = min_peak_memory();
 #endif
       if (is_root_) {
         std::cout << "#   - factor time = " << t1.elapsed() << std::endl;
+        if (refactored_fronts_ >= 0)
+          std::cout << "#   - refactored fronts = " << refactored_fronts_
+                    << " of " << fc.total() << std::endl;
         std::cout << "#   - factor nonzeros = "
                   << number_format_with_commas(fnnz) << std::endl;
         std::cout << "#   - factor memory = "
@@ -626,6 +799,15 @@ namespace strumpack {
                       << get_name(opts_.HSS_options().random_engine())
                       << " engine" << std::endl;
           }
+          if (opts_.compression() == CompressionType::AUTO) {
+            std::cout << "#   - maximum rank = " << max_rank << std::endl;
+            std::cout << "#   - predicted/actual factor nonzeros = "
+                      << fc.memory / fnnz << std::endl;
+#if defined(STRUMPACK_COUNT_FLOPS)
+            std::cout << "#   - predicted/actual factor flops = "
+                      << fc.flops / double(ftot_) << std::endl;
+#endif
+          }
           if (opts_.compression() == CompressionType::BLR) {
             std::cout << "#   - BLR relative compression tolerance = "
                       << opts_.BLR_options().rel_tol() << std::endl;
@@ -684,20 +866,170 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolverBase<scalar_t,integer_t>::solve
   (const scalar_t* b, scalar_t* x, bool use_initial_guess) {
-    return solve_internal(b, x, use_initial_guess);
+    if (!lr_U_.cols())
+      return solve_internal(b, x, use_initial_guess);
+    auto n = lr_U_.rows();
+    auto B = ConstDenseMatrixWrapperPtr(n, 1, b, n);
+    DenseMW_t X(n, 1, x, n);
+    return solve(*B, X, use_initial_guess);
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolverBase<scalar_t,integer_t>::solve
   (const DenseM_t& b, DenseM_t& x, bool use_initial_guess) {
-    return solve_internal(b, x, use_initial_guess);
+    if (!lr_U_.cols())
+      return solve_internal(b, x, use_initial_guess);
+    auto ierr = setup_low_rank_update();
+    if (ierr != ReturnCode::SUCCESS) return ierr;
+    // x = y - W C^{-1} V^H y, with y = A^{-1} b, W = A^{-1} U
+    ierr = solve_internal(b, x, false);
+    DenseM_t z(lr_V_.cols(), x.cols());
+    gemm(Trans::C, Trans::N, scalar_t(1.), lr_V_, x, scalar_t(0.), z);
+    all_reduce_sum(z);
+    lr_C_.solve_LU_in_place(z, lr_piv_);
+    gemm(Trans::N, Trans::N, scalar_t(-1.), lr_W_, z, scalar_t(1.), x);
+    return ierr;
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolverBase<scalar_t,integer_t>::solve
   (int nrhs, const scalar_t* b, int ldb, scalar_t* x, int ldx,
    bool use_initial_guess) {
-    return solve_internal(nrhs, b, ldb, x, ldx, use_initial_guess);
+    if (!lr_U_.cols())
+      return solve_internal(nrhs, b, ldb, x, ldx, use_initial_guess);
+    auto B = ConstDenseMatrixWrapperPtr(lr_U_.rows(), nrhs, b, ldb);
+    DenseMW_t X(lr_U_.rows(), nrhs, x, ldx);
+    return solve(*B, X, use_initial_guess);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::add_low_rank_update
+  (const DenseM_t& U, const DenseM_t& V) {
+    assert(U.rows() == V.rows() && U.cols() == V.cols());
+    if (lr_U_.cols() && U.rows() != lr_U_.rows())
+      return ReturnCode::MATRIX_NOT_SET;
+    if (!U.cols()) return ReturnCode::SUCCESS;
+    if (lr_U_.cols()) {
+      lr_U_.hconcat(U);
+      lr_V_.hconcat(V);
+    } else {
+      lr_U_ = U;
+      lr_V_ = V;
+    }
+    return setup_low_rank_update();
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::add_low_rank_update
+  (int k, const scalar_t* U, int ldU, const scalar_t* V, int ldV) {
+    auto n = local_rows();
+    auto Uw = ConstDenseMatrixWrapperPtr(n, k, U, ldU);
+    auto Vw = ConstDenseMatrixWrapperPtr(n, k, V, ldV);
+    return add_low_rank_update(*Uw, *Vw);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolverBase<scalar_t,integer_t>::clear_low_rank_update() {
+    lr_U_.clear();
+    lr_V_.clear();
+    lr_W_.clear();
+    lr_C_.clear();
+    lr_piv_.clear();
+  }
+
+  /*
+   * Make sure W = A^{-1} U and the LU factors of C = I + V^H W are
+   * up to date. W is only computed for the columns of U that were
+   * added since the last call, or for all columns after a
+   * (re)factorization.
+   */
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::setup_low_rank_update() {
+    if (!factored_) {
+      auto ierr = factor();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    const std::size_t n = lr_U_.rows(), k = lr_U_.cols();
+    if (lr_W_.cols() == k && lr_C_.rows() == k) return ReturnCode::SUCCESS;
+    if (lr_W_.cols() < k) {
+      auto k0 = lr_W_.cols();
+      DenseMW_t Unew(n, k-k0, lr_U_, 0, k0);
+      DenseM_t Wnew(n, k-k0);
+      auto ierr = solve_internal(Unew, Wnew, false);
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+      if (k0) lr_W_.hconcat(Wnew);
+      else lr_W_ = std::move(Wnew);
+    }
+    if (int(k) > opts_.low_rank_update_max_rank())
+      recompress_low_rank_update();
+    const auto r = lr_U_.cols();
+    lr_C_ = DenseM_t(r, r);
+    gemm(Trans::C, Trans::N, scalar_t(1.), lr_V_, lr_W_,
+         scalar_t(0.), lr_C_);
+    all_reduce_sum(lr_C_);
+    for (std::size_t i=0; i<r; i++) lr_C_(i, i) += scalar_t(1.);
+    if (lr_C_.LU(lr_piv_)) {
+      clear_low_rank_update();
+      return ReturnCode::ZERO_PIVOT;
+    }
+    if (opts_.verbose() && is_root_)
+      std::cout << "# low-rank update of rank " << r << std::endl;
+    return ReturnCode::SUCCESS;
+  }
+
+  /*
+   * Recompress U V^H (and W = A^{-1} U) using shifted Cholesky-QR:
+   * U = Qu Lu^H and V = Qv Lv^H, with Lu Lu^H = U^H U + shift
+   * I. Then Lu^H Lv = X Y is compressed with RRQR, and U <- U Lu^{-H}
+   * X, W <- W Lu^{-H} X, V <- V Lv^{-H} Y^H. This only needs the
+   * (reduced) Gram matrices, so it also works with the block-row
+   * distributed U and V.
+   */
+  template<typename scalar_t,typename integer_t> void
+  SparseSolverBase<scalar_t,integer_t>::recompress_low_rank_update() {
+    using real_t = typename RealType<scalar_t>::value_type;
+    const auto k = lr_U_.cols();
+    auto chol = [&](const DenseM_t& A, DenseM_t& L) {
+      L = DenseM_t(k, k);
+      gemm(Trans::C, Trans::N, scalar_t(1.), A, A, scalar_t(0.), L);
+      all_reduce_sum(L);
+      real_t dmax(0.);
+      for (std::size_t i=0; i<k; i++)
+        dmax = std::max(dmax, std::real(L(i, i)));
+      if (dmax == real_t(0.)) return false;
+      auto shift = 11. * (k*(k+1.)) *
+        std::numeric_limits<real_t>::epsilon() * dmax;
+      for (std::size_t i=0; i<k; i++) L(i, i) += shift;
+      if (L.Cholesky()) return false;
+      for (std::size_t j=1; j<k; j++)
+        for (std::size_t i=0; i<j; i++)
+          L(i, j) = scalar_t(0.);
+      return true;
+    };
+    DenseM_t Lu, Lv;
+    if (!chol(lr_U_, Lu) || !chol(lr_V_, Lv)) {
+      clear_low_rank_update();
+      return;
+    }
+    DenseM_t M(k, k), X, Y;
+    gemm(Trans::C, Trans::N, scalar_t(1.), Lu, Lv, scalar_t(0.), M);
+    M.low_rank(X, Y, opts_.low_rank_update_rel_tol(),
+               opts_.low_rank_update_abs_tol(), k, 0);
+    // T = Lu^{-H} X, S = Lv^{-H} Y^H
+    trsm(Side::L, UpLo::L, Trans::C, Diag::N, scalar_t(1.), Lu, X);
+    auto S = Y.transpose();
+    for (std::size_t j=0; j<S.cols(); j++)
+      for (std::size_t i=0; i<S.rows(); i++)
+        S(i, j) = blas::my_conj(S(i, j));
+    trsm(Side::L, UpLo::L, Trans::C, Diag::N, scalar_t(1.), Lv, S);
+    const auto n = lr_U_.rows(), r = X.cols();
+    DenseM_t U(n, r), V(n, r), W(n, r);
+    gemm(Trans::N, Trans::N, scalar_t(1.), lr_U_, X, scalar_t(0.), U);
+    gemm(Trans::N, Trans::N, scalar_t(1.), lr_W_, X, scalar_t(0.), W);
+    gemm(Trans::N, Trans::N, scalar_t(1.), lr_V_, S, scalar_t(0.), V);
+    lr_U_ = std::move(U);
+    lr_V_ = std::move(V);
+    lr_W_ = std::move(W);
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
@@ -718,6 +1050,7 @@ namespace strumpack {
   SparseSolverBase<scalar_t,integer_t>::delete_factors() {
     delete_factors_internal();
     factored_ = false;
+    changed_.clear();
   }
 
   // explicit template instantiations
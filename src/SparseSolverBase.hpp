@@ -37,10 +37,13 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <cstdint>
 
 #include "StrumpackConfig.hpp"
 #include "StrumpackOptions.hpp"
 #include "sparse/CSRMatrix.hpp"
+#include "sparse/SeparatorTree.hpp"
+#include "sparse/SymbolicAnalysis.hpp"
 #include "dense/DenseMatrix.hpp"
 
 /**
@@ -167,6 +170,38 @@ namespace strumpack {
      */
     ReturnCode reorder(const int* p, int base=0);
 
+    /**
+     * Perform sparse matrix reordering, with a user-supplied
+     * permutation vector and the corresponding separator tree, for
+     * instance the subdomain/interface hierarchy from a mesh
+     * partitioner. The nested dissection and the construction of the
+     * separator tree from the (gathered) graph are skipped
+     * completely. The same permutation and tree can be reused for
+     * multiple matrices with the same sparsity pattern (call
+     * set_matrix and then this routine again).
+     *
+     * The tree should be a binary tree (each separator has 0 or 2
+     * children), stored in postorder, with the root as the last
+     * separator. The unknowns of separator s are the unknowns
+     * tree.sizes[s], .., tree.sizes[s+1]-1 in the permuted ordering,
+     * and there should be no edges between unknowns in separators
+     * which are not in an ancestor-descendant relation. This is
+     * checked (after the optional MC64 column permutation and the
+     * symmetrization of the sparsity pattern), and if it does not
+     * hold, REORDERING_ERROR is returned. For the distributed memory
+     * solver, every process should pass the same permutation and
+     * tree.
+     *
+     * \param p permutation vector, should be of size N, the size of
+     * the sparse matrix associated with this solver, same as in
+     * reorder(const int*, int)
+     * \param tree separator tree matching the permutation, see
+     * SeparatorTree and Separator
+     * \param base is the permutation 0 or 1 based?
+     */
+    ReturnCode reorder(const int* p, const SeparatorTree<integer_t>& tree,
+                       int base=0);
+
     /**
      * Perform numerical factorization of the sparse input matrix.
      *
@@ -278,6 +313,70 @@ namespace strumpack {
                      scalar_t* x, int ldx,
                      bool use_initial_guess=false);
 
+    /**
+     * Register a low-rank modification of the matrix, so that the
+     * following calls to solve() solve with A + U V^H instead of A,
+     * where A is the matrix that was factored. This does not change
+     * the factorization of A, instead the solve uses the
+     * Sherman-Morrison-Woodbury formula
+     *
+     *   (A + U V^H)^{-1} b = y - A^{-1}U (I + V^H A^{-1}U)^{-1} V^H y,
+     *
+     * with y = A^{-1} b. The matrix A^{-1}U is computed here, with a
+     * single solve with multiple right-hand sides, and cached, as
+     * is the LU factorization of the small capacitance matrix I +
+     * V^H A^{-1}U. This will call factor() if the matrix was not
+     * yet factored.
+     *
+     * Multiple updates accumulate: after two calls the solver
+     * solves with A + U1 V1^H + U2 V2^H. When the accumulated rank
+     * exceeds SPOptions::low_rank_update_max_rank(), the update is
+     * recompressed, with the relative/absolute tolerances from
+     * SPOptions::low_rank_update_rel_tol() and
+     * SPOptions::low_rank_update_abs_tol(). The sparse matrix is not
+     * refactored because of an update. The initial guess passed to
+     * solve is ignored while an update is registered. When the
+     * matrix is refactored, for instance after
+     * update_matrix_values, A^{-1}U is recomputed on the next solve.
+     * Setting a new matrix, with set_matrix or one of the other
+     * matrix setters, removes the update.
+     *
+     * \param U matrix with N rows, and k columns, with N the
+     * dimension of the input matrix for SparseSolver. For
+     * SparseSolverMPIDist, U should have the (local) rows
+     * corresponding to the block-row distribution of the matrix.
+     * \param V matrix of the same size as U
+     * \return error code
+     * \see clear_low_rank_update, low_rank_update_rank
+     */
+    ReturnCode add_low_rank_update(const DenseM_t& U, const DenseM_t& V);
+
+    /**
+     * Register a low-rank modification A + U V^H, see
+     * add_low_rank_update(const DenseM_t&, const DenseM_t&).
+     *
+     * \param k number of columns of U and V
+     * \param U pointer to U, stored column major
+     * \param ldU leading dimension of U
+     * \param V pointer to V, stored column major
+     * \param ldV leading dimension of V
+     * \return error code
+     */
+    ReturnCode add_low_rank_update(int k, const scalar_t* U, int ldU,
+                                   const scalar_t* V, int ldV);
+
+    /**
+     * Remove all low-rank modifications, the following calls to
+     * solve() solve with the factored matrix again.
+     */
+    void clear_low_rank_update();
+
+    /**
+     * Rank of the accumulated low-rank modification, after
+     * recompression.
+     */
+    int low_rank_update_rank() const { return lr_U_.cols(); }
+
     /**
      * Return the object holding the options for this sparse solver.
      */
@@ -341,6 +440,45 @@ namespace strumpack {
      */
     int Krylov_iterations() const;
 
+    /**
+     * Return the number of fronts which were factored in the last
+     * call to factor. This is smaller than the total number of fronts
+     * when the factorization was incremental, see
+     * SPOptions::enable_incremental_factorization. For the
+     * SparseSolverMPIDist distributed memory solver, this routine is
+     * collective on the MPI communicator.
+     */
+    int refactored_fronts() const;
+
+    /**
+     * Return the number of random samples drawn for the compression
+     * of the HSS fronts in the last call to factor, summed over all
+     * HSS fronts. With SPOptions::enable_HSS_warm_start, this is
+     * smaller than for a compression from scratch when the HSS bases
+     * could be reused. For SparseSolverMPIDist, this only counts the
+     * fronts on this process.
+     */
+    long long HSS_random_samples() const;
+
+    /**
+     * Return the number of HSS nodes, summed over all HSS fronts, of
+     * which the bases were reused in the last call to factor, see
+     * SPOptions::enable_HSS_warm_start. For SparseSolverMPIDist, this
+     * only counts the fronts on this process.
+     */
+    long long HSS_reused_nodes() const;
+
+    /**
+     * Return the number of entries stored for the contribution
+     * blocks in the last call to factor, summed over all fronts. The
+     * contribution blocks are released during the factorization, this
+     * is not the peak memory. With BLR::BLROptions::enable_CB_compression
+     * this counts the low-rank tiles of the compressed contribution
+     * blocks of the BLR fronts. For SparseSolverMPIDist, this only
+     * counts the fronts on this process.
+     */
+    long long CB_nonzeros() const;
+
 
     /**
      * Return the inertia of the matrix. A sparse matrix needs to be
@@ -393,7 +531,8 @@ namespace strumpack {
     virtual
     int compute_reordering(const int* p, int base,
                            int nx, int ny, int nz,
-                           int components, int width) = 0;
+                           int components, int width,
+                           const SeparatorTree<integer_t>* sep_tree) = 0;
     virtual void separator_reordering() = 0;
 
     virtual SpMat_t* matrix() = 0;
@@ -419,12 +558,36 @@ namespace strumpack {
     void print_solve_stats(TaskTimer& t) const;
 
     virtual void reduce_flop_counters() const {}
+    // sum a (contiguous) matrix over all processes
+    virtual void all_reduce_sum(DenseM_t& M) const {}
+    // number of rows of the matrix stored on this process
+    virtual std::size_t local_rows() const { return matrix()->size(); }
     void print_flop_breakdown_HSS() const;
     void print_flop_breakdown_HODLR() const;
     void flop_breakdown_reset() const;
 
     void print_wrong_sparsity_error();
 
+    /*
+     * Map from the nonzeros of the internal matrix (after matching,
+     * equilibration, symmetrization and permutation) to the nonzeros
+     * of the user matrix, built for the (local) user sparsity pattern
+     * ptr/ind on the first value update after reordering. Rows of the
+     * user matrix are mapped to rows rperm[i] of matrix(), column j
+     * to cperm[Q^{-1}[j]], where Q is the matching column
+     * permutation. rperm/cperm can be null (identity). Returns false
+     * when a user nonzero is not found in the internal sparsity
+     * pattern.
+     */
+    bool setup_value_map(integer_t lrows, const integer_t* ptr,
+                         const integer_t* ind, const integer_t* rperm,
+                         const integer_t* cperm);
+    // overwrite values of matrix() with the scaled user values
+    void gather_matrix_values(const scalar_t* values);
+    void clear_value_map() {
+      val_map_.clear(); val_scale_.clear(); val_map_nnz_ = 0;
+    }
+
     SPOptions<scalar_t> opts_;
     bool is_root_;
 
@@ -436,6 +599,31 @@ namespace strumpack {
     bool factored_ = false;
     bool reordered_ = false;
     int Krylov_its_ = 0;
+    // recycle space for KrylovSolver::PREC_GCRODR, kept between solves
+    DenseM_t Krylov_recycle_;
+    // for each nonzero of matrix(), the index of the user nonzero or
+    // -1 (padding), and the matching/equilibration scaling
+    std::vector<integer_t> val_map_;
+    std::vector<typename RealType<scalar_t>::value_type> val_scale_;
+    integer_t val_map_nnz_ = 0; // (local) user nnz the map was built for
+    // after a factorization with incremental_factorization, marks
+    // the rows/columns of matrix() changed by update_matrix_values,
+    // index min(i,j) for a changed nonzero (i,j). Empty when the
+    // next factorization cannot be incremental.
+    std::vector<bool> changed_;
+    // fronts factored in the last factorization, -1 for all fronts
+    int refactored_fronts_ = -1;
+    // after a factorization with HSS_warm_start, the HSS fronts kept
+    // their bases, the next factorization can start from those if
+    // the separators are not partitioned again
+    bool hss_warm_start_ = false;
+    // low-rank update U V^H, with W = A^{-1} U (can have fewer
+    // columns than U when it still needs to be computed) and the LU
+    // factors of the capacitance matrix I + V^H W
+    DenseM_t lr_U_, lr_V_, lr_W_, lr_C_;
+    std::vector<int> lr_piv_;
+    ReturnCode setup_low_rank_update();
+    void recompress_low_rank_update();
 
 #if defined(STRUMPACK_USE_PAPI)
     float rtime_ = 0., ptime_ = 0.;
@@ -450,10 +638,26 @@ namespace strumpack {
     long long int dptot_ = 0, dpmin_ = 0, dpmax_ = 0;
 #endif
 
+    // the symbolic analysis passed to reorder_internal, or, after
+    // it has been exported, the analysis from the last reorder
+    std::shared_ptr<const SymbolicAnalysis<integer_t>> symb_;
+    // hash of the symmetrized sparsity pattern from the last
+    // reorder, before the fill reducing permutation
+    std::uint64_t pattern_hash_ = 0;
+
+    /*
+     * With symb, the matching, nested dissection and symbolic
+     * factorization are taken from symb, and p, nx, .., sep_tree are
+     * ignored.
+     */
+    ReturnCode
+    reorder_internal(const int* p, int base, int nx, int ny, int nz,
+                     int components, int width,
+                     const SeparatorTree<integer_t>* sep_tree=nullptr,
+                     std::shared_ptr<const SymbolicAnalysis<integer_t>>
+                     symb=nullptr);
+
   private:
-    ReturnCode reorder_internal(const int* p, int base,
-                                int nx, int ny, int nz,
-                                int components, int width);
 
     virtual
     ReturnCode solve_internal(const scalar_t* b, scalar_t* x,
@@ -87,6 +87,8 @@ namespace strumpack {
   (const CSRMatrix<scalar_t,integer_t>& A) {
     mat_mpi_.reset
       (new CSRMatrixMPI<scalar_t,integer_t>(&A, comm_, true));
+    this->clear_value_map();
+    this->clear_low_rank_update();
     this->factored_ = this->reordered_ = false;
   }
 
@@ -98,6 +100,8 @@ namespace strumpack {
       (N, row_ptr, col_ind, values, symmetric_pattern);
     mat_mpi_.reset
       (new CSRMatrixMPI<scalar_t,integer_t>(&mat_seq, comm_, true));
+    this->clear_value_map();
+    this->clear_low_rank_update();
     this->factored_ = this->reordered_ = false;
   }
 
@@ -105,6 +109,8 @@ namespace strumpack {
   SparseSolverMPIDist<scalar_t,integer_t>::set_matrix
   (const CSRMatrixMPI<scalar_t,integer_t>& A) {
     mat_mpi_.reset(new CSRMatrixMPI<scalar_t,integer_t>(A));
+    this->clear_value_map();
+    this->clear_low_rank_update();
     this->factored_ = this->reordered_ = false;
   }
 
@@ -116,6 +122,8 @@ namespace strumpack {
       (new CSRMatrixMPI<scalar_t,integer_t>
        (local_rows, row_ptr, col_ind, values, dist,
         comm_, symmetric_pattern));
+    this->clear_value_map();
+    this->clear_low_rank_update();
     this->factored_ = this->reordered_ = false;
   }
 
@@ -128,6 +136,8 @@ namespace strumpack {
       (new CSRMatrixMPI<scalar_t,integer_t>
        (local_rows, d_ptr, d_ind, d_val, o_ptr, o_ind, o_val,
         garray, comm_));
+    this->clear_value_map();
+    this->clear_low_rank_update();
     this->factored_ = this->reordered_ = false;
   }
 
@@ -140,8 +150,13 @@ namespace strumpack {
       this->print_wrong_sparsity_error();
       return;
     }
-    mat_mpi_.reset(new CSRMatrixMPI<scalar_t,integer_t>(A));
-    redistribute_values();
+    if (this->reordered_)
+      redistribute_values
+        (A.local_rows(), A.ptr(), A.ind(), A.val(), ValueLayout::MPI);
+    else {
+      mat_mpi_.reset(new CSRMatrixMPI<scalar_t,integer_t>(A));
+      this->factored_ = false;
+    }
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -154,11 +169,16 @@ namespace strumpack {
       this->print_wrong_sparsity_error();
       return;
     }
-    mat_mpi_.reset
-      (new CSRMatrixMPI<scalar_t,integer_t>
-       (local_rows, row_ptr, col_ind, values, dist,
-        comm_, symmetric_pattern));
-    redistribute_values();
+    if (this->reordered_)
+      redistribute_values
+        (local_rows, row_ptr, col_ind, values, ValueLayout::CSR);
+    else {
+      mat_mpi_.reset
+        (new CSRMatrixMPI<scalar_t,integer_t>
+         (local_rows, row_ptr, col_ind, values, dist,
+          comm_, symmetric_pattern));
+      this->factored_ = false;
+    }
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -171,23 +191,45 @@ namespace strumpack {
       this->print_wrong_sparsity_error();
       return;
     }
-    mat_mpi_.reset
-      (new CSRMatrixMPI<scalar_t,integer_t>
-       (local_rows, d_ptr, d_ind, d_val, o_ptr, o_ind, o_val,
-        garray, comm_));
-    redistribute_values();
+    if (this->reordered_) {
+      CSRMatrixMPI<scalar_t,integer_t> A
+        (local_rows, d_ptr, d_ind, d_val, o_ptr, o_ind, o_val,
+         garray, comm_);
+      redistribute_values
+        (local_rows, A.ptr(), A.ind(), A.val(), ValueLayout::MPIAIJ);
+    } else {
+      mat_mpi_.reset
+        (new CSRMatrixMPI<scalar_t,integer_t>
+         (local_rows, d_ptr, d_ind, d_val, o_ptr, o_ind, o_val,
+          garray, comm_));
+      this->factored_ = false;
+    }
   }
 
   template<typename scalar_t,typename integer_t> void
-  SparseSolverMPIDist<scalar_t,integer_t>::redistribute_values() {
-    if (this->reordered_) {
-      matrix()->apply_matching(this->matching_);
-      matrix()->equilibrate(this->equil_);
-      matrix()->symmetrize_sparsity();
-      tree_mpi_dist_->update_values(opts_, *mat_mpi_, *nd_mpi_);
-      if (opts_.compression() != CompressionType::NONE)
-        separator_reordering();
+  SparseSolverMPIDist<scalar_t,integer_t>::redistribute_values
+  (integer_t local_rows, const integer_t* row_ptr,
+   const integer_t* col_ind, const scalar_t* values, ValueLayout layout) {
+    // The value map is built for the (local) layout of the user
+    // matrix, which depends on how the values were passed in.
+    int err = 0;
+    if (this->val_map_.empty() || layout != val_map_layout_ ||
+        row_ptr[local_rows] - row_ptr[0] != this->val_map_nnz_) {
+      err = !this->setup_value_map
+        (local_rows, row_ptr, col_ind, nullptr, nullptr);
+      val_map_layout_ = layout;
+    }
+    if (comm_.all_reduce(err, MPI_SUM)) {
+      this->clear_value_map();
+      this->print_wrong_sparsity_error();
+      return;
     }
+    this->gather_matrix_values(values);
+    tree_mpi_dist_->update_values(opts_, *mat_mpi_, *nd_mpi_);
+    // structured fronts need to be partitioned again, this only
+    // permutes the redistributed matrix, not mat_mpi_
+    if (opts_.compression() != CompressionType::NONE)
+      separator_reordering();
     this->factored_ = false;
   }
 
@@ -201,7 +243,10 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> int
   SparseSolverMPIDist<scalar_t,integer_t>::compute_reordering
   (const int* p, int base, int nx, int ny, int nz,
-   int components, int width) {
+   int components, int width, const SeparatorTree<integer_t>* sep_tree) {
+    if (p && sep_tree)
+      return nd_mpi_->set_separator_tree
+        (opts_, *mat_mpi_, p, *sep_tree, base);
     if (p) return nd_mpi_->set_permutation(opts_, *mat_mpi_, p, base);
     return nd_mpi_->nested_dissection
       (opts_, *mat_mpi_, nx, ny, nz, components, width);
@@ -310,6 +355,46 @@ namespace strumpack {
            opts_.gmres_restart(), opts_.GramSchmidt_type(),
            use_initial_guess, opts_.verbose() && is_root_);
       };
+    auto gmres_ir =
+      [&](const std::function<void(scalar_t*)>& prec) {
+        assert(x.cols() == 1);
+        iterative::GMResIRMPI<scalar_t>
+          (comm_, spmv, prec, nloc, x.data(), bloc.data(),
+           opts_.rel_tol(), opts_.abs_tol(),
+           this->Krylov_its_, opts_.maxit(),
+           opts_.gmres_restart(), opts_.GramSchmidt_type(),
+           use_initial_guess, opts_.verbose() && is_root_);
+      };
+    auto pipelined_gmres =
+      [&](const std::function<void(scalar_t*)>& prec) {
+        assert(x.cols() == 1);
+        iterative::PipelinedGMResMPI<scalar_t>
+          (comm_, spmv, prec, nloc, x.data(), bloc.data(),
+           opts_.rel_tol(), opts_.abs_tol(),
+           this->Krylov_its_, opts_.maxit(), opts_.gmres_restart(),
+           use_initial_guess, opts_.verbose() && is_root_);
+      };
+    auto fgmres =
+      [&](const std::function<void(scalar_t*)>& prec) {
+        assert(x.cols() == 1);
+        iterative::FGMResMPI<scalar_t>
+          (comm_, spmv, prec, nloc, x.data(), bloc.data(),
+           opts_.rel_tol(), opts_.abs_tol(),
+           this->Krylov_its_, opts_.maxit(),
+           opts_.gmres_restart(), opts_.GramSchmidt_type(),
+           use_initial_guess, opts_.verbose() && is_root_);
+      };
+    auto gcrodr =
+      [&](const std::function<void(scalar_t*)>& prec) {
+        assert(x.cols() == 1);
+        iterative::GCRODRMPI<scalar_t>
+          (comm_, spmv, prec, nloc, x.data(), bloc.data(),
+           opts_.rel_tol(), opts_.abs_tol(),
+           this->Krylov_its_, opts_.maxit(),
+           opts_.gmres_restart(), opts_.gcrodr_recycle(),
+           this->Krylov_recycle_, opts_.GramSchmidt_type(),
+           use_initial_guess, opts_.verbose() && is_root_);
+      };
     auto bicgstab =
       [&](const std::function<void(scalar_t*)>& prec) {
         assert(x.cols() == 1);
@@ -337,7 +422,10 @@ namespace strumpack {
 
     switch (opts_.Krylov_solver()) {
     case KrylovSolver::AUTO: {
-      if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
+      if (opts_.mixed_precision_fronts() && x.cols() == 1)
+        gmres_ir(MFsolve);
+      else if (opts_.compression() != CompressionType::NONE &&
+               x.cols() == 1)
         gmres(MFsolve);
       else refine();
     }; break;
@@ -350,6 +438,18 @@ namespace strumpack {
     case KrylovSolver::PREC_GMRES: {
       gmres(MFsolve);
     }; break;
+    case KrylovSolver::PIPELINED_GMRES: {
+      pipelined_gmres(MFsolve);
+    }; break;
+    case KrylovSolver::PREC_FGMRES: {
+      fgmres(MFsolve);
+    }; break;
+    case KrylovSolver::PREC_GCRODR: {
+      gcrodr(MFsolve);
+    }; break;
+    case KrylovSolver::PREC_GMRES_IR: {
+      gmres_ir(MFsolve);
+    }; break;
     case KrylovSolver::BICGSTAB: {
       bicgstab([](scalar_t*){});
     }; break;
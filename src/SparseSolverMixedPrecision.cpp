@@ -103,7 +103,8 @@ namespace strumpack {
         (mat_, solve_func, x, b, opts_.rel_tol(), opts_.abs_tol(),
          Krylov_its_, opts_.maxit(), use_initial_guess, opts_.verbose());
     }; break;
-    case KrylovSolver::PREC_GMRES: {
+    case KrylovSolver::PREC_GMRES:
+    case KrylovSolver::PIPELINED_GMRES: {
       assert(x.cols() == 1);
       iterative::GMRes<refine_t>
         (spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
@@ -111,6 +112,44 @@ namespace strumpack {
          opts_.gmres_restart(), opts_.GramSchmidt_type(),
          use_initial_guess, opts_.verbose());
     }; break;
+    case KrylovSolver::PREC_FGMRES: {
+      assert(x.cols() == 1);
+      using real_t = typename RealType<refine_t>::value_type;
+      using factor_real_t = typename RealType<factor_t>::value_type;
+      // relax the inner solver tolerance as the outer residual
+      // decreases, see SPOptions::set_inner_tol_factor
+      auto inner_rtol = solver_.options().rel_tol();
+      std::function<void(real_t)> outer_res;
+      if (opts_.inner_tol_factor() > real_t(0.))
+        outer_res = [&](real_t r) {
+          auto rtol = std::max
+          (factor_real_t(opts_.inner_tol_factor() * opts_.rel_tol() / r),
+           inner_rtol);
+          solver_.options().set_rel_tol(std::min(rtol, factor_real_t(.5)));
+        };
+      iterative::FGMRes<refine_t>
+        (spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
+         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+         opts_.gmres_restart(), opts_.GramSchmidt_type(),
+         use_initial_guess, opts_.verbose(), outer_res);
+      solver_.options().set_rel_tol(inner_rtol);
+    }; break;
+    case KrylovSolver::PREC_GCRODR: {
+      assert(x.cols() == 1);
+      iterative::GCRODR<refine_t>
+        (spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
+         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+         opts_.gmres_restart(), opts_.gcrodr_recycle(), Krylov_recycle_,
+         opts_.GramSchmidt_type(), use_initial_guess, opts_.verbose());
+    }; break;
+    case KrylovSolver::PREC_GMRES_IR: {
+      assert(x.cols() == 1);
+      iterative::GMResIR<refine_t>
+        (spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
+         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+         opts_.gmres_restart(), opts_.GramSchmidt_type(),
+         use_initial_guess, opts_.verbose());
+    }; break;
     case KrylovSolver::PREC_BICGSTAB: {
       assert(x.cols() == 1);
       iterative::BiCGStab<refine_t>
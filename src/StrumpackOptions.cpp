@@ -84,6 +84,7 @@ namespace strumpack {
     case CompressionType::ZFP_BLR_HODLR: return "zfp_blr_hodlr";
     case CompressionType::LOSSY: return "lossy";
     case CompressionType::LOSSLESS: return "lossless";
+    case CompressionType::AUTO: return "auto";
     }
     return "UNKNOWN";
   }
@@ -184,6 +185,24 @@ namespace strumpack {
        {"sp_proportional_mapping",      required_argument, 0, 49},
        {"sp_enable_openmp_tree",        no_argument, 0, 50},
        {"sp_disable_openmp_tree",       no_argument, 0, 51},
+       {"sp_gcrodr_recycle",            required_argument, 0, 52},
+       {"sp_enable_assembly_map",       no_argument, 0, 53},
+       {"sp_disable_assembly_map",      no_argument, 0, 54},
+       {"sp_enable_incremental_factorization",  no_argument, 0, 55},
+       {"sp_disable_incremental_factorization", no_argument, 0, 56},
+       {"sp_low_rank_update_max_rank",  required_argument, 0, 57},
+       {"sp_enable_hss_warm_start",     no_argument, 0, 58},
+       {"sp_disable_hss_warm_start",    no_argument, 0, 59},
+       {"sp_front_trace",               required_argument, 0, 60},
+       {"sp_enable_mixed_precision_fronts",  no_argument, 0, 61},
+       {"sp_disable_mixed_precision_fronts", no_argument, 0, 62},
+       // 63 is '?', returned by getopt for unrecognized options
+       {"sp_mixed_precision_sep_size",  required_argument, 0, 64},
+       {"sp_low_rank_update_rel_tol",   required_argument, 0, 65},
+       {"sp_low_rank_update_abs_tol",   required_argument, 0, 66},
+       {"sp_enable_task_dag",           no_argument, 0, 67},
+       {"sp_disable_task_dag",          no_argument, 0, 68},
+       {"sp_inner_tol_factor",          required_argument, 0, 69},
        {"sp_verbose",                   no_argument, 0, 'v'},
        {"sp_quiet",                     no_argument, 0, 'q'},
        {"help",                         no_argument, 0, 'h'},
@@ -220,6 +239,12 @@ namespace strumpack {
         else if (s == "gmres") set_Krylov_solver(KrylovSolver::GMRES);
         else if (s == "pbicgstab") set_Krylov_solver(KrylovSolver::PREC_BICGSTAB);
         else if (s == "bicgstab") set_Krylov_solver(KrylovSolver::BICGSTAB);
+        else if (s == "pipelined_gmres")
+          set_Krylov_solver(KrylovSolver::PIPELINED_GMRES);
+        else if (s == "fgmres") set_Krylov_solver(KrylovSolver::PREC_FGMRES);
+        else if (s == "gcrodr") set_Krylov_solver(KrylovSolver::PREC_GCRODR);
+        else if (s == "gmres_ir")
+          set_Krylov_solver(KrylovSolver::PREC_GMRES_IR);
         else std::cerr << "# WARNING: Krylov solver not recognized,"
                " using default" << std::endl;
       } break;
@@ -287,9 +312,11 @@ namespace strumpack {
         else if (s == "ZFP_BLR_HODLR") set_compression(CompressionType::ZFP_BLR_HODLR);
         else if (s == "LOSSY") set_compression(CompressionType::LOSSY);
         else if (s == "LOSSLESS") set_compression(CompressionType::LOSSLESS);
+        else if (s == "AUTO") set_compression(CompressionType::AUTO);
         else std::cerr << "# WARNING: compression type not"
                " recognized, use 'none', 'hss', 'blr', 'hodlr',"
-               " 'blr_hodlr', 'zfp_blr_hodlr', 'lossy' or 'lossless'" << std::endl;
+               " 'blr_hodlr', 'zfp_blr_hodlr', 'lossy', 'lossless'"
+               " or 'auto'" << std::endl;
       } break;
       case 21: {
         std::istringstream iss(optarg);
@@ -422,6 +449,43 @@ namespace strumpack {
       } break;
       case 50: enable_openmp_tree(); break;
       case 51: disable_openmp_tree(); break;
+      case 52: {
+        std::istringstream iss(optarg);
+        iss >> gcrodr_recycle_;
+        set_gcrodr_recycle(gcrodr_recycle_); } break;
+      case 53: enable_assembly_map(); break;
+      case 54: disable_assembly_map(); break;
+      case 55: enable_incremental_factorization(); break;
+      case 56: disable_incremental_factorization(); break;
+      case 57: {
+        std::istringstream iss(optarg);
+        iss >> low_rank_update_max_rank_;
+        set_low_rank_update_max_rank(low_rank_update_max_rank_); } break;
+      case 58: enable_HSS_warm_start(); break;
+      case 59: disable_HSS_warm_start(); break;
+      case 60: {
+        std::istringstream iss(optarg);
+        iss >> front_trace_; } break;
+      case 61: enable_mixed_precision_fronts(); break;
+      case 62: disable_mixed_precision_fronts(); break;
+      case 64: {
+        std::istringstream iss(optarg);
+        iss >> mixed_precision_sep_size_;
+        set_mixed_precision_sep_size(mixed_precision_sep_size_); } break;
+      case 65: {
+        std::istringstream iss(optarg);
+        iss >> low_rank_update_rel_tol_;
+        set_low_rank_update_rel_tol(low_rank_update_rel_tol_); } break;
+      case 66: {
+        std::istringstream iss(optarg);
+        iss >> low_rank_update_abs_tol_;
+        set_low_rank_update_abs_tol(low_rank_update_abs_tol_); } break;
+      case 67: enable_task_dag(); break;
+      case 68: disable_task_dag(); break;
+      case 69: {
+        std::istringstream iss(optarg);
+        iss >> inner_tol_factor_;
+        set_inner_tol_factor(inner_tol_factor_); } break;
       case 'h': { describe_options(); } break;
       case 'v': set_verbose(true); break;
       case 'q': set_verbose(false); break;
@@ -462,12 +526,33 @@ namespace strumpack {
     std::cout << "#          Krylov absolute (preconditioned) residual"
               << " stopping tolerance" << std::endl;
     std::cout << "#   --sp_Krylov_solver [auto|direct|refinement|pgmres|"
-              << "gmres|pbicgstab|bicgstab]" << std::endl;
+              << "gmres|pbicgstab|bicgstab|pipelined_gmres|"
+              << "fgmres|gcrodr|gmres_ir]" << std::endl;
     std::cout << "#          default: auto (refinement when using compression, pgmres"
               << " (preconditioned) with compression)" << std::endl;
     std::cout << "#   --sp_gmres_restart int (default " << gmres_restart()
               << ")" << std::endl;
     std::cout << "#          gmres restart length" << std::endl;
+    std::cout << "#   --sp_gcrodr_recycle int (default " << gcrodr_recycle()
+              << ")" << std::endl;
+    std::cout << "#          dimension of the recycle space for gcrodr"
+              << std::endl;
+    std::cout << "#   --sp_inner_tol_factor real (default "
+              << inner_tol_factor() << ")" << std::endl;
+    std::cout << "#          relax the inner solver tolerance with fgmres,"
+              << " 0 to disable" << std::endl;
+    std::cout << "#   --sp_low_rank_update_max_rank int (default "
+              << low_rank_update_max_rank() << ")" << std::endl;
+    std::cout << "#          recompress low-rank updates above this rank"
+              << std::endl;
+    std::cout << "#   --sp_low_rank_update_rel_tol real (default "
+              << low_rank_update_rel_tol() << ")" << std::endl;
+    std::cout << "#          relative tolerance for low-rank update"
+              << " recompression" << std::endl;
+    std::cout << "#   --sp_low_rank_update_abs_tol real (default "
+              << low_rank_update_abs_tol() << ")" << std::endl;
+    std::cout << "#          absolute tolerance for low-rank update"
+              << " recompression" << std::endl;
     std::cout << "#   --sp_GramSchmidt_type [modified|classical]"
               << std::endl;
     std::cout << "#          Gram-Schmidt type for GMRES" << std::endl;
@@ -522,7 +607,7 @@ namespace strumpack {
         get_description(get_matching(i)) << std::endl;
     std::cout << "#   --sp_compression (default "
               << get_name(comp_) << ")" << std::endl
-              << "#          should be [none|hss|blr|hodlr|lossy|blr_hodlr|zfp_blr_hodlr]" << std::endl
+              << "#          should be [none|hss|blr|hodlr|lossy|blr_hodlr|zfp_blr_hodlr|auto]" << std::endl
               << "#          type of rank-structured compression to use"
               << std::endl;
     std::cout << "#   --sp_compression_min_sep_size (default "
@@ -563,6 +648,56 @@ namespace strumpack {
               << std::boolalpha << !use_openmp_tree_ << ")" << std::endl
               << "#          uses less more memory, but scales worse with OpenMP threads"
               << std::endl;
+    std::cout << "#   --sp_enable_task_dag (default "
+              << std::boolalpha << use_task_dag_ << ")" << std::endl
+              << "#          factor trees of dense fronts as a task graph"
+              << std::endl;
+    std::cout << "#   --sp_disable_task_dag (default "
+              << std::boolalpha << !use_task_dag_ << ")" << std::endl;
+    std::cout << "#   --sp_enable_assembly_map (default "
+              << std::boolalpha << use_assembly_map_ << ")" << std::endl
+              << "#          store where matrix nonzeros go in the fronts,"
+              << std::endl
+              << "#          speeds up repeated factorizations" << std::endl;
+    std::cout << "#   --sp_disable_assembly_map (default "
+              << std::boolalpha << !use_assembly_map_ << ")" << std::endl;
+    std::cout << "#   --sp_enable_incremental_factorization (default "
+              << std::boolalpha << incremental_factorization_ << ")"
+              << std::endl
+              << "#          keep the contribution blocks, only refactor"
+              << std::endl
+              << "#          the fronts affected by changed matrix values"
+              << std::endl;
+    std::cout << "#   --sp_disable_incremental_factorization (default "
+              << std::boolalpha << !incremental_factorization_ << ")"
+              << std::endl;
+    std::cout << "#   --sp_enable_hss_warm_start (default "
+              << std::boolalpha << hss_warm_start_ << ")" << std::endl
+              << "#          recompress HSS fronts starting from the"
+              << std::endl
+              << "#          bases of the previous factorization"
+              << std::endl;
+    std::cout << "#   --sp_disable_hss_warm_start (default "
+              << std::boolalpha << !hss_warm_start_ << ")" << std::endl;
+    std::cout << "#   --sp_enable_mixed_precision_fronts (default "
+              << std::boolalpha << mixed_precision_fronts_ << ")"
+              << std::endl
+              << "#          factor fronts with small separators in"
+              << std::endl
+              << "#          single precision" << std::endl;
+    std::cout << "#   --sp_disable_mixed_precision_fronts (default "
+              << std::boolalpha << !mixed_precision_fronts_ << ")"
+              << std::endl;
+    std::cout << "#   --sp_mixed_precision_sep_size int (default "
+              << mixed_precision_sep_size_ << ")" << std::endl
+              << "#          fronts with a smaller separator are factored"
+              << std::endl
+              << "#          in single precision" << std::endl;
+    std::cout << "#   --sp_front_trace file (default none)" << std::endl
+              << "#          write per-front telemetry, Chrome trace"
+              << std::endl
+              << "#          JSON, or binary log if file ends in .bin"
+              << std::endl;
     std::cout << "#   --sp_lossy_precision [1-64] (default "
               << lossy_precision() << ")" << std::endl
               << "#          lossy compression precision" << std::endl
@@ -33,6 +33,7 @@
 #define SPOPTIONS_HPP
 
 #include <limits>
+#include <algorithm>
 
 #include "dense/BLASLAPACKWrapper.hpp"
 #include "HSS/HSSOptions.hpp"
@@ -102,7 +103,9 @@ namespace strumpack {
                     fronts and Hierarchically Off-diagonal
                     Low-Rank compression of large fronts  */
     LOSSLESS,  /*!< Lossless cmpresssion                  */
-    LOSSY      /*!< Lossy cmpresssion                     */
+    LOSSY,     /*!< Lossy cmpresssion                     */
+    AUTO       /*!< Select dense, BLR, HSS or HODLR per
+                    front, based on a cost model          */
   };
 
   /**
@@ -163,8 +166,11 @@ namespace strumpack {
    * \ingroup Enumerations
    */
   enum class KrylovSolver {
-    AUTO,           /*!< Use iterative refinement if no compression is
-                      used, otherwise use GMRes.                            */
+    AUTO,           /*!< Use iterative refinement if no compression and
+                      no mixed precision fronts are used, GMRes with
+                      compression. With mixed precision fronts, use
+                      GMRES based iterative refinement (GMRES-IR) for
+                      a single right-hand side.                            */
     DIRECT,         /*!< No outer iterative solver, just a single
                       application of the multifrontal solver.               */
     REFINE,         /*!< Iterative refinement.                              */
@@ -173,7 +179,24 @@ namespace strumpack {
     GMRES,          /*!< UN-preconditioned GMRes. (for testing mainly)      */
     PREC_BICGSTAB,  /*!< Preconditioned BiCGStab. The preconditioner is the
                       (approx) multifrontal solver.                         */
-    BICGSTAB        /*!< UN-preconditioned BiCGStab. (for testing mainly)   */
+    BICGSTAB,       /*!< UN-preconditioned BiCGStab. (for testing mainly)   */
+    PIPELINED_GMRES, /*!< Preconditioned pipelined GMRes, with a single
+                      global reduction per iteration, overlapped with the
+                      preconditioner. Only differs from PREC_GMRES in the
+                      distributed memory solver.                           */
+    PREC_FGMRES,    /*!< Flexible GMRes, right preconditioned, allows the
+                      preconditioner to change between iterations. Useful
+                      as outer solver for the mixed precision solvers,
+                      with an inexact (iterative) inner solver.            */
+    PREC_GCRODR,    /*!< Preconditioned GMRes with Krylov subspace
+                      recycling (GCRO-DR). A deflation space is kept in
+                      the solver object and reused in subsequent solves,
+                      see SPOptions::set_gcrodr_recycle.                  */
+    PREC_GMRES_IR   /*!< GMRES based iterative refinement (GMRES-IR), the
+                      residual is computed in working precision, each
+                      correction with preconditioned GMRes. For a low
+                      precision factorization, with mixed precision
+                      fronts or in the mixed precision solvers.            */
   };
 
   /**
@@ -302,6 +325,72 @@ namespace strumpack {
      */
     void set_gmres_restart(int m) { assert(m >= 1); gmres_restart_ = m; }
 
+    /**
+     * Set the maximum dimension of the recycle (deflation) space used
+     * with KrylovSolver::PREC_GCRODR. This space is kept from one
+     * solve to the next, and is part of the GMRES restart length, so
+     * it should be smaller than gmres_restart().
+     *
+     * \param k recycle space dimension, should be >= 0
+     * \see set_gmres_restart(), set_Krylov_solver()
+     */
+    void set_gcrodr_recycle(int k) { assert(k >= 0); gcrodr_recycle_ = k; }
+
+    /**
+     * Relax the tolerance of an inner iterative solver, used as a
+     * preconditioner for KrylovSolver::PREC_FGMRES, as the outer
+     * iteration converges. When f > 0, the relative tolerance of the
+     * inner solver for the next outer iteration is set to
+     * min(max(f * rel_tol() / r, inner_rel_tol), 0.5), with r the
+     * current relative outer residual and inner_rel_tol the relative
+     * tolerance set in the inner solver options. Only used by the
+     * mixed precision solvers, where the inner solver is itself
+     * iterative. With f = 0 (the default) the inner tolerance is
+     * kept fixed.
+     *
+     * \param f relaxation factor, should be >= 0
+     * \see set_Krylov_solver(), set_rel_tol()
+     */
+    void set_inner_tol_factor(real_t f) {
+      assert(f >= real_t(0.)); inner_tol_factor_ = f;
+    }
+
+    /**
+     * Set the rank above which an accumulated low-rank update, see
+     * SparseSolverBase::add_low_rank_update, is recompressed, with
+     * the low_rank_update_rel_tol() and low_rank_update_abs_tol()
+     * tolerances. The sparse factorization is never redone because
+     * of a low-rank update, a dense U V^H cannot be added to the
+     * sparse factors. If the rank after recompression remains large,
+     * use update_matrix_values with the modified matrix and
+     * clear_low_rank_update instead.
+     *
+     * \param k maximum rank, should be >= 0
+     */
+    void set_low_rank_update_max_rank(int k) {
+      assert(k >= 0); low_rank_update_max_rank_ = k;
+    }
+
+    /**
+     * Set the relative tolerance used to recompress an accumulated
+     * low-rank update, see set_low_rank_update_max_rank().
+     *
+     * \param rtol relative tolerance, should be >= 0
+     */
+    void set_low_rank_update_rel_tol(real_t rtol) {
+      assert(rtol >= real_t(0.)); low_rank_update_rel_tol_ = rtol;
+    }
+
+    /**
+     * Set the absolute tolerance used to recompress an accumulated
+     * low-rank update, see set_low_rank_update_max_rank().
+     *
+     * \param atol absolute tolerance, should be >= 0
+     */
+    void set_low_rank_update_abs_tol(real_t atol) {
+      assert(atol >= real_t(0.)); low_rank_update_abs_tol_ = atol;
+    }
+
     /**
      * Set the type of Gram-Schmidt orthogonalization to use in GMRES
      *
@@ -758,6 +847,143 @@ namespace strumpack {
      */
     void disable_openmp_tree() { use_openmp_tree_ = false; }
 
+    /**
+     * Factor trees of dense fronts as a graph of OpenMP tasks, with
+     * one task per front and tiled LU for large fronts, instead of
+     * the recursive fork-join tree traversal. This avoids the
+     * synchronization at every level of the tree. This only applies
+     * when the OpenMP tree traversal is enabled and more than one
+     * thread is used.
+     * \see enable_openmp_tree
+     */
+    void enable_task_dag() { use_task_dag_ = true; }
+
+    /**
+     * Use the recursive fork-join traversal of the tree of dense
+     * fronts (the default).
+     */
+    void disable_task_dag() { use_task_dag_ = false; }
+
+    /**
+     * Store, for each front, where the nonzeros of the sparse matrix
+     * are assembled in the front. This map is built during the first
+     * numerical factorization and reused when the matrix is
+     * refactored with new values (see update_matrix_values). This
+     * requires extra memory, 3 integers (integer_t) per nonzero: the
+     * offset in the values array and the row and column in the
+     * front.
+     */
+    void enable_assembly_map() { use_assembly_map_ = true; }
+
+    /**
+     * Do not store the front assembly map, the nonzeros of the
+     * sparse matrix are searched for each front during every
+     * numerical factorization.
+     */
+    void disable_assembly_map() { use_assembly_map_ = false; }
+
+    /**
+     * Keep the contribution blocks of the dense fronts after the
+     * numerical factorization. When the matrix values are then
+     * changed with update_matrix_values, the solver compares the new
+     * values with the old ones, and the next factorization only
+     * refactors the fronts on the paths from the changed separators
+     * to the root. This requires extra memory for the contribution
+     * blocks, and it only applies to the sequential/multithreaded
+     * solver without compression. This is not compatible with
+     * mixed precision fronts: with enable_mixed_precision_fronts,
+     * the lower precision fronts (and their ancestors) are always
+     * fully refactored.
+     */
+    void enable_incremental_factorization() {
+      incremental_factorization_ = true;
+    }
+
+    /**
+     * Do not keep the contribution blocks, every numerical
+     * factorization refactors all fronts.
+     */
+    void disable_incremental_factorization() {
+      incremental_factorization_ = false;
+    }
+
+    /**
+     * Keep the row and column bases of the HSS fronts after the
+     * numerical factorization. When the matrix values are then
+     * changed with update_matrix_values, the next factorization
+     * checks these bases against a new set of random samples, and
+     * only recompresses the HSS nodes for which the old bases no
+     * longer satisfy the compression tolerance. This keeps the
+     * permutation of the separators from the previous
+     * factorization, and requires extra memory for the bases of the
+     * contribution blocks. This only applies to the
+     * sequential/multithreaded solver with CompressionType::HSS and
+     * the CompressionAlgorithm::ORIGINAL HSS compression algorithm.
+     *
+     * \see HSS::HSSMatrix::compress_warm
+     */
+    void enable_HSS_warm_start() { hss_warm_start_ = true; }
+
+    /**
+     * Every numerical factorization compresses the HSS fronts from
+     * scratch.
+     */
+    void disable_HSS_warm_start() { hss_warm_start_ = false; }
+
+    /**
+     * Factor the small dense fronts in lower precision, float for a
+     * double solver and std::complex<float> for a
+     * std::complex<double> solver. Fronts with a separator smaller
+     * than mixed_precision_sep_size() are assembled in the working
+     * precision, factored in the lower precision, and their
+     * contribution block is added to the parent in the working
+     * precision. The larger fronts near the root, where pivot growth
+     * and conditioning matter most, stay in the working
+     * precision. A front for which the lower precision factorization
+     * fails, or shows large pivot growth, is refactored in the
+     * working precision. This reduces the memory and bandwidth for
+     * the factors of the lower part of the tree, and should be
+     * combined with an outer iterative solver, see
+     * KrylovSolver::AUTO or KrylovSolver::PREC_GMRES_IR. This has
+     * no effect for a solver in single precision, on the GPU, or on
+     * compressed fronts. The lower precision fronts do not keep
+     * their contribution block, so they are fully refactored, also
+     * with enable_incremental_factorization.
+     *
+     * \see set_mixed_precision_sep_size
+     */
+    void enable_mixed_precision_fronts() { mixed_precision_fronts_ = true; }
+
+    /**
+     * Factor all fronts in the working precision.
+     */
+    void disable_mixed_precision_fronts() { mixed_precision_fronts_ = false; }
+
+    /**
+     * Set the separator size below which a front is factored in
+     * lower precision, when mixed precision fronts are enabled.
+     *
+     * \see enable_mixed_precision_fronts
+     */
+    void set_mixed_precision_sep_size(int s) {
+      assert(s >= 0); mixed_precision_sep_size_ = s;
+    }
+
+    /**
+     * Record per-front telemetry (level, thread, MPI rank,
+     * dimensions, format, rank, flops, bytes, peak memory and the
+     * start/end times of the assembly, factorization and extend-add)
+     * during the numerical factorization, and write it to the file
+     * fname. If fname ends with ".bin", a compact binary log is
+     * written, otherwise a Chrome trace (JSON) which can be loaded
+     * in chrome://tracing or Perfetto. With multiple MPI processes,
+     * the rank is added to the file name. An empty string (the
+     * default) disables the tracing.
+     *
+     * \see FrontTrace
+     */
+    void set_front_trace(const std::string& fname) { front_trace_ = fname; }
+
     /**
      * Set the precision for lossy compression.
      */
@@ -810,6 +1036,41 @@ namespace strumpack {
      */
     int gmres_restart() const { return gmres_restart_; }
 
+    /**
+     * Get the maximum dimension of the GCRO-DR recycle space.
+     * \see set_gcrodr_recycle()
+     */
+    int gcrodr_recycle() const { return gcrodr_recycle_; }
+
+    /**
+     * Get the relaxation factor for the inner solver tolerance with
+     * KrylovSolver::PREC_FGMRES, 0 means no relaxation.
+     * \see set_inner_tol_factor()
+     */
+    real_t inner_tol_factor() const { return inner_tol_factor_; }
+
+    /**
+     * Get the rank above which low-rank updates are recompressed.
+     * \see set_low_rank_update_max_rank()
+     */
+    int low_rank_update_max_rank() const { return low_rank_update_max_rank_; }
+
+    /**
+     * Get the relative tolerance for low-rank update recompression.
+     * \see set_low_rank_update_rel_tol()
+     */
+    real_t low_rank_update_rel_tol() const {
+      return low_rank_update_rel_tol_;
+    }
+
+    /**
+     * Get the absolute tolerance for low-rank update recompression.
+     * \see set_low_rank_update_abs_tol()
+     */
+    real_t low_rank_update_abs_tol() const {
+      return low_rank_update_abs_tol_;
+    }
+
     /**
      * Get the Gram-Schmidth orthogonalization type used in GMRES.
      * \see set_GramSchmidth_type()
@@ -993,6 +1254,8 @@ namespace strumpack {
       case CompressionType::LOSSY:
       case CompressionType::LOSSLESS:
         return lossy_min_sep_size_;
+      case CompressionType::AUTO:
+        return std::min(blr_min_sep_size_, hss_min_sep_size_);
       case CompressionType::NONE:
       default:
         return std::numeric_limits<int>::max();
@@ -1036,6 +1299,8 @@ namespace strumpack {
       case CompressionType::LOSSY:
       case CompressionType::LOSSLESS:
         return lossy_min_front_size_;
+      case CompressionType::AUTO:
+        return std::min(blr_min_front_size_, hss_min_front_size_);
       case CompressionType::NONE:
       default:
         return std::numeric_limits<int>::max();
@@ -1131,6 +1396,55 @@ namespace strumpack {
      */
     bool use_openmp_tree() const { return use_openmp_tree_; }
 
+    /**
+     * Check whether trees of dense fronts are factored as a task
+     * graph.
+     * \see enable_task_dag
+     */
+    bool use_task_dag() const { return use_task_dag_; }
+
+    /**
+     * Check whether the front assembly map is used.
+     * \see enable_assembly_map
+     */
+    bool use_assembly_map() const { return use_assembly_map_; }
+
+    /**
+     * Check whether only the fronts affected by changed matrix values
+     * are refactored.
+     * \see enable_incremental_factorization
+     */
+    bool incremental_factorization() const {
+      return incremental_factorization_;
+    }
+
+    /**
+     * Check whether the HSS fronts are recompressed starting from
+     * the bases of the previous factorization.
+     * \see enable_HSS_warm_start
+     */
+    bool HSS_warm_start() const { return hss_warm_start_; }
+
+    /**
+     * Check whether the small fronts are factored in lower
+     * precision.
+     * \see enable_mixed_precision_fronts
+     */
+    bool mixed_precision_fronts() const { return mixed_precision_fronts_; }
+
+    /**
+     * Separator size below which fronts are factored in lower
+     * precision.
+     * \see set_mixed_precision_sep_size
+     */
+    int mixed_precision_sep_size() const { return mixed_precision_sep_size_; }
+
+    /**
+     * File to write the per-front telemetry to, empty if disabled.
+     * \see set_front_trace
+     */
+    const std::string& front_trace() const { return front_trace_; }
+
     /**
      * Returns the number of GPU streams to use.
      */
@@ -1238,6 +1552,12 @@ namespace strumpack {
     real_t abs_tol_ = default_abs_tol<real_t>();
     KrylovSolver Krylov_solver_ = KrylovSolver::AUTO;
     int gmres_restart_ = 30;
+    int gcrodr_recycle_ = 10;
+    real_t inner_tol_factor_ = real_t(0.);
+    int low_rank_update_max_rank_ = 64;
+    real_t low_rank_update_rel_tol_ =
+      real_t(100.) * std::numeric_limits<real_t>::epsilon();
+    real_t low_rank_update_abs_tol_ = real_t(0.);
     GramSchmidtType Gram_Schmidt_type_ = GramSchmidtType::MODIFIED;
     /** Reordering options */
     ReorderingStrategy reordering_method_ = ReorderingStrategy::METIS;
@@ -1259,6 +1579,13 @@ namespace strumpack {
     bool print_comp_front_stats_ = false;
     ProportionalMapping prop_map_ = ProportionalMapping::FLOPS;
     bool use_openmp_tree_ = true;
+    bool use_task_dag_ = false;
+    bool use_assembly_map_ = false;
+    bool incremental_factorization_ = false;
+    bool mixed_precision_fronts_ = false;
+    int mixed_precision_sep_size_ = 1000;
+    bool hss_warm_start_ = false;
+    std::string front_trace_;
 
     /** GPU options */
 #if defined(STRUMPACK_USE_CUDA) || defined(STRUMPACK_USE_HIP) || defined(STRUMPACK_USE_SYCL)
@@ -79,7 +79,8 @@ typedef enum
    STRUMPACK_BLR_HODLR=4,
    STRUMPACK_ZFP_BLR_HODLR=5,
    STRUMPACK_LOSSLESS=6,
-   STRUMPACK_LOSSY=7
+   STRUMPACK_LOSSY=7,
+   STRUMPACK_AUTO_COMPRESSION=8
   } STRUMPACK_COMPRESSION_TYPE;
 
 typedef enum
@@ -135,7 +136,11 @@ typedef enum
    STRUMPACK_PREC_GMRES=3,
    STRUMPACK_GMRES=4,
    STRUMPACK_PREC_BICGSTAB=5,
-   STRUMPACK_BICGSTAB=6
+   STRUMPACK_BICGSTAB=6,
+   STRUMPACK_PIPELINED_GMRES=7,
+   STRUMPACK_PREC_FGMRES=8,
+   STRUMPACK_PREC_GCRODR=9,
+   STRUMPACK_PREC_GMRES_IR=10
   } STRUMPACK_KRYLOV_SOLVER;
 
 typedef enum
@@ -161,6 +161,14 @@ namespace strumpack {
      * recomputing the permutation. The numerical factorization will
      * automatically be redone.
      *
+     * The first call after the reordering records where each
+     * nonzero ends up in the permuted and scaled matrix, later calls
+     * only gather the new values. With compression (except HSS with
+     * warm start), the structured fronts are partitioned again after
+     * each update. If this changes the permutation, the map is
+     * rebuilt on the next call, so the faster updates are only
+     * guaranteed without compression.
+     *
      * \param N Number of rows in the matrix.
      * \param row_ptr Row pointer array in the typical compressed
      * sparse row representation. This should be the same as used in
@@ -203,12 +211,48 @@ namespace strumpack {
      */
     void update_matrix_values(const CSRMatrix<scalar_t,integer_t>& A);
 
+    using SparseSolverBase<scalar_t,integer_t>::reorder;
+
+    /**
+     * Perform the sparse matrix reordering by reusing the symbolic
+     * analysis from another solver, see symbolic_analysis(). This
+     * skips the matching, the nested dissection and the symbolic
+     * factorization. The other solver can have a different scalar
+     * type (but the same integer_t), and its matrix should have the
+     * same sparsity pattern as the matrix of this solver. The
+     * matching job from the analysis overrides the matching option
+     * of this solver. Separator reordering for the compression in
+     * this solver is still done (with the options of this solver).
+     *
+     * \param analysis symbolic analysis obtained with
+     * symbolic_analysis() from another solver. It is not modified,
+     * and it is kept (shared) by this solver.
+     * \return REORDERING_ERROR when the size or the (symmetrized)
+     * number of nonzeros of the matrix does not match the analysis
+     */
+    ReturnCode
+    reorder(std::shared_ptr<const SymbolicAnalysis<integer_t>> analysis);
+
+    /**
+     * Get the (scalar type independent) symbolic analysis computed
+     * during the last call to reorder, to be passed to
+     * reorder(analysis) of other solvers for matrices with the same
+     * sparsity pattern. It is only constructed on the first call, and
+     * the same object is returned by later calls. If this solver
+     * itself reused an analysis, that same analysis is returned.
+     *
+     * \return the symbolic analysis, nullptr if the matrix has not
+     * been reordered yet
+     */
+    std::shared_ptr<const SymbolicAnalysis<integer_t>> symbolic_analysis();
+
   private:
     void setup_tree() override;
     void setup_reordering() override;
     int compute_reordering(const int* p, int base,
                            int nx, int ny, int nz,
-                           int components, int width) override;
+                           int components, int width,
+                           const SeparatorTree<integer_t>* sep_tree) override;
     void separator_reordering() override;
 
     SpMat_t* matrix() override { return mat_.get(); }
@@ -221,8 +265,6 @@ namespace strumpack {
     const Reord_t* reordering() const override { return nd_.get(); }
     const Tree_t* tree() const override { return tree_.get(); }
 
-    void permute_matrix_values();
-
     ReturnCode solve_internal(const scalar_t* b, scalar_t* x,
                               bool use_initial_guess=false) override;
     ReturnCode solve_internal(const DenseM_t& b, DenseM_t& x,
@@ -246,6 +288,9 @@ namespace strumpack {
     using SPBase_t::factored_;
     using SPBase_t::reordered_;
     using SPBase_t::Krylov_its_;
+    using SPBase_t::val_map_;
+    using SPBase_t::val_map_nnz_;
+    using SPBase_t::symb_;
   };
 
   template<typename scalar_t,typename integer_t>
@@ -311,12 +311,19 @@ namespace strumpack {
     void setup_tree() override;
     void setup_reordering() override;
     int compute_reordering(const int* p, int base, int nx, int ny, int nz,
-                           int components, int width) override;
+                           int components, int width,
+                           const SeparatorTree<integer_t>* sep_tree) override;
     void separator_reordering() override;
 
     void perf_counters_stop(const std::string& s) override;
     void synchronize() override { comm_.barrier(); }
     void reduce_flop_counters() const override;
+    void all_reduce_sum(DenseM_t& M) const override {
+      comm_.all_reduce(M.data(), M.rows()*M.cols(), MPI_SUM);
+    }
+    std::size_t local_rows() const override {
+      return mat_mpi_->local_rows();
+    }
 
     double max_peak_memory() const override {
       return comm_.reduce(double(params::peak_memory), MPI_MAX);
@@ -325,7 +332,12 @@ namespace strumpack {
       return comm_.reduce(double(params::peak_memory), MPI_MIN);
     }
 
-    void redistribute_values();
+    // how the values were passed to update_matrix_values
+    enum class ValueLayout { CSR, MPI, MPIAIJ };
+    ValueLayout val_map_layout_ = ValueLayout::CSR;
+    void redistribute_values(integer_t local_rows, const integer_t* row_ptr,
+                             const integer_t* col_ind,
+                             const scalar_t* values, ValueLayout layout);
 
     void delete_factors_internal() override;
 
@@ -70,6 +70,22 @@ namespace strumpack {
    * set the inner solver to be KrylovSolver::DIRECT (a single
    * preconditioner application), and the outer solver to be
    * KrylovSolver::AUTO (which will default to iterative refinement).
+   * If the inner solver is set to an iterative solver, for instance
+   * KrylovSolver::PREC_GMRES with a relaxed tolerance, the
+   * preconditioner changes from one outer iteration to the next, and
+   * the outer solver should be KrylovSolver::PREC_FGMRES. With
+   * PREC_FGMRES the outer stopping criterion is based on the
+   * unpreconditioned residual, in refine_t precision. For ill
+   * conditioned problems, where plain iterative refinement with the
+   * factor_t factorization stagnates, use the outer solver
+   * KrylovSolver::PREC_GMRES_IR (GMRES based iterative refinement).
+   *
+   * This class factors all fronts in factor_t precision. To only
+   * factor the small fronts in lower precision, and keep the large
+   * fronts near the root in double precision, use the double
+   * precision solver with SPOptions::enable_mixed_precision_fronts,
+   * where KrylovSolver::AUTO uses GMRES based iterative refinement
+   * (GMRES-IR).
    *
    * \tparam factor_t can be: float or std::complex<float>
    * \tparam refine_t can be: double or std::complex<double>
@@ -141,6 +157,7 @@ namespace strumpack {
     SparseSolverMPIDist<factor_t,integer_t> solver_;
     SPOptions<refine_t> opts_;
     int Krylov_its_ = 0;
+    DenseMatrix<refine_t> Krylov_recycle_;
   };
 
   template<typename factor_t,typename refine_t,typename integer_t>
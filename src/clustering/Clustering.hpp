@@ -37,9 +37,15 @@
 
 #include <random>
 #include <vector>
+#include <numeric>
+#include <cstdint>
+#include <functional>
 
 #include "structured/ClusterTree.hpp"
 #include "dense/DenseMatrix.hpp"
+#if defined(STRUMPACK_USE_MPI)
+#include "misc/MPIWrapper.hpp"
+#endif
 
 namespace strumpack {
 
@@ -96,22 +102,38 @@ namespace strumpack {
 
 
   template<typename T> void
-  pca_partition(DenseMatrix<T>& p, std::vector<std::size_t>& nc, int* perm);
+  pca_partition(DenseMatrix<T>& p, std::vector<std::size_t>& nc, int* perm,
+                int depth=0);
   template<typename T> structured::ClusterTree
   recursive_pca(DenseMatrix<T>& p, std::size_t cluster_size, int* perm);
 
   template<typename T> void
-  cobble_partition(DenseMatrix<T>& p, std::vector<std::size_t>& nc, int* perm);
+  cobble_partition(DenseMatrix<T>& p, std::vector<std::size_t>& nc,
+                   int* perm, int depth=0);
   template<typename T> structured::ClusterTree
   recursive_cobble(DenseMatrix<T>& p, std::size_t cluster_size, int* perm);
 
   template<typename T> structured::ClusterTree
   recursive_2_means(DenseMatrix<T>& p, std::size_t cluster_size,
-                    int* perm, std::mt19937& generator);
+                    int* perm, std::mt19937& generator,
+                    bool balanced=false);
+  /**
+   * Recursive 2-means, where the generator for the root cluster is
+   * constructed from seed. Every cluster uses its own generator,
+   * seeded from its parent's generator. If leaf_seeds is not null,
+   * it should have p.cols() elements, and on output leaf_seeds[i] is
+   * the seed of the leaf cluster starting at column i. Clustering
+   * the (reordered) points of a leaf with that seed gives the same
+   * subtree as continuing the recursion from that leaf.
+   */
+  template<typename T> structured::ClusterTree
+  recursive_2_means(DenseMatrix<T>& p, std::size_t cluster_size,
+                    int* perm, std::uint32_t seed, bool balanced,
+                    std::uint32_t* leaf_seeds);
 
   template<typename T> void
   kd_partition(DenseMatrix<T>& p, std::vector<std::size_t>& nc,
-               std::size_t cluster_size, int* perm);
+               std::size_t cluster_size, int* perm, int depth=0);
   template<typename T> structured::ClusterTree
   recursive_kd(DenseMatrix<T>& p, std::size_t cluster_size, int* perm);
 
@@ -133,6 +155,12 @@ namespace strumpack {
    * \param cluster_size Stop partitioning when this cluster_size is
    * reached. This corresponds to the HSS/HODLR leaf size.
    *
+   * \param balanced Always split a cluster in two halves. This only
+   * affects ClusteringAlgorithm::TWO_MEANS, the other algorithms
+   * already split at the median. Balanced leaf sizes give better load
+   * balance in the HSS/HODLR construction, but possibly a less
+   * accurate clustering.
+   *
    * \return This is output, a structured::ClusterTree defined by the
    * (recursive) clustering.
    *
@@ -142,7 +170,8 @@ namespace strumpack {
   template<typename scalar_t>
   structured::ClusterTree binary_tree_clustering
   (ClusteringAlgorithm algo, DenseMatrix<scalar_t>& p,
-   std::vector<int>& perm, std::size_t cluster_size) {
+   std::vector<int>& perm, std::size_t cluster_size,
+   bool balanced=false) {
     structured::ClusterTree tree;
     perm.resize(p.cols());
     std::iota(perm.begin(), perm.end(), 1);
@@ -151,10 +180,11 @@ namespace strumpack {
       tree.size = p.cols();
       tree.refine(cluster_size);
     } break;
-    case ClusteringAlgorithm::TWO_MEANS: {
-      std::mt19937 gen(1); // reproducible
-      tree = recursive_2_means(p, cluster_size, perm.data(), gen);
-    } break;
+    case ClusteringAlgorithm::TWO_MEANS:
+      // fixed seed, reproducible
+      tree = recursive_2_means
+        (p, cluster_size, perm.data(), 1, balanced, nullptr);
+      break;
     case ClusteringAlgorithm::KD_TREE:
       tree = recursive_kd(p, cluster_size, perm.data()); break;
     case ClusteringAlgorithm::PCA:
@@ -167,6 +197,93 @@ namespace strumpack {
     return tree;
   }
 
+#if defined(STRUMPACK_USE_MPI)
+  /**
+   * Distributed version of binary_tree_clustering. The input data p
+   * should be the same on all processes in c, and on output p, perm
+   * and the returned tree are the same on all processes.
+   *
+   * The top levels of the tree are computed redundantly by all
+   * processes, until there are at least c.size() clusters. The
+   * subtrees for these clusters are then distributed over the
+   * processes, and the resulting (reordered) data, permutation and
+   * subtrees are broadcast from the process that computed them. The
+   * result is the same as with the sequential
+   * binary_tree_clustering, for any number of processes.
+   *
+   * \see binary_tree_clustering
+   */
+  template<typename scalar_t>
+  structured::ClusterTree binary_tree_clustering
+  (const MPIComm& c, ClusteringAlgorithm algo, DenseMatrix<scalar_t>& p,
+   std::vector<int>& perm, std::size_t cluster_size,
+   bool balanced=false) {
+    std::size_t n = p.cols(), d = p.rows(), P = c.size();
+    if (P == 1 || algo == ClusteringAlgorithm::NATURAL)
+      return binary_tree_clustering(algo, p, perm, cluster_size, balanced);
+    // with 2-means, the leafs are clustered further with the seed
+    // they would get in the sequential recursion, so the result does
+    // not depend on the number of processes
+    bool two_means = algo == ClusteringAlgorithm::TWO_MEANS;
+    std::vector<std::uint32_t> seeds(two_means ? n : 0);
+    auto top_size = std::max(cluster_size, (n + P - 1) / P);
+    structured::ClusterTree tree;
+    if (two_means) {
+      perm.resize(n);
+      std::iota(perm.begin(), perm.end(), 1);
+      tree = recursive_2_means
+        (p, top_size, perm.data(), 1, balanced, seeds.data());
+    } else
+      tree = binary_tree_clustering(algo, p, perm, top_size, balanced);
+    std::vector<structured::ClusterTree*> leafs;
+    std::function<void(structured::ClusterTree&)> find_leafs =
+      [&](structured::ClusterTree& t) {
+        if (t.c.empty()) leafs.push_back(&t);
+        else for (auto& ch : t.c) find_leafs(ch);
+      };
+    find_leafs(tree);
+    // leafs are assigned to processes in contiguous groups, based on
+    // the position of their midpoint
+    std::size_t nl = leafs.size();
+    std::vector<std::size_t> lo(nl+1);
+    std::vector<int> owner(nl);
+    for (std::size_t i=0; i<nl; i++) {
+      lo[i+1] = lo[i] + leafs[i]->size;
+      owner[i] = std::min(P-1, (lo[i] + lo[i+1]) * P / (2*n));
+    }
+    std::vector<std::vector<int>> sub(nl);
+    for (std::size_t i=0; i<nl; i++) {
+      if (owner[i] != c.rank()) continue;
+      auto m = lo[i+1] - lo[i];
+      DenseMatrixWrapper<scalar_t> pl(d, m, p, 0, lo[i]);
+      std::vector<int> lperm;
+      structured::ClusterTree t;
+      if (two_means) {
+        lperm.resize(m);
+        std::iota(lperm.begin(), lperm.end(), 1);
+        t = recursive_2_means
+          (pl, cluster_size, lperm.data(), seeds[lo[i]], balanced, nullptr);
+      } else
+        t = binary_tree_clustering(algo, pl, lperm, cluster_size, balanced);
+      std::vector<int> gperm(m);
+      for (std::size_t j=0; j<m; j++)
+        gperm[j] = perm[lo[i]+lperm[j]-1];
+      std::copy(gperm.begin(), gperm.end(), perm.begin()+lo[i]);
+      sub[i] = t.serialize();
+    }
+    for (std::size_t i=0; i<nl; i++) {
+      auto m = lo[i+1] - lo[i];
+      std::size_t ssize = sub[i].size();
+      c.broadcast_from(ssize, owner[i]);
+      sub[i].resize(ssize);
+      c.broadcast_from(sub[i], owner[i]);
+      c.broadcast_from(perm.data()+lo[i], m, owner[i]);
+      c.broadcast_from(p.ptr(0, lo[i]), d*m, owner[i]);
+      *leafs[i] = structured::ClusterTree::deserialize(sub[i]);
+    }
+    return tree;
+  }
+#endif
 
 } // end namespace strumpack
 
@@ -0,0 +1,202 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*!
+ * \file ClusteringExtra.hpp
+ * \brief Parallel helper routines shared by the clustering codes.
+ */
+#ifndef STRUMPACK_CLUSTERING_EXTRA_HPP
+#define STRUMPACK_CLUSTERING_EXTRA_HPP
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include "StrumpackParameters.hpp"
+#include "dense/DenseMatrix.hpp"
+#include "structured/ClusterTree.hpp"
+
+namespace strumpack {
+
+  /**
+   * Number of columns per block in the parallel loops and
+   * reductions over the data points.
+   */
+  constexpr std::size_t clustering_block_size = 4096;
+
+  inline std::size_t column_blocks(std::size_t n) {
+    return (n + clustering_block_size - 1) / clustering_block_size;
+  }
+
+  /**
+   * Apply f(b, lo, hi) to the blocks b of columns [lo, hi) of [0,
+   * n). The blocks are processed with an OpenMP taskloop at the top
+   * levels of the clustering recursion. The block size is fixed, so
+   * reductions over the blocks do not depend on the number of
+   * threads.
+   */
+  template<typename F> void for_column_blocks
+  (std::size_t n, int depth, const F& f) {
+    const std::size_t B = clustering_block_size, nb = column_blocks(n);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(1)       \
+  if(nb > 1 && depth < params::task_recursion_cutoff_level)
+#endif
+    for (std::size_t b=0; b<nb; b++)
+      f(b, b*B, std::min(n, (b+1)*B));
+  }
+
+  /**
+   * Compute the centroid of the columns of p, as a parallel
+   * (blocked) reduction.
+   */
+  template<typename scalar_t> std::vector<scalar_t>
+  centroid(const DenseMatrix<scalar_t>& p, int depth) {
+    const auto d = p.rows();
+    const auto n = p.cols();
+    DenseMatrix<scalar_t> sums(d, column_blocks(n));
+    sums.zero();
+    for_column_blocks
+      (n, depth, [&](std::size_t b, std::size_t lo, std::size_t hi) {
+        for (std::size_t i=lo; i<hi; i++)
+          for (std::size_t j=0; j<d; j++)
+            sums(j, b) += p(j, i);
+      });
+    std::vector<scalar_t> c(d);
+    for (std::size_t b=0; b<sums.cols(); b++)
+      for (std::size_t j=0; j<d; j++)
+        c[j] += sums(j, b);
+    for (std::size_t j=0; j<d; j++)
+      c[j] /= n;
+    return c;
+  }
+
+  /**
+   * Find the column of p for which dist(column) is maximal, as a
+   * parallel (blocked) reduction. Ties go to the smallest index.
+   */
+  template<typename real_t, typename F> std::size_t
+  arg_max_column(std::size_t n, int depth, const F& dist) {
+    std::vector<std::pair<real_t,std::size_t>> mb
+      (column_blocks(n), {real_t(-1), 0});
+    for_column_blocks
+      (n, depth, [&](std::size_t b, std::size_t lo, std::size_t hi) {
+        for (std::size_t i=lo; i<hi; i++) {
+          real_t dd = dist(i);
+          if (dd > mb[b].first) mb[b] = {dd, i};
+        }
+      });
+    std::pair<real_t,std::size_t> m(real_t(-1), 0);
+    for (auto& b : mb)
+      if (b.first > m.first) m = b;
+    return m.second;
+  }
+
+  /**
+   * Permute the columns of p (and perm) such that all columns with
+   * cluster[i] == 0 come first, followed by those with cluster[i] ==
+   * 1. nc0 is the number of columns with cluster[i] == 0. This is
+   * done in-place: the columns which are in the wrong part are
+   * paired up and swapped, in parallel.
+   */
+  template<typename scalar_t, typename cluster_t> void partition_columns
+  (DenseMatrix<scalar_t>& p, std::vector<cluster_t>& cluster,
+   std::size_t nc0, int* perm, int depth) {
+    const auto d = p.rows();
+    const auto n = p.cols();
+    std::vector<std::size_t> w0, w1;
+    for (std::size_t i=0; i<nc0; i++)
+      if (cluster[i] != 0) w1.push_back(i);
+    for (std::size_t i=nc0; i<n; i++)
+      if (cluster[i] == 0) w0.push_back(i);
+    assert(w0.size() == w1.size());
+    for_column_blocks
+      (w0.size(), depth, [&](std::size_t, std::size_t lo, std::size_t hi) {
+        for (std::size_t k=lo; k<hi; k++) {
+          auto i = w1[k], j = w0[k];
+          blas::swap(d, p.ptr(0, i), 1, p.ptr(0, j), 1);
+          std::swap(perm[i], perm[j]);
+          std::swap(cluster[i], cluster[j]);
+        }
+      });
+  }
+
+  /**
+   * Split the columns of p in two halves, of size n/2 and n-n/2,
+   * according to the median of the values v(i), and permute p and
+   * perm accordingly.
+   */
+  template<typename scalar_t, typename F> void median_split
+  (DenseMatrix<scalar_t>& p, std::vector<std::size_t>& nc,
+   int* perm, int depth, const F& v) {
+    const auto n = p.cols();
+    std::vector<std::size_t> idx(n);
+    std::iota(idx.begin(), idx.end(), 0);
+    std::nth_element
+      (idx.begin(), idx.begin() + n/2, idx.end(),
+       [&](const std::size_t& a, const std::size_t& b) {
+         return v(a) < v(b);
+       });
+    nc.resize(2);
+    nc[0] = n/2;
+    nc[1] = n - n/2;
+    std::vector<char> cluster(n);
+    for (std::size_t i=n/2; i<n; i++)
+      cluster[idx[i]] = 1;
+    partition_columns(p, cluster, nc[0], perm, depth);
+  }
+
+  /**
+   * Recursively apply the partitioning split(p, nc, perm, depth) to
+   * build a cluster tree. The two subtrees are constructed in
+   * parallel, using OpenMP tasks.
+   */
+  template<typename scalar_t, typename F> structured::ClusterTree
+  recursive_split(DenseMatrix<scalar_t>& p, std::size_t cluster_size,
+                  int* perm, int depth, const F& split) {
+    const auto n = p.cols();
+    structured::ClusterTree tree(n);
+    if (n < cluster_size) return tree;
+    std::vector<std::size_t> nc(2);
+    split(p, nc, perm, depth);
+    if (!nc[0] || !nc[1]) return tree;
+    tree.c.resize(2);
+    DenseMatrixWrapper<scalar_t> p0(p.rows(), nc[0], p, 0, 0),
+      p1(p.rows(), nc[1], p, 0, nc[0]);
+    bool tasked = depth < params::task_recursion_cutoff_level;
+#pragma omp task default(shared) if(tasked) final(!tasked) mergeable
+    tree.c[0] = recursive_split(p0, cluster_size, perm, depth+1, split);
+#pragma omp task default(shared) if(tasked) final(!tasked) mergeable
+    tree.c[1] = recursive_split(p1, cluster_size, perm+nc[0], depth+1, split);
+#pragma omp taskwait
+    return tree;
+  }
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_CLUSTERING_EXTRA_HPP
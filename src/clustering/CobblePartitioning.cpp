@@ -29,95 +29,61 @@
 #include <algorithm>
 
 #include "Clustering.hpp"
+#include "ClusteringExtra.hpp"
 #include "kernel/Metrics.hpp"
 
 namespace strumpack {
 
   template<typename scalar_t> void cobble_partition
-  (DenseMatrix<scalar_t>& p, std::vector<std::size_t>& nc, int* perm) {
+  (DenseMatrix<scalar_t>& p, std::vector<std::size_t>& nc, int* perm,
+   int depth) {
     using real_t = scalar_t;
     auto d = p.rows();
     auto n = p.cols();
     // find centroid
-    std::vector<scalar_t> centroid(d);
-    for (std::size_t i=0; i<n; i++)
-      for (std::size_t j=0; j<d; j++)
-        centroid[j] += p(j, i);
-    for (std::size_t j=0; j<d; j++)
-      centroid[j] /= n;
+    auto c = centroid(p, depth);
 
     // find farthest point from centroid
-    std::size_t first_index = 0;
-    real_t max_dist(-1);
-    for (std::size_t i=0; i<n; i++) {
-      auto dd = Euclidean_distance(d, p.ptr(0, i), centroid.data());
-      if (dd > max_dist) {
-        max_dist = dd;
-        first_index = i;
-      }
-    }
+    auto first_index = arg_max_column<real_t>
+      (n, depth, [&](std::size_t i) {
+        return Euclidean_distance(d, p.ptr(0, i), c.data()); });
 
-    // compute and sort distance from the firsth point
+    // compute distance from the first point
     std::vector<real_t> dists(n);
-    for (std::size_t i=0; i<n; i++)
-      dists[i] = Euclidean_distance(d, p.ptr(0, i), p.ptr(0, first_index));
-
-    std::vector<std::size_t> idx(n);
-    std::iota(idx.begin(), idx.end(), 0);
-    std::nth_element
-      (idx.begin(), idx.begin() + n/2, idx.end(),
-       [&](const std::size_t& a, const std::size_t& b) {
-        return dists[a] < dists[b];
+    for_column_blocks
+      (n, depth, [&](std::size_t, std::size_t lo, std::size_t hi) {
+        for (std::size_t i=lo; i<hi; i++)
+          dists[i] = Euclidean_distance
+            (d, p.ptr(0, i), p.ptr(0, first_index));
       });
 
-    // split the data
-    nc[0] = n/2;
-    nc[1] = n - n/2;
-    std::vector<int> cluster(n);
-    for (std::size_t i=0; i<n/2; i++)
-      cluster[idx[i]] = 0;
-    for (std::size_t i=n/2; i<n; i++)
-      cluster[idx[i]] = 1;
-
-    // permute the data
-    std::size_t ct = 0;
-    for (std::size_t j=0, cj=ct; j<nc[0]; j++) {
-      while (cluster[cj] != 0) cj++;
-      if (cj != ct) {
-        blas::swap(d, p.ptr(0,cj), 1, p.ptr(0,ct), 1);
-        std::swap(perm[cj], perm[ct]);
-        cluster[cj] = cluster[ct];
-        cluster[ct] = 0;
-      }
-      cj++;
-      ct++;
-    }
+    // split the data at the median distance
+    median_split
+      (p, nc, perm, depth, [&](std::size_t i) { return dists[i]; });
   }
 
   template<typename scalar_t> structured::ClusterTree recursive_cobble
   (DenseMatrix<scalar_t>& p, std::size_t cluster_size, int* perm) {
-    auto n = p.cols();
-    structured::ClusterTree tree(n);
-    if (n < cluster_size) return tree;
-    std::vector<std::size_t> nc(2);
-    cobble_partition(p, nc, perm);
-    if (!nc[0] || !nc[1]) return tree;
-    tree.c.resize(2);
-    tree.c[0].size = nc[0];
-    tree.c[1].size = nc[1];
-    DenseMatrixWrapper<scalar_t> p0(p.rows(), nc[0], p, 0, 0);
-    tree.c[0] = recursive_cobble(p0, cluster_size, perm);
-    DenseMatrixWrapper<scalar_t> p1(p.rows(), nc[1], p, 0, nc[0]);
-    tree.c[1] = recursive_cobble(p1, cluster_size, perm+nc[0]);
+    structured::ClusterTree tree;
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+    tree = recursive_split
+      (p, cluster_size, perm, 0,
+       [&](DenseMatrix<scalar_t>& x, std::vector<std::size_t>& nc,
+           int* xperm, int depth) {
+        cobble_partition(x, nc, xperm, depth);
+      });
     return tree;
   }
 
 
   // explicit template instantiation (only for real types!)
   template void cobble_partition
-  (DenseMatrix<float>& p, std::vector<std::size_t>& nc, int* perm);
+  (DenseMatrix<float>& p, std::vector<std::size_t>& nc, int* perm,
+   int depth);
   template void cobble_partition
-  (DenseMatrix<double>& p, std::vector<std::size_t>& nc, int* perm);
+  (DenseMatrix<double>& p, std::vector<std::size_t>& nc, int* perm,
+   int depth);
 
   template structured::ClusterTree
   recursive_cobble(DenseMatrix<float>& p, std::size_t cluster_size,
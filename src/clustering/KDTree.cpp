@@ -29,112 +29,58 @@
 #include <algorithm>
 
 #include "Clustering.hpp"
+#include "ClusteringExtra.hpp"
 
 namespace strumpack {
 
   template<typename scalar_t> void kd_partition
   (DenseMatrix<scalar_t>& p, std::vector<std::size_t>& nc,
-   std::size_t cluster_size, int* perm) {
+   std::size_t cluster_size, int* perm, int depth) {
     auto n = p.cols();
     auto d = p.rows();
     // find coordinate of the most spread
-    std::vector<scalar_t> maxs(d), mins(d);
-    for (std::size_t j=0; j<d; ++j)
-      maxs[j] = mins[j] = p(j, 0);
-    for (std::size_t i=1; i<n; ++i)
+    DenseMatrix<scalar_t> maxs(d, column_blocks(n)), mins(d, column_blocks(n));
+    for_column_blocks
+      (n, depth, [&](std::size_t b, std::size_t lo, std::size_t hi) {
+        for (std::size_t j=0; j<d; ++j)
+          maxs(j, b) = mins(j, b) = p(j, lo);
+        for (std::size_t i=lo+1; i<hi; ++i)
+          for (std::size_t j=0; j<d; ++j) {
+            maxs(j, b) = std::max(p(j, i), maxs(j, b));
+            mins(j, b) = std::min(p(j, i), mins(j, b));
+          }
+      });
+    for (std::size_t b=1; b<maxs.cols(); ++b)
       for (std::size_t j=0; j<d; ++j) {
-        maxs[j] = std::max(p(j, i), maxs[j]);
-        mins[j] = std::min(p(j, i), mins[j]);
+        maxs(j, 0) = std::max(maxs(j, b), maxs(j, 0));
+        mins(j, 0) = std::min(mins(j, b), mins(j, 0));
       }
-    scalar_t max_var = maxs[0] - mins[0];
+    scalar_t max_var = maxs(0, 0) - mins(0, 0);
     std::size_t dim = 0;
     for (std::size_t j=1; j<d; ++j) {
-      auto t = maxs[j] - mins[j];
+      auto t = maxs(j, 0) - mins(j, 0);
       if (t > max_var) {
         max_var = t;
         dim = j;
       }
     }
-
-    std::vector<int> cluster(n);
-    nc.resize(2);
-    nc[0] = nc[1] = 0;
-
-#if 0 // mean
-    // find the mean
-    scalar_t mean_value(0.);
-    for (std::size_t i=0; i<n; ++i)
-      mean_value += p(dim, i);
-    mean_value /= n;
-    // split the data
-    for (std::size_t i=0; i<n; ++i)
-      if (p(dim, i) > mean_value) {
-        cluster[i] = 1;
-        nc[1]++;
-      } else nc[0]++;
-    // if clusters are too disbalanced, assign trivial clusters
-    if ((nc[0] < cluster_size && nc[1] > 100 * cluster_size) ||
-        (nc[1] < cluster_size && nc[0] > 100 * cluster_size)) {
-      // TODO should we still sort the data??
-      nc[0] = nc[1] = 0;
-      for (std::size_t i=0; i<n; i++) {
-        if (i <= n / 2) {
-          cluster[i] = 0;
-          nc[0]++;
-        } else {
-          cluster[i] = 1;
-          nc[1]++;
-        }
-      }
-    }
-#else // median
-    std::vector<std::size_t> idx(n);
-    std::iota(idx.begin(), idx.end(), 0);
-    std::nth_element
-      (idx.begin(), idx.begin() + n/2, idx.end(),
-       [&](const std::size_t& a, const std::size_t& b) {
-         return p(dim, a) < p(dim, b);
-       });
-    // split the data
-    nc[0] = n/2;
-    nc[1] = n - n/2;
-    for (std::size_t i=0; i<n/2; i++)
-      cluster[idx[i]] = 0;
-    for (std::size_t i=n/2; i<n; i++)
-      cluster[idx[i]] = 1;
-#endif
-
-    // permute the data
-    std::size_t ct = 0;
-    for (std::size_t j=0, cj=ct; j<nc[0]; j++) {
-      while (cluster[cj] != 0) cj++;
-      if (cj != ct) {
-        blas::swap(d, p.ptr(0,cj), 1, p.ptr(0,ct), 1);
-        std::swap(perm[cj], perm[ct]);
-        cluster[cj] = cluster[ct];
-        cluster[ct] = 0;
-      }
-      cj++;
-      ct++;
-    }
+    // split the data at the median
+    median_split
+      (p, nc, perm, depth, [&](std::size_t i) { return p(dim, i); });
   }
 
 
   template<typename scalar_t> structured::ClusterTree recursive_kd
   (DenseMatrix<scalar_t>& p, std::size_t cluster_size, int* perm) {
-    auto n = p.cols();
-    structured::ClusterTree tree(n);
-    if (n < cluster_size) return tree;
-    std::vector<std::size_t> nc(2);
-    kd_partition(p, nc, cluster_size, perm);
-    if (!nc[0] || !nc[1]) return tree;
-    tree.c.resize(2);
-    tree.c[0].size = nc[0];
-    tree.c[1].size = nc[1];
-    DenseMatrixWrapper<scalar_t> p0(p.rows(), nc[0], p, 0, 0);
-    tree.c[0] = recursive_kd(p0, cluster_size, perm);
-    DenseMatrixWrapper<scalar_t> p1(p.rows(), nc[1], p, 0, nc[0]);
-    tree.c[1] = recursive_kd(p1, cluster_size, perm+nc[0]);
+    structured::ClusterTree tree;
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+    tree = recursive_split
+      (p, cluster_size, perm, 0,
+       [&](DenseMatrix<scalar_t>& x, std::vector<std::size_t>& nc,
+           int* xperm, int depth) {
+        kd_partition(x, nc, cluster_size, xperm, depth);
+      });
     return tree;
   }
 
@@ -27,6 +27,7 @@
  *
  */
 #include "Clustering.hpp"
+#include "ClusteringExtra.hpp"
 #include "kernel/Metrics.hpp"
 
 namespace strumpack {
@@ -43,7 +44,7 @@ namespace strumpack {
   /** only works for k == 2 */
   template<typename scalar_t>
   std::vector<std::size_t> kmeans_start_random_dist_maximized
-  (const DenseMatrix<scalar_t>& p, std::mt19937& generator) {
+  (const DenseMatrix<scalar_t>& p, std::mt19937& generator, int depth) {
     constexpr std::size_t k = 2;
     const auto n = p.cols();
     const auto d = p.rows();
@@ -51,8 +52,11 @@ namespace strumpack {
     const auto t = uniform_random(generator);
     // compute probabilities
     std::vector<scalar_t> cur_dist(n);
-    for (std::size_t i=0; i<n; i++)
-      cur_dist[i] = Euclidean_distance_squared(d, &p(0, i), &p(0, t));
+    for_column_blocks
+      (n, depth, [&](std::size_t, std::size_t lo, std::size_t hi) {
+        for (std::size_t i=lo; i<hi; i++)
+          cur_dist[i] = Euclidean_distance_squared(d, &p(0, i), &p(0, t));
+      });
     std::discrete_distribution<int> random_center
       (cur_dist.begin(), cur_dist.end());
     std::vector<std::size_t> ind_centers(k);
@@ -112,11 +116,17 @@ namespace strumpack {
   }
 
 
+  /**
+   * only works for k == 2. If balanced is true, the final split is
+   * made at the median of the difference in distance to the two
+   * cluster centers, so that both clusters have (about) the same
+   * size.
+   */
   template<typename scalar_t,
            typename real_t=typename RealType<scalar_t>::value_type>
   void k_means
   (int k, DenseMatrix<scalar_t>& p, std::vector<std::size_t>& nc,
-   int* perm, std::mt19937& generator) {
+   int* perm, std::mt19937& generator, bool balanced, int depth) {
     const auto d = p.rows();
     const auto n = p.cols();
     DenseMatrix<scalar_t> center(d, k);
@@ -126,8 +136,8 @@ namespace strumpack {
     constexpr int kmeans_options = 2;
     switch (kmeans_options) {
     case 1: ind_centers = kmeans_start_random(n, k, generator); break;
-    case 2: ind_centers = kmeans_start_random_dist_maximized(p, generator);
-      break;
+    case 2: ind_centers = kmeans_start_random_dist_maximized
+        (p, generator, depth); break;
     case 3: ind_centers = kmeans_start_dist_maximized(p); break;
     case 4: ind_centers = kmeans_start_fixed(p); break;
     }
@@ -137,81 +147,125 @@ namespace strumpack {
     int iter = 0;
     bool changes = true;
     std::vector<int> cluster(n);
+    const auto nb = column_blocks(n);
+    DenseMatrix<scalar_t> sums(d*k, nb);
+    std::vector<std::size_t> ncb(k*nb);
+    std::vector<char> changed(nb);
     while ((changes == true) && (iter < kmeans_max_it)) {
-      // for each point, find the closest cluster center
-      changes = false;
-      for (std::size_t i=0; i<n; i++) {
-        auto min_dist = Euclidean_distance(d, &p(0, i), &center(0, 0));
-        int ci = 0;
-        for (int c=1; c<k; c++) {
-          auto dd = Euclidean_distance(d, &p(0, i), &center(0, c));
-          if (dd < min_dist) {
-            min_dist = dd;
-            ci = c;
+      // for each point, find the closest cluster center, and
+      // accumulate the new cluster centers per block of points
+      sums.zero();
+      std::fill(ncb.begin(), ncb.end(), 0);
+      std::fill(changed.begin(), changed.end(), 0);
+      for_column_blocks
+        (n, depth, [&](std::size_t b, std::size_t lo, std::size_t hi) {
+          for (std::size_t i=lo; i<hi; i++) {
+            auto min_dist = Euclidean_distance(d, &p(0, i), &center(0, 0));
+            int ci = 0;
+            for (int c=1; c<k; c++) {
+              auto dd = Euclidean_distance(d, &p(0, i), &center(0, c));
+              if (dd < min_dist) {
+                min_dist = dd;
+                ci = c;
+              }
+            }
+            if (ci != cluster[i]) changed[b] = 1;
+            cluster[i] = ci;
+            ncb[ci+b*k]++;
+            for (std::size_t j=0; j<d; j++)
+              sums(j+ci*d, b) += p(j, i);
           }
-        }
-        if (ci != cluster[i]) changes = true;
-        cluster[i] = ci;
-      }
+        });
+      changes = std::any_of
+        (changed.begin(), changed.end(), [](char c) { return c; });
       std::fill(nc.begin(), nc.end(), 0);
       center.zero();
-      for (std::size_t i=0; i<n; i++) {
-        auto c = cluster[i];
-        nc[c]++;
-        for (std::size_t j=0; j<d; j++)
-          center(j, c) += p(j, i);
-      }
+      for (std::size_t b=0; b<nb; b++)
+        for (int c=0; c<k; c++) {
+          nc[c] += ncb[c+b*k];
+          for (std::size_t j=0; j<d; j++)
+            center(j, c) += sums(j+c*d, b);
+        }
       for (int c=0; c<k; c++)
         for (std::size_t j=0; j<d; j++)
           center(j, c) /= nc[c];
       iter++;
     }
     // permute the data
-    std::size_t ct = 0;
-    for (int c=0; c<k-1; c++)
-      for (std::size_t j=0, cj=ct; j<nc[c]; j++) {
-        while (cluster[cj] != c) cj++;
-        if (cj != ct) {
-          blas::swap(d, p.ptr(0,cj), 1, p.ptr(0,ct), 1);
-          std::swap(perm[cj], perm[ct]);
-          cluster[cj] = cluster[ct];
-          cluster[ct] = c;
-        }
-        cj++;
-        ct++;
-      }
+    if (balanced)
+      median_split
+        (p, nc, perm, depth, [&](std::size_t i) {
+          return Euclidean_distance(d, &p(0, i), &center(0, 0)) -
+            Euclidean_distance(d, &p(0, i), &center(0, 1)); });
+    else partition_columns(p, cluster, nc[0], perm, depth);
   }
 
 
-  template<typename scalar_t>
-  structured::ClusterTree recursive_2_means
-  (DenseMatrix<scalar_t>& p, std::size_t cluster_size,
-   int* perm, std::mt19937& generator) {
+  template<typename scalar_t> structured::ClusterTree recursive_2_means
+  (DenseMatrix<scalar_t>& p, std::size_t cluster_size, int* perm,
+   std::uint32_t seed, bool balanced, std::uint32_t* leaf_seeds,
+   int depth) {
     const auto n = p.cols();
     structured::ClusterTree tree(n);
+    // overwritten by the children, if this is not a leaf
+    if (leaf_seeds) leaf_seeds[0] = seed;
     if (n < cluster_size) return tree;
+    std::mt19937 generator(seed);
     std::vector<std::size_t> nc(2);
-    k_means(2, p, nc, perm, generator);
+    k_means(2, p, nc, perm, generator, balanced, depth);
     if (!nc[0] || !nc[1]) return tree;
     tree.c.resize(2);
-    tree.c[0].size = nc[0];
-    tree.c[1].size = nc[1];
-    // TODO threading
-    DenseMatrixWrapper<scalar_t> p0(p.rows(), nc[0], p, 0, 0);
-    tree.c[0] = recursive_2_means(p0, cluster_size, perm, generator);
-    DenseMatrixWrapper<scalar_t> p1(p.rows(), nc[1], p, 0, nc[0]);
-    tree.c[1] = recursive_2_means(p1, cluster_size, perm+nc[0], generator);
+    // each subtree gets its own generator, seeded from the parent's
+    // generator, so the result does not depend on the task schedule
+    std::uint32_t s0 = generator(), s1 = generator();
+    DenseMatrixWrapper<scalar_t> p0(p.rows(), nc[0], p, 0, 0),
+      p1(p.rows(), nc[1], p, 0, nc[0]);
+    bool tasked = depth < params::task_recursion_cutoff_level;
+#pragma omp task default(shared) if(tasked) final(!tasked) mergeable
+    tree.c[0] = recursive_2_means
+      (p0, cluster_size, perm, s0, balanced, leaf_seeds, depth+1);
+#pragma omp task default(shared) if(tasked) final(!tasked) mergeable
+    tree.c[1] = recursive_2_means
+      (p1, cluster_size, perm+nc[0], s1, balanced,
+       leaf_seeds ? leaf_seeds+nc[0] : nullptr, depth+1);
+#pragma omp taskwait
     return tree;
   }
 
+  template<typename scalar_t> structured::ClusterTree recursive_2_means
+  (DenseMatrix<scalar_t>& p, std::size_t cluster_size, int* perm,
+   std::uint32_t seed, bool balanced, std::uint32_t* leaf_seeds) {
+    structured::ClusterTree tree;
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+    tree = recursive_2_means
+      (p, cluster_size, perm, seed, balanced, leaf_seeds, 0);
+    return tree;
+  }
+
+  template<typename scalar_t> structured::ClusterTree recursive_2_means
+  (DenseMatrix<scalar_t>& p, std::size_t cluster_size,
+   int* perm, std::mt19937& generator, bool balanced) {
+    return recursive_2_means
+      (p, cluster_size, perm, std::uint32_t(generator()), balanced,
+       nullptr);
+  }
+
 
   // explicit template instantiations (only for real types!)
   template structured::ClusterTree
   recursive_2_means(DenseMatrix<float>& p, std::size_t cluster_size,
-                    int* perm, std::mt19937& generator);
+                    int* perm, std::mt19937& generator, bool balanced);
   template structured::ClusterTree
   recursive_2_means(DenseMatrix<double>& p, std::size_t cluster_size,
-                    int* perm, std::mt19937& generator);
+                    int* perm, std::mt19937& generator, bool balanced);
+  template structured::ClusterTree
+  recursive_2_means(DenseMatrix<float>& p, std::size_t cluster_size,
+                    int* perm, std::uint32_t seed, bool balanced,
+                    std::uint32_t* leaf_seeds);
+  template structured::ClusterTree
+  recursive_2_means(DenseMatrix<double>& p, std::size_t cluster_size,
+                    int* perm, std::uint32_t seed, bool balanced,
+                    std::uint32_t* leaf_seeds);
 
 } // end namespace strumpack
-
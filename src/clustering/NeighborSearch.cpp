@@ -33,6 +33,7 @@
 #include <numeric>
 #include <random>
 #include <chrono>
+#include <functional>
 
 #include "NeighborSearch.hpp"
 #include "kernel/Metrics.hpp"
@@ -41,42 +42,100 @@ namespace strumpack {
 
   //--------------DISTANCE MATRIX------------------
   // finds distances between all data points with indices from
-  // index_subset
+  // index_subset. The points are gathered and centered (which
+  // reduces cancellation), and then the distances are computed as
+  // ||x_i||^2 + ||x_j||^2 - 2 x_i^T x_j, using a single GEMM.
   template<typename real_t, typename int_t>
   DenseMatrix<real_t> find_distance_matrix
   (const DenseMatrix<real_t>& data,
    const std::vector<int_t>& index_subset) {
-    auto subset_size = index_subset.size();
-    DenseMatrix<real_t> distances(subset_size, subset_size);
-    auto d = data.rows();
-    for (std::size_t i=0; i<subset_size; i++) {
-      distances(i, i) = real_t(0);
-      for (std::size_t j=i+1; j<subset_size; j++) {
-        distances(j, i) = Euclidean_distance_squared
-          (d, &data(0, index_subset[i]), &data(0, index_subset[j]));
-        distances(i, j) = distances(j, i);
+    std::size_t s = index_subset.size(), d = data.rows();
+    DenseMatrix<real_t> X(d, s), distances(s, s);
+    std::vector<real_t> center(d, real_t(0)), nrm(s, real_t(0));
+    for (std::size_t j=0; j<s; j++)
+      for (std::size_t k=0; k<d; k++)
+        center[k] += data(k, index_subset[j]);
+    for (std::size_t k=0; k<d; k++)
+      center[k] /= s;
+    for (std::size_t j=0; j<s; j++)
+      for (std::size_t k=0; k<d; k++) {
+        X(k, j) = data(k, index_subset[j]) - center[k];
+        nrm[j] += X(k, j) * X(k, j);
       }
+    blas::gemm('T', 'N', s, s, d, real_t(-2.), X.data(), X.ld(),
+               X.data(), X.ld(), real_t(0.), distances.data(),
+               distances.ld());
+    for (std::size_t j=0; j<s; j++) {
+      for (std::size_t i=0; i<s; i++)
+        distances(i, j) = std::max
+          (real_t(0), distances(i, j) + nrm[i] + nrm[j]);
+      distances(j, j) = real_t(0);
     }
     return distances;
   }
 
-  // finds distances between all data points with indices from
-  // index_subset to all points in the data set
+  // finds distances between all points in the data set and the
+  // points with indices from index_subset, returns an n x
+  // index_subset.size() matrix, also computed with a GEMM
   template<typename real_t, typename int_t>
   DenseMatrix<real_t> find_distance_matrix_from_subset
   (const DenseMatrix<real_t>& data,
    const std::vector<int_t>& index_subset) {
-    auto n = data.cols();
-    auto d = data.rows();
-    auto subset_size = index_subset.size();
-    DenseMatrix<real_t> distances(subset_size, n);
-    for (std::size_t j=0; j<n; j++)
-      for (std::size_t i=0; i<subset_size; i++)
-        distances(i, j) = Euclidean_distance_squared
-          (d, &data(0, index_subset[i]), &data(0, j));
+    std::size_t n = data.cols(), d = data.rows(),
+      s = index_subset.size();
+    DenseMatrix<real_t> S(d, s), distances(n, s);
+    std::vector<real_t> nrm(n), snrm(s);
+    for (std::size_t j=0; j<s; j++) {
+      for (std::size_t k=0; k<d; k++)
+        S(k, j) = data(k, index_subset[j]);
+      snrm[j] = blas::dotc(d, S.ptr(0, j), 1, S.ptr(0, j), 1);
+    }
+#pragma omp parallel for
+    for (std::size_t i=0; i<n; i++)
+      nrm[i] = blas::dotc(d, &data(0, i), 1, &data(0, i), 1);
+    gemm(Trans::C, Trans::N, real_t(-2.), data, S,
+         real_t(0.), distances);
+#pragma omp parallel for
+    for (std::size_t j=0; j<s; j++) {
+      for (std::size_t i=0; i<n; i++)
+        distances(i, j) = std::max
+          (real_t(0), distances(i, j) + nrm[i] + snrm[j]);
+      distances(index_subset[j], j) = real_t(0);
+    }
     return distances;
   }
 
+  // select the k smallest entries from dist[0..m), using a bounded
+  // max-heap. The distances from the GEMM are only used for the
+  // selection, the selected ones are recomputed exactly as
+  // dist(x, data(:,idx[j])), and sorted by (distance, index). This
+  // makes the scores independent of the GEMM rounding, which is
+  // required to detect duplicates when merging candidates.
+  template<typename real_t, typename int_t> void select_k_smallest
+  (std::size_t m, const real_t* dist, std::size_t k,
+   const DenseMatrix<real_t>& data, const real_t* x,
+   const std::function<int_t(std::size_t)>& idx,
+   std::vector<std::pair<real_t,int_t>>& heap) {
+    heap.clear();
+    for (std::size_t j=0; j<m; j++) {
+      std::pair<real_t,int_t> p(dist[j], int_t(j));
+      if (heap.size() < k) {
+        heap.push_back(p);
+        std::push_heap(heap.begin(), heap.end());
+      } else if (p < heap.front()) {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = p;
+        std::push_heap(heap.begin(), heap.end());
+      }
+    }
+    auto d = data.rows();
+    for (auto& h : heap) {
+      h.second = idx(h.second);
+      h.first = Euclidean_distance_squared(d, x, &data(0, h.second));
+    }
+    std::sort(heap.begin(), heap.end());
+  }
+
   //-------FIND APPROXIMATE NEAREST NEIGHBORS FROM PROJECTION TREE---
 
   // 1. CONSTRUCT THE TREE
@@ -150,39 +209,42 @@ namespace strumpack {
 
   // 2. FIND CLOSEST POINTS INSIDE LEAVES
   // find ann_number exact neighbors for every point among the points
-  // within its leaf (in randomized projection tree)
+  // within its leaf (in randomized projection tree). Only the leaves
+  // leaf_offset, leaf_offset+leaf_stride, ... are handled, this is
+  // used to divide the leaves over MPI processes.
   template<typename real_t, typename int_t>
   void find_neighbors_in_tree
   (const DenseMatrix<real_t>& data, std::vector<std::size_t>& leaves,
    std::vector<std::size_t>& leaf_sizes, DenseMatrix<int_t>& neighbors,
-   DenseMatrix<real_t>& scores) {
+   DenseMatrix<real_t>& scores, std::size_t leaf_offset=0,
+   std::size_t leaf_stride=1) {
     auto ann_number = neighbors.rows();
-#pragma omp parallel for default(shared) schedule(dynamic)
-    for (std::size_t leaf=0; leaf<leaf_sizes.size()-1; leaf++) {
-      // initialize size and content of the current leaf
-      auto cur_leaf_size = leaf_sizes[leaf+1] - leaf_sizes[leaf];
-      // list of indices in the current leaf
-      std::vector<int_t> index_subset(cur_leaf_size, 0);
-      for (std::size_t i=0; i<index_subset.size(); i++)
-        index_subset[i] = leaves[leaf_sizes[leaf] + i];
-      auto leaf_dists = find_distance_matrix(data, index_subset);
-
-      // record ann_number closest points in each leaf to neighbors
-      std::vector<int_t> idx(cur_leaf_size);
-      for (std::size_t i=0; i<cur_leaf_size; i++) {
-        std::iota(idx.begin(), idx.end(), 0);
-        std::partial_sort
-          (idx.begin(), idx.begin()+ann_number, idx.end(),
-           [&](const int_t& i1, const int_t& i2) {
-             return (leaf_dists(i,i1) < leaf_dists(i,i2)) ||
-               ((leaf_dists(i,i1) == leaf_dists(i,i2)) && (i1 < i2)); });
-        // std::stable_sort
-        //   (idx.begin(), idx.end(),
-        //    [&](const int_t& i1, const int_t& i2) {
-        //      return leaf_dists(i,i1) < leaf_dists(i,i2); });
-        for (std::size_t j=0; j<ann_number; j++) {
-          neighbors(j, index_subset[i]) = leaves[leaf_sizes[leaf] + idx[j]];
-          scores(j, index_subset[i]) = leaf_dists(i, idx[j]);
+    auto nr_leaves = leaf_sizes.size()-1;
+#pragma omp parallel default(shared)
+    {
+      std::vector<std::pair<real_t,int_t>> heap;
+      heap.reserve(ann_number);
+#pragma omp for schedule(dynamic)
+      for (std::size_t leaf=leaf_offset; leaf<nr_leaves;
+           leaf+=leaf_stride) {
+        // initialize size and content of the current leaf
+        auto cur_leaf_size = leaf_sizes[leaf+1] - leaf_sizes[leaf];
+        // list of indices in the current leaf
+        std::vector<int_t> index_subset(cur_leaf_size, 0);
+        for (std::size_t i=0; i<index_subset.size(); i++)
+          index_subset[i] = leaves[leaf_sizes[leaf] + i];
+        auto leaf_dists = find_distance_matrix(data, index_subset);
+        // record ann_number closest points in each leaf to
+        // neighbors, leaf_dists is symmetric, so use column i
+        for (std::size_t i=0; i<cur_leaf_size; i++) {
+          select_k_smallest<real_t,int_t>
+            (cur_leaf_size, leaf_dists.ptr(0, i), ann_number, data,
+             &data(0, index_subset[i]),
+             [&](std::size_t j) { return index_subset[j]; }, heap);
+          for (std::size_t j=0; j<ann_number; j++) {
+            neighbors(j, index_subset[i]) = heap[j].second;
+            scores(j, index_subset[i]) = heap[j].first;
+          }
         }
       }
     }
@@ -192,7 +254,8 @@ namespace strumpack {
   template<typename real_t, typename int_t>
   void find_ann_candidates
   (const DenseMatrix<real_t>& data, DenseMatrix<int_t>& neighbors,
-   DenseMatrix<real_t>& scores, std::mt19937& generator) {
+   DenseMatrix<real_t>& scores, std::mt19937& generator,
+   std::size_t leaf_offset=0, std::size_t leaf_stride=1) {
     auto n = data.cols();
     auto ann_number = neighbors.rows();
     std::size_t min_leaf_size = 6 * ann_number;
@@ -207,7 +270,9 @@ namespace strumpack {
     construct_projection_tree
       (data, min_leaf_size, cur_indices, start,
        cur_node_size, leaves, leaf_sizes, generator);
-    find_neighbors_in_tree(data, leaves, leaf_sizes, neighbors, scores);
+    find_neighbors_in_tree
+      (data, leaves, leaf_sizes, neighbors, scores,
+       leaf_offset, leaf_stride);
   }
 
   //---------------CHOOSE BEST NEIGHBORS FROM TWO TREE SAMPLES----------------
@@ -263,46 +328,44 @@ namespace strumpack {
     auto n = data.cols();
     auto ann_number = neighbors.rows();
     auto sample_dists = find_distance_matrix_from_subset(data, samples);
-    // record ann_number closest points in each leaf to neighbors
-    std::vector<int_t> idx(n);
-    for (int_t i=0; i<samples.size(); i++) {
-      std::iota(idx.begin(), idx.end(), 0);
-      std::partial_sort
-        (idx.begin(), idx.begin()+ann_number, idx.end(),
-         [&](const int_t& i1, const int_t& i2) {
-           return (sample_dists(i, i1) < sample_dists(i, i2)) ||
-             ((sample_dists(i, i1) == sample_dists(i, i2)) && (i1 < i2)); });
-      // std::stable_sort
-      //   (idx.begin(), idx.end(),
-      //    [&](const int_t& i1, const int& i2) {
-      //      return sample_dists(i, i1) < sample_dists(i, i2); });
-      for (std::size_t j=0; j<ann_number; j++) {
-        neighbors(j, i) = idx[j];
-        scores(j, i) = sample_dists(i, idx[j]);
+#pragma omp parallel default(shared)
+    {
+      std::vector<std::pair<real_t,int_t>> heap;
+      heap.reserve(ann_number);
+#pragma omp for
+      for (std::size_t i=0; i<samples.size(); i++) {
+        select_k_smallest<real_t,int_t>
+          (n, sample_dists.ptr(0, i), ann_number, data,
+           &data(0, samples[i]), [](std::size_t j) { return j; }, heap);
+        for (std::size_t j=0; j<ann_number; j++) {
+          neighbors(j, i) = heap[j].second;
+          scores(j, i) = heap[j].first;
+        }
       }
     }
   }
 
-  // quality = average fraction of ann_number approximate neighbors
-  //  (neighbors), which are within the closest ann_number of true
-  //  neighbors (n_neighbors); average is taken over a subset
-  //  (nr_samples)
-  template<typename real_t, typename int_t> real_t check_quality
-  (const DenseMatrix<real_t>& data, const DenseMatrix<int_t>& neighbors,
-   std::mt19937& generator) {
-    auto n = data.cols();
-    auto ann_number = neighbors.rows();
+  inline std::vector<std::size_t> quality_samples
+  (std::size_t n, std::mt19937& generator) {
     std::size_t nr_samples = 100;
     std::vector<std::size_t> samples(nr_samples);
-    {
-      std::uniform_int_distribution<std::size_t> uni_int(0, n-1);
-      for (std::size_t i=0; i<samples.size(); i++)
-        samples[i] = uni_int(generator);
-    }
+    std::uniform_int_distribution<std::size_t> uni_int(0, n-1);
+    for (std::size_t i=0; i<samples.size(); i++)
+      samples[i] = uni_int(generator);
+    return samples;
+  }
+
+  // sum over samples of the fraction of ann_number approximate
+  //  neighbors (neighbors), which are within the closest ann_number
+  //  of true neighbors (n_neighbors)
+  template<typename real_t, typename int_t> real_t sum_quality
+  (const DenseMatrix<real_t>& data, const DenseMatrix<int_t>& neighbors,
+   const std::vector<std::size_t>& samples) {
+    auto ann_number = neighbors.rows();
+    auto nr_samples = samples.size();
+    if (!nr_samples) return real_t(0.);
     DenseMatrix<int_t> n_neighbors(ann_number, nr_samples);
     DenseMatrix<real_t> n_scores(ann_number, nr_samples);
-    n_neighbors.zero();
-    n_scores.zero();
     find_true_nn(data, samples, n_neighbors, n_scores);
     real_t ann_quality = 0.0;
     for (std::size_t j=0; j<nr_samples; j++) {
@@ -317,7 +380,18 @@ namespace strumpack {
         } else r2++;
       ann_quality += (real_t)num_nei_found / ann_number;
     }
-    return ann_quality / nr_samples;
+    return ann_quality;
+  }
+
+  // quality = average fraction of ann_number approximate neighbors
+  //  (neighbors), which are within the closest ann_number of true
+  //  neighbors (n_neighbors); average is taken over a subset
+  //  (nr_samples)
+  template<typename real_t, typename int_t> real_t check_quality
+  (const DenseMatrix<real_t>& data, const DenseMatrix<int_t>& neighbors,
+   std::mt19937& generator) {
+    auto samples = quality_samples(data.cols(), generator);
+    return sum_quality(data, neighbors, samples) / samples.size();
   }
 
   //------------ Main function call----------------
@@ -347,7 +421,61 @@ namespace strumpack {
               << " after " << iter << " iterations" << std::endl;
   }
 
+#if defined(STRUMPACK_USE_MPI)
+  template<typename real_t, typename int_t> void find_approximate_neighbors
+  (const MPIComm& c, const DenseMatrix<real_t>& data,
+   std::size_t num_iters, std::size_t ann_number,
+   DenseMatrix<int_t>& neighbors, DenseMatrix<real_t>& scores) {
+    auto n = data.cols();
+    auto rank = c.rank(), P = c.size();
+    neighbors.resize(ann_number, n);
+    scores.resize(ann_number, n);
+    // All processes use the same generator, so they construct the
+    // same projection trees. The leaves are distributed round-robin,
+    // every column is computed by exactly one process, and the
+    // candidates are exchanged with an all-reduce.
+    std::mt19937 generator(1); // reproducible
+    auto candidates =
+      [&](DenseMatrix<int_t>& nb, DenseMatrix<real_t>& sc) {
+        nb.zero();
+        sc.zero();
+        find_ann_candidates(data, nb, sc, generator, rank, P);
+        c.all_reduce(nb.data(), nb.rows()*nb.cols(), MPI_SUM);
+        c.all_reduce(sc.data(), sc.rows()*sc.cols(), MPI_SUM);
+      };
+    auto quality =
+      [&]() {
+        auto samples = quality_samples(n, generator);
+        auto nr_samples = samples.size();
+        std::vector<std::size_t> lsamples;
+        for (std::size_t i=rank; i<nr_samples; i+=P)
+          lsamples.push_back(samples[i]);
+        return c.all_reduce
+          (sum_quality(data, neighbors, lsamples), MPI_SUM) / nr_samples;
+      };
+    candidates(neighbors, scores);
+    real_t q = quality();
+    std::size_t iter = 0;
+    for (; iter<num_iters && q<0.99; iter++) {
+      DenseMatrix<int_t> new_neighbors(ann_number, n);
+      DenseMatrix<real_t> new_scores(ann_number, n);
+      candidates(new_neighbors, new_scores);
+      choose_best_neighbors(neighbors, scores, new_neighbors, new_scores);
+      q = quality();
+    }
+    if (c.is_root())
+      std::cout << "# ANN search quality = " << q
+                << " after " << iter << " iterations" << std::endl;
+  }
+#endif
+
   // explicit template instantiations
+  template void find_true_nn
+  (const DenseMatrix<float>& data, const std::vector<std::size_t>& samples,
+   DenseMatrix<unsigned int>& neighbors, DenseMatrix<float>& scores);
+  template void find_true_nn
+  (const DenseMatrix<double>& data, const std::vector<std::size_t>& samples,
+   DenseMatrix<unsigned int>& neighbors, DenseMatrix<double>& scores);
   template void find_approximate_neighbors
   (const DenseMatrix<float>& data, std::size_t num_iters,
    std::size_t ann_number, DenseMatrix<unsigned int>& neighbors,
@@ -357,4 +485,15 @@ namespace strumpack {
    std::size_t ann_number, DenseMatrix<unsigned int>& neighbors,
    DenseMatrix<double>& scores);
 
+#if defined(STRUMPACK_USE_MPI)
+  template void find_approximate_neighbors
+  (const MPIComm& c, const DenseMatrix<float>& data,
+   std::size_t num_iters, std::size_t ann_number,
+   DenseMatrix<unsigned int>& neighbors, DenseMatrix<float>& scores);
+  template void find_approximate_neighbors
+  (const MPIComm& c, const DenseMatrix<double>& data,
+   std::size_t num_iters, std::size_t ann_number,
+   DenseMatrix<unsigned int>& neighbors, DenseMatrix<double>& scores);
+#endif
+
 } // end namespace strumpack
@@ -29,7 +29,11 @@
 #ifndef NEIGHBOR_SEARCH_HPP
 #define NEIGHBOR_SEARCH_HPP
 
+#include "StrumpackConfig.hpp"
 #include "dense/DenseMatrix.hpp"
+#if defined(STRUMPACK_USE_MPI)
+#include "misc/MPIWrapper.hpp"
+#endif
 
 
 namespace strumpack {
@@ -40,6 +44,33 @@ namespace strumpack {
    std::size_t ann_number, DenseMatrix<int_t>& neighbors,
    DenseMatrix<real_t>& scores);
 
+  /**
+   * Find the exact ann_number = neighbors.rows() nearest neighbors
+   * of the points data(:,samples[i]), by brute force. Column i of
+   * neighbors and scores is set to the indices and the squared
+   * distances, sorted by distance. This is used to check the quality
+   * of find_approximate_neighbors.
+   */
+  template<typename real_t, typename int_t>
+  void find_true_nn
+  (const DenseMatrix<real_t>& data, const std::vector<std::size_t>& samples,
+   DenseMatrix<int_t>& neighbors, DenseMatrix<real_t>& scores);
+
+#if defined(STRUMPACK_USE_MPI)
+  /**
+   * Distributed version of find_approximate_neighbors. The data is
+   * replicated on all processes in c. The leaves of each random
+   * projection tree are divided over the processes, and the
+   * candidate neighbors are exchanged after each tree, so that on
+   * output all processes have the same neighbors and scores.
+   */
+  template<typename real_t, typename int_t>
+  void find_approximate_neighbors
+  (const MPIComm& c, const DenseMatrix<real_t>& data,
+   std::size_t num_iters, std::size_t ann_number,
+   DenseMatrix<int_t>& neighbors, DenseMatrix<real_t>& scores);
+#endif
+
 } // end namespace strumpack
 
 #endif // NEIGHBOR_SEARCH_HPP
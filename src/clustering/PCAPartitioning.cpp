@@ -29,19 +29,20 @@
 #include <algorithm>
 
 #include "Clustering.hpp"
+#include "ClusteringExtra.hpp"
 
 namespace strumpack {
 
   template<typename scalar_t> void pca_partition
   (DenseMatrix<scalar_t>& p, std::vector<std::size_t>& nc,
-   int* perm) {
+   int* perm, int depth) {
     auto n = p.cols();
     auto d = p.rows();
     // find first pca direction
     int num = 0;
     scalar_t lambda;
     DenseMatrix<scalar_t> Z(d, 1), ptp(d, d);
-    gemm(Trans::N, Trans::C, scalar_t(1.), p, p, scalar_t(0.), ptp);
+    gemm(Trans::N, Trans::C, scalar_t(1.), p, p, scalar_t(0.), ptp, depth);
     double abstol = 1e-5;
     blas::syevx('V', 'I', 'U', d, ptp.data(), d, scalar_t(1.),
                 scalar_t(1.), d, d, abstol, num, &lambda, Z.data(), d);
@@ -50,81 +51,36 @@ namespace strumpack {
                 << std::endl;
     // compute pca coordinates
     DenseMatrix<scalar_t> new_x_coord(n, 1);
-    gemv(Trans::C, scalar_t(1.), p, Z, scalar_t(0.), new_x_coord, 0);
-
-    std::vector<std::size_t> cluster(n);
-    nc.resize(2);
-    nc[0] = nc[1] = 0;
-
-#if 0 // mean
-    // find the mean
-    scalar_t mean_value(0.);
-    for (std::size_t i=0; i<n; ++i)
-      mean_value += new_x_coord[i];
-    mean_value /= n;
-    // split the data
-    for (std::size_t i=0; i<n; ++i)
-      if (p(dim, i) > mean_value) {
-        cluster[i] = 1;
-        nc[1]++;
-      } else nc[0]++;
-#else // median
-    std::vector<std::size_t> idx(n);
-    std::iota(idx.begin(), idx.end(), 0);
-    std::nth_element
-      (idx.begin(), idx.begin() + n/2, idx.end(),
-       [&](const std::size_t& a, const std::size_t& b) {
-         return new_x_coord(a, 0) < new_x_coord(b, 0);
-       });
-    // split the data
-    nc[0] = n/2;
-    nc[1] = n - n/2;
-    for (std::size_t i=0; i<n/2; i++)
-      cluster[idx[i]] = 0;
-    for (std::size_t i=n/2; i<n; i++)
-      cluster[idx[i]] = 1;
-#endif
-
-    // permute the data
-    std::size_t ct = 0;
-    for (std::size_t j=0, cj=ct; j<nc[0]; j++) {
-      while (cluster[cj] != 0) cj++;
-      if (cj != ct) {
-        blas::swap(d, p.ptr(0,cj), 1, p.ptr(0,ct), 1);
-        std::swap(perm[cj], perm[ct]);
-        cluster[cj] = cluster[ct];
-        cluster[ct] = 0;
-      }
-      cj++;
-      ct++;
-    }
+    gemv(Trans::C, scalar_t(1.), p, Z, scalar_t(0.), new_x_coord, depth);
+    // split the data at the median
+    median_split
+      (p, nc, perm, depth,
+       [&](std::size_t i) { return new_x_coord(i, 0); });
   }
 
 
   template<typename scalar_t> structured::ClusterTree recursive_pca
   (DenseMatrix<scalar_t>& p, std::size_t cluster_size, int* perm) {
-    auto n = p.cols();
-    structured::ClusterTree tree(n);
-    if (n < cluster_size) return tree;
-    std::vector<std::size_t> nc(2);
-    pca_partition(p, nc, perm);
-    if (!nc[0] || !nc[1]) return tree;
-    tree.c.resize(2);
-    tree.c[0].size = nc[0];
-    tree.c[1].size = nc[1];
-    DenseMatrixWrapper<scalar_t> p0(p.rows(), nc[0], p, 0, 0);
-    tree.c[0] = recursive_pca(p0, cluster_size, perm);
-    DenseMatrixWrapper<scalar_t> p1(p.rows(), nc[1], p, 0, nc[0]);
-    tree.c[1] = recursive_pca(p1, cluster_size, perm+nc[0]);
+    structured::ClusterTree tree;
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+    tree = recursive_split
+      (p, cluster_size, perm, 0,
+       [&](DenseMatrix<scalar_t>& x, std::vector<std::size_t>& nc,
+           int* xperm, int depth) {
+        pca_partition(x, nc, xperm, depth);
+      });
     return tree;
   }
 
 
   // explicit template instantiations (only for real types!)
   template void pca_partition
-  (DenseMatrix<float>& p, std::vector<std::size_t>& nc, int* perm);
+  (DenseMatrix<float>& p, std::vector<std::size_t>& nc, int* perm,
+   int depth);
   template void pca_partition
-  (DenseMatrix<double>& p, std::vector<std::size_t>& nc, int* perm);
+  (DenseMatrix<double>& p, std::vector<std::size_t>& nc, int* perm,
+   int depth);
 
   template structured::ClusterTree recursive_pca
   (DenseMatrix<float>& p, std::size_t cluster_size, int* perm);
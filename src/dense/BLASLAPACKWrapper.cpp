@@ -524,6 +524,20 @@ namespace strumpack {
         (char* jobu, char* jobvt, strumpack_blas_int* m, strumpack_blas_int* n, double* a, strumpack_blas_int* lda,
          double* s, double* u, strumpack_blas_int* ldu, double* vt, strumpack_blas_int* ldvt,
          double* work, strumpack_blas_int* lwork, strumpack_blas_int* info);
+      void STRUMPACK_FC_GLOBAL(cgesvd,CGESVD)
+        (char* jobu, char* jobvt, strumpack_blas_int* m, strumpack_blas_int* n,
+         std::complex<float>* a, strumpack_blas_int* lda, float* s,
+         std::complex<float>* u, strumpack_blas_int* ldu,
+         std::complex<float>* vt, strumpack_blas_int* ldvt,
+         std::complex<float>* work, strumpack_blas_int* lwork,
+         float* rwork, strumpack_blas_int* info);
+      void STRUMPACK_FC_GLOBAL(zgesvd,ZGESVD)
+        (char* jobu, char* jobvt, strumpack_blas_int* m, strumpack_blas_int* n,
+         std::complex<double>* a, strumpack_blas_int* lda, double* s,
+         std::complex<double>* u, strumpack_blas_int* ldu,
+         std::complex<double>* vt, strumpack_blas_int* ldvt,
+         std::complex<double>* work, strumpack_blas_int* lwork,
+         double* rwork, strumpack_blas_int* info);
 
       void STRUMPACK_FC_GLOBAL(ssyevx,SSYEVX)
         (char* jobz, char* range, char* uplo, strumpack_blas_int* n,
@@ -1776,14 +1790,38 @@ namespace strumpack {
     int gesvd(char jobu, char jobvt, int m, int n, std::complex<float>* a, int lda,
               std::complex<float>* s, std::complex<float>* u, int ldu,
               std::complex<float>* vt, int ldvt) {
-      std::cout << "TODO gesvd for std::complex<float>" << std::endl;
-      return 0;
+      strumpack_blas_int info, lwork = -1, m_ = m, n_ = n, lda_ = lda, ldu_ = ldu, ldvt_ = ldvt;
+      std::complex<float> cwork;
+      std::unique_ptr<float[]> rwork(new float[5*std::min(m,n)+std::min(m,n)]);
+      auto rs = rwork.get() + 5*std::min(m,n);
+      STRUMPACK_FC_GLOBAL(cgesvd,CGESVD)
+        (&jobu, &jobvt, &m_, &n_, a, &lda_, rs, u, &ldu_, vt, &ldvt_,
+         &cwork, &lwork, rwork.get(), &info);
+      lwork = (int)std::real(cwork);
+      std::unique_ptr<std::complex<float>[]> work(new std::complex<float>[lwork]);
+      STRUMPACK_FC_GLOBAL(cgesvd,CGESVD)
+        (&jobu, &jobvt, &m_, &n_, a, &lda_, rs, u, &ldu_, vt, &ldvt_,
+         work.get(), &lwork, rwork.get(), &info);
+      std::copy(rs, rs+std::min(m,n), s);
+      return info;
     }
     int gesvd(char jobu, char jobvt, int m, int n, std::complex<double>* a, int lda,
               std::complex<double>* s, std::complex<double>* u, int ldu,
               std::complex<double>* vt, int ldvt) {
-      std::cout << "TODO gesvd for std::complex<double>" << std::endl;
-      return 0;
+      strumpack_blas_int info, lwork = -1, m_ = m, n_ = n, lda_ = lda, ldu_ = ldu, ldvt_ = ldvt;
+      std::complex<double> cwork;
+      std::unique_ptr<double[]> rwork(new double[5*std::min(m,n)+std::min(m,n)]);
+      auto rs = rwork.get() + 5*std::min(m,n);
+      STRUMPACK_FC_GLOBAL(zgesvd,ZGESVD)
+        (&jobu, &jobvt, &m_, &n_, a, &lda_, rs, u, &ldu_, vt, &ldvt_,
+         &cwork, &lwork, rwork.get(), &info);
+      lwork = (int)std::real(cwork);
+      std::unique_ptr<std::complex<double>[]> work(new std::complex<double>[lwork]);
+      STRUMPACK_FC_GLOBAL(zgesvd,ZGESVD)
+        (&jobu, &jobvt, &m_, &n_, a, &lda_, rs, u, &ldu_, vt, &ldvt_,
+         work.get(), &lwork, rwork.get(), &info);
+      std::copy(rs, rs+std::min(m,n), s);
+      return info;
     }
 
     int syevx(char jobz, char range, char uplo, int n, float* a, int lda,
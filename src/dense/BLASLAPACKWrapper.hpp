@@ -45,6 +45,12 @@ namespace strumpack {
   template<class T> struct RealType { typedef T value_type; };
   template<class T> struct RealType<std::complex<T>> { typedef T value_type; };
 
+  template<class T> struct LowerPrecisionType { typedef T value_type; };
+  template<> struct LowerPrecisionType<double> { typedef float value_type; };
+  template<> struct LowerPrecisionType<std::complex<double>> {
+    typedef std::complex<float> value_type;
+  };
+
   namespace blas {
 
     inline bool my_conj(bool a) { return a; }
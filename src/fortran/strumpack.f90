@@ -74,10 +74,11 @@ module strumpack
   enumerator :: STRUMPACK_ZFP_BLR_HODLR = 5
   enumerator :: STRUMPACK_LOSSLESS = 6
   enumerator :: STRUMPACK_LOSSY = 7
+  enumerator :: STRUMPACK_AUTO_COMPRESSION = 8
  end enum
  integer, parameter, public :: STRUMPACK_COMPRESSION_TYPE = kind(STRUMPACK_NONE)
  public :: STRUMPACK_NONE, STRUMPACK_HSS, STRUMPACK_BLR, STRUMPACK_HODLR, STRUMPACK_BLR_HODLR, STRUMPACK_ZFP_BLR_HODLR, &
-    STRUMPACK_LOSSLESS, STRUMPACK_LOSSY
+    STRUMPACK_LOSSLESS, STRUMPACK_LOSSY, STRUMPACK_AUTO_COMPRESSION
  ! typedef enum STRUMPACK_MATCHING_JOB
  enum, bind(c)
   enumerator :: STRUMPACK_MATCHING_NONE = 0
@@ -140,10 +141,15 @@ module strumpack
   enumerator :: STRUMPACK_GMRES = 4
   enumerator :: STRUMPACK_PREC_BICGSTAB = 5
   enumerator :: STRUMPACK_BICGSTAB = 6
+  enumerator :: STRUMPACK_PIPELINED_GMRES = 7
+  enumerator :: STRUMPACK_PREC_FGMRES = 8
+  enumerator :: STRUMPACK_PREC_GCRODR = 9
+  enumerator :: STRUMPACK_PREC_GMRES_IR = 10
  end enum
  integer, parameter, public :: STRUMPACK_KRYLOV_SOLVER = kind(STRUMPACK_AUTO)
  public :: STRUMPACK_AUTO, STRUMPACK_DIRECT, STRUMPACK_REFINE, STRUMPACK_PREC_GMRES, STRUMPACK_GMRES, STRUMPACK_PREC_BICGSTAB, &
-    STRUMPACK_BICGSTAB
+    STRUMPACK_BICGSTAB, STRUMPACK_PIPELINED_GMRES, STRUMPACK_PREC_FGMRES, STRUMPACK_PREC_GCRODR, &
+    STRUMPACK_PREC_GMRES_IR
  ! typedef enum STRUMPACK_RETURN_CODE
  enum, bind(c)
   enumerator :: STRUMPACK_SUCCESS = 0
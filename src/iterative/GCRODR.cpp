@@ -0,0 +1,319 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "IterativeSolvers.hpp"
+
+namespace strumpack {
+
+  namespace iterative {
+
+    /*
+     * Orthonormalize the n x k matrix C (CholQR, applied twice for
+     * stability), and apply the same transformation to U, so that the
+     * relation C = M^{-1}A U is preserved. Returns false if C is
+     * (numerically) rank deficient.
+     */
+    template<typename scalar_t> bool GCRODR_orthonormalize
+    (std::size_t n, int k, scalar_t* C, scalar_t* U) {
+      std::vector<scalar_t> R(k*k);
+      for (int pass=0; pass<2; pass++) {
+        blas::gemm('C', 'N', k, k, n, scalar_t(1.), C, n, C, n,
+                   scalar_t(0.), R.data(), k);
+        if (blas::potrf('U', k, R.data(), k)) return false;
+        blas::trsm('R', 'U', 'N', 'N', n, k, scalar_t(1.),
+                   R.data(), k, C, n);
+        blas::trsm('R', 'U', 'N', 'N', n, k, scalar_t(1.),
+                   R.data(), k, U, n);
+      }
+      return true;
+    }
+
+    /*
+     * This is left preconditioned, restarted GMRes with Krylov
+     * subspace recycling, based on GCRO-DR, see
+     *   M. L. Parks, E. de Sturler, G. Mackey, D. D. Johnson and
+     *   S. Maiti, "Recycling Krylov subspaces for sequences of linear
+     *   systems", SIAM J. Sci. Comput. 28(5), 2006.
+     *
+     * A subspace U (with C = M^{-1}AU orthonormal) is deflated from
+     * the Krylov space. At the end of every cycle, U is replaced by
+     * the directions y = [U V] z of the current search space which
+     * minimize |M^{-1}A y| / |y| = |G z| / |R z|, with the small
+     * matrix
+     *   G = [ I  B ]
+     *       [ 0  H ]
+     * where B = C^H M^{-1}AV and H the Arnoldi Hessenberg matrix, and
+     * R^H R = [U V]^H [U V]. Since U is not orthonormal, the
+     * normalization by R is needed to keep the slowly converging
+     * directions from one cycle to the next. These are computed from
+     * the right singular vectors of G R^{-1}. The
+     * recycle space is returned in U, which can be passed to a next
+     * call with a (slightly) different matrix or preconditioner. C is
+     * recomputed at the start of every call.
+     *
+     *  Input vectors x and b have stride 1, length n
+     */
+    template<typename scalar_t, typename real_t> real_t GCRODR
+    (const SPMV<scalar_t>& A, const PREC<scalar_t>& M, std::size_t n,
+     scalar_t* x, const scalar_t* b, real_t rtol, real_t atol,
+     int& totit, int maxit, int restart, int recycle,
+     DenseMatrix<scalar_t>& U, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose) {
+      if (restart > maxit) restart = maxit;
+      int k = std::max(0, std::min(recycle, restart-1));
+      std::unique_ptr<scalar_t[]> work
+        (new scalar_t[restart + restart + restart+1 + 2*(restart+1)*restart +
+                      k*restart + k + n*(restart+1) + 4*n*k]);
+      auto givens_c = work.get();
+      auto givens_s = givens_c + restart;
+      auto b_ = givens_s + restart;
+      auto hess = b_ + restart+1;
+      auto hbar = hess + (restart+1)*restart;
+      auto Bk = hbar + (restart+1)*restart;
+      auto y = Bk + k*restart;
+      auto V = y + k;
+      auto Uk = V + n*(restart+1);
+      auto Ck = Uk + n*k;
+      auto Unew = Ck + n*k;
+      auto Cnew = Unew + n*k;
+
+      int ldh = restart+1, kk = 0;
+      if (k > 0 && U.rows() == n && U.cols() > 0) {
+        kk = std::min(int(U.cols()), k);
+        for (int j=0; j<kk; j++) {
+          std::copy(U.ptr(0, j), U.ptr(0, j)+n, &Uk[j*n]);
+          A(&Uk[j*n], &Ck[j*n]);
+          M(&Ck[j*n]);
+        }
+        if (!GCRODR_orthonormalize(n, kk, Ck, Uk)) kk = 0;
+      }
+
+      real_t rho, rho0 = real_t(0.);
+      bool no_conv = true, first = true, x_zero = !non_zero_guess;
+      totit = 0;
+      while (no_conv) {
+        if (!x_zero) {
+          A(x, V);
+          blas::axpby(n, scalar_t(1.), b, 1, scalar_t(-1.), V, 1);
+        } else {
+          std::copy(b, b+n, V);
+          std::fill(x, x+n, scalar_t(0.));
+        }
+        M(V);
+        rho = blas::nrm2(n, V, 1);
+        if (first) rho0 = rho;
+        first = false;
+        if (kk) {
+          // x += U C^H r,  r -= C C^H r
+          blas::gemv('C', n, kk, scalar_t(1.), Ck, n, V, 1,
+                     scalar_t(0.), y, 1);
+          blas::gemv('N', n, kk, scalar_t(1.), Uk, n, y, 1,
+                     scalar_t(1.), x, 1);
+          blas::gemv('N', n, kk, scalar_t(-1.), Ck, n, y, 1,
+                     scalar_t(1.), V, 1);
+          rho = blas::nrm2(n, V, 1);
+          x_zero = false;
+        }
+        if (rho/rho0 < rtol || rho < atol) { no_conv = false; break; }
+        blas::scal(n, scalar_t(1./rho), V, 1);
+        b_[0] = rho;
+        for (int i=1; i<=restart; i++) b_[i] = scalar_t(0.);
+
+        int m = restart - kk, nrit = m-1;
+        if (verbose)
+          std::cout << "GCRODR it. " << totit << "\tres = "
+                    << std::setw(12) << rho
+                    << "\trel.res = " << std::setw(12)
+                    << rho/rho0 << "\t restart! (recycle = "
+                    << kk << ")" << std::endl;
+        for (int it=0; it<m; it++) {
+          totit++;
+          A(&V[it*n], &V[(it+1)*n]);
+          M(&V[(it+1)*n]);
+          if (kk) {
+            blas::gemv('C', n, kk, scalar_t(1.), Ck, n, &V[(it+1)*n], 1,
+                       scalar_t(0.), &Bk[it*k], 1);
+            blas::gemv('N', n, kk, scalar_t(-1.), Ck, n, &Bk[it*k], 1,
+                       scalar_t(1.), &V[(it+1)*n], 1);
+          }
+          if (GStype == GramSchmidtType::CLASSICAL) {
+            blas::gemv
+              ('C', n, it+1, scalar_t(1.), V, n, &V[(it+1)*n], 1,
+               scalar_t(0.), &hess[it*ldh], 1);
+            blas::gemv
+              ('N', n, it+1, scalar_t(-1.), V, n, &hess[it*ldh], 1,
+               scalar_t(1.), &V[(it+1)*n], 1);
+          } else if (GStype == GramSchmidtType::MODIFIED) {
+            for (int i=0; i<=it; i++) {
+              hess[i+it*ldh] = blas::dotc(n, &V[i*n], 1, &V[(it+1)*n], 1);
+              blas::axpy
+                (n, scalar_t(-hess[i+it*ldh]), &V[i*n], 1, &V[(it+1)*n], 1);
+            }
+          }
+          hess[it+1+it*ldh] = blas::nrm2(n, &V[(it+1)*n], 1);
+          blas::scal(n, scalar_t(1.)/hess[it+1+it*ldh], &V[(it+1)*n], 1);
+          // keep the unrotated Hessenberg matrix for the recycling
+          std::copy(&hess[it*ldh], &hess[it*ldh]+it+2, &hbar[it*ldh]);
+
+          for (int i=1; i<it+1; i++) {
+            scalar_t gamma = blas::my_conj(givens_c[i-1])*hess[i-1+it*ldh]
+              + blas::my_conj(givens_s[i-1])*hess[i+it*ldh];
+            hess[i+it*ldh] = -givens_s[i-1]*hess[i-1+it*ldh]
+              + givens_c[i-1]*hess[i+it*ldh];
+            hess[i-1+it*ldh] = gamma;
+          }
+          scalar_t delta =
+            std::sqrt(std::pow(std::abs(hess[it+it*ldh]),scalar_t(2))
+                      + std::pow(hess[it+1+it*ldh],scalar_t(2)));
+          givens_c[it] = hess[it+it*ldh] / delta;
+          givens_s[it] = hess[it+1+it*ldh] / delta;
+          hess[it+it*ldh] = blas::my_conj(givens_c[it])*hess[it+it*ldh]
+            + blas::my_conj(givens_s[it])*hess[it+1+it*ldh];
+          b_[it+1] = -givens_s[it]*b_[it];
+          b_[it] = blas::my_conj(givens_c[it])*b_[it];
+          rho = std::abs(b_[it+1]);
+          if (verbose)
+            std::cout << "GCRODR it. " << totit << "\tres = "
+                      << std::setw(12) << rho
+                      << "\trel.res = " << std::setw(12)
+                      << rho/rho0 << std::endl;
+          if ((rho < atol) || (rho/rho0 < rtol) || (totit >= maxit)) {
+            no_conv = false;
+            nrit = it;
+            break;
+          }
+        }
+        int mm = nrit+1;
+        blas::trsv('U', 'N', 'N', mm, hess, ldh, b_, 1);
+        // x += V y - U B y
+        blas::gemv
+          ('N', n, mm, scalar_t(1.), V, n, b_, 1, scalar_t(1.), x, 1);
+        if (kk) {
+          blas::gemv('N', kk, mm, scalar_t(1.), Bk, k, b_, 1,
+                     scalar_t(0.), y, 1);
+          blas::gemv('N', n, kk, scalar_t(-1.), Uk, n, y, 1,
+                     scalar_t(1.), x, 1);
+        }
+        x_zero = false;
+
+        // new recycle space from the search space [U V]
+        int knew = std::min(k, kk+mm);
+        if (knew > 0) {
+          int gr = kk+mm+1, gc = kk+mm;
+          std::vector<scalar_t> G(gr*gc), G0(gr*gc), s(gc),
+            VT(gc*gc), GZ(gr*knew);
+          for (int j=0; j<kk; j++) G[j+j*gr] = scalar_t(1.);
+          for (int j=0; j<mm; j++) {
+            for (int i=0; i<kk; i++) G[i+(kk+j)*gr] = Bk[i+j*k];
+            for (int i=0; i<=j+1; i++) G[kk+i+(kk+j)*gr] = hbar[i+j*ldh];
+          }
+          G0 = G;
+          // Gram matrix W = [U V_m]^H [U V_m] = R^H R, U is not
+          // orthonormal, V_m is
+          std::vector<scalar_t> W(gc*gc);
+          for (int j=0; j<mm; j++) W[kk+j+(kk+j)*gc] = scalar_t(1.);
+          if (kk) {
+            blas::gemm('C', 'N', kk, kk, n, scalar_t(1.), Uk, n, Uk, n,
+                       scalar_t(0.), W.data(), gc);
+            blas::gemm('C', 'N', kk, mm, n, scalar_t(1.), Uk, n, V, n,
+                       scalar_t(0.), &W[kk*gc], gc);
+          }
+          bool gram = blas::potrf('U', gc, W.data(), gc) == 0;
+          // minimize |G z| / |R z|, with the SVD of G R^{-1}
+          if (gram)
+            blas::trsm('R', 'U', 'N', 'N', gr, gc, scalar_t(1.),
+                       W.data(), gc, G.data(), gr);
+          if (blas::gesvd('N', 'A', gr, gc, G.data(), gr, s.data(),
+                          nullptr, 1, VT.data(), gc) == 0) {
+            // Z = R^{-1} times the last knew right singular vectors,
+            // stored in G
+            for (int j=0; j<knew; j++)
+              for (int i=0; i<gc; i++)
+                G[i+j*gc] = blas::my_conj(VT[gc-knew+j+i*gc]);
+            if (gram)
+              blas::trsm('L', 'U', 'N', 'N', gc, knew, scalar_t(1.),
+                         W.data(), gc, G.data(), gc);
+            blas::gemm('N', 'N', gr, knew, gc, scalar_t(1.), G0.data(), gr,
+                       G.data(), gc, scalar_t(0.), GZ.data(), gr);
+            // U_new = [U V_m] Z,  C_new = [C V_{m+1}] G Z
+            blas::gemm('N', 'N', n, knew, mm, scalar_t(1.), V, n,
+                       &G[kk], gc, scalar_t(0.), Unew, n);
+            blas::gemm('N', 'N', n, knew, mm+1, scalar_t(1.), V, n,
+                       &GZ[kk], gr, scalar_t(0.), Cnew, n);
+            if (kk) {
+              blas::gemm('N', 'N', n, knew, kk, scalar_t(1.), Uk, n,
+                         G.data(), gc, scalar_t(1.), Unew, n);
+              blas::gemm('N', 'N', n, knew, kk, scalar_t(1.), Ck, n,
+                         GZ.data(), gr, scalar_t(1.), Cnew, n);
+            }
+            if (GCRODR_orthonormalize(n, knew, Cnew, Unew)) {
+              std::swap(Uk, Unew);
+              std::swap(Ck, Cnew);
+              kk = knew;
+            }
+          }
+        }
+      }
+      U = DenseMatrix<scalar_t>(n, kk);
+      for (int j=0; j<kk; j++)
+        std::copy(&Uk[j*n], &Uk[(j+1)*n], U.ptr(0, j));
+      return rho;
+    }
+
+    // explicit template instantiations
+    template float GCRODR
+    (const SPMV<float>& A, const PREC<float>& M, std::size_t n,
+     float* x, const float* b, float rtol, float atol,
+     int& totit, int maxit, int restart, int recycle,
+     DenseMatrix<float>& U, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose);
+    template double GCRODR
+    (const SPMV<double>& A, const PREC<double>& M, std::size_t n,
+     double* x, const double* b, double rtol, double atol,
+     int& totit, int maxit, int restart, int recycle,
+     DenseMatrix<double>& U, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose);
+    template float GCRODR
+    (const SPMV<std::complex<float>>& A, const PREC<std::complex<float>>& M,
+     std::size_t n, std::complex<float>* x, const std::complex<float>* b,
+     float rtol, float atol, int& totit, int maxit, int restart,
+     int recycle, DenseMatrix<std::complex<float>>& U,
+     GramSchmidtType GStype, bool non_zero_guess, bool verbose);
+    template double GCRODR
+    (const SPMV<std::complex<double>>& A, const PREC<std::complex<double>>& M,
+     std::size_t n, std::complex<double>* x, const std::complex<double>* b,
+     double rtol, double atol, int& totit, int maxit, int restart,
+     int recycle, DenseMatrix<std::complex<double>>& U,
+     GramSchmidtType GStype, bool non_zero_guess, bool verbose);
+
+  } // end namespace iterative
+} // end namespace strumpack
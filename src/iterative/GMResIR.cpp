@@ -0,0 +1,117 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+#include "IterativeSolvers.hpp"
+
+namespace strumpack {
+
+  namespace iterative {
+
+    /*
+     * GMRES based iterative refinement (GMRES-IR). The residual is
+     * computed in the working precision, the correction equation is
+     * solved (to a loose tolerance) with left preconditioned GMRes.
+     *
+     *  Input vectors x and b have stride 1, length n
+     */
+    template<typename scalar_t, typename real_t> real_t GMResIR
+    (const SPMV<scalar_t>& A, const PREC<scalar_t>& M, std::size_t n,
+     scalar_t* x, const scalar_t* b, real_t rtol, real_t atol,
+     int& totit, int maxit, int restart, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose) {
+      // the correction only needs a few correct digits, the outer
+      // loop recovers the working precision accuracy
+      const real_t inner_rtol = std::max(rtol, real_t(1e-4));
+      std::vector<scalar_t> r(n), d(n);
+      auto residual = [&]() {
+        A(x, r.data());
+        blas::axpby(n, scalar_t(1.), b, 1, scalar_t(-1.), r.data(), 1);
+        return blas::nrm2(n, r.data(), 1);
+      };
+      if (!non_zero_guess) std::fill(x, x+n, scalar_t(0.));
+      real_t res = residual(), res0 = res;
+      totit = 0;
+      int ref = 0;
+      auto print = [&](int its) {
+        if (verbose)
+          std::cout << "GMRES-IR it. " << ref << "\tres = "
+                    << std::setw(12) << res
+                    << "\trel.res = " << std::setw(12) << res/res0
+                    << "\tGMRES its = " << its << std::endl;
+      };
+      print(0);
+      while (res > atol && res/res0 > rtol && totit < maxit) {
+        int its = 0;
+        GMRes<scalar_t,real_t>
+          (A, M, n, d.data(), r.data(), inner_rtol, real_t(0.), its,
+           maxit-totit, restart, GStype, false, false);
+        if (!its) break;
+        totit += its;
+        ref++;
+        blas::axpy(n, scalar_t(1.), d.data(), 1, x, 1);
+        auto res_prev = res;
+        res = residual();
+        print(its);
+        // stop when the refinement stagnates, at the accuracy
+        // attainable in the working precision
+        if (ref > 1 && res > real_t(.5) * res_prev) break;
+      }
+      return res;
+    }
+
+    // explicit template instantiations
+    template float GMResIR
+    (const SPMV<float>& A, const PREC<float>& M, std::size_t n,
+     float* x, const float* b, float rtol, float atol,
+     int& totit, int maxit, int restart, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose);
+    template double GMResIR
+    (const SPMV<double>& A, const PREC<double>& M, std::size_t n,
+     double* x, const double* b, double rtol, double atol,
+     int& totit, int maxit, int restart, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose);
+    template float GMResIR
+    (const SPMV<std::complex<float>>& A,
+     const PREC<std::complex<float>>& M, std::size_t n,
+     std::complex<float>* x, const std::complex<float>* b,
+     float rtol, float atol, int& totit, int maxit, int restart,
+     GramSchmidtType GStype, bool non_zero_guess, bool verbose);
+    template double GMResIR
+    (const SPMV<std::complex<double>>& A,
+     const PREC<std::complex<double>>& M, std::size_t n,
+     std::complex<double>* x, const std::complex<double>* b,
+     double rtol, double atol, int& totit, int maxit, int restart,
+     GramSchmidtType GStype, bool non_zero_guess, bool verbose);
+
+  } // end namespace iterative
+} // end namespace strumpack
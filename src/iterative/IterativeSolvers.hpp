@@ -63,6 +63,74 @@ namespace strumpack {
                  bool non_zero_guess, bool verbose);
 
 
+    /*
+     * GMRES based iterative refinement (GMRES-IR). The residual
+     * b - A x is computed in the working precision scalar_t, and
+     * each correction is computed with left preconditioned GMRes (to
+     * a loose relative tolerance). This recovers working precision
+     * accuracy when M is a solve with a lower precision
+     * factorization, for which GMRes by itself can stagnate at a
+     * residual much larger than the one it reports. totit counts the
+     * total number of (inner) GMRes iterations.
+     *
+     *  Input vectors x and b have stride 1, length n
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t GMResIR(const SPMV<scalar_t>& A,
+                   const PREC<scalar_t>& M,
+                   std::size_t n, scalar_t* x, const scalar_t* b,
+                   real_t rtol, real_t atol, int& totit, int maxit,
+                   int restart, GramSchmidtType GStype,
+                   bool non_zero_guess, bool verbose);
+
+
+    /*
+     * This is right preconditioned restarted flexible GMRes. The
+     * preconditioner M is allowed to change from one iteration to
+     * the next, for instance an inner iterative solver or a solve
+     * with a lower precision factorization. The stopping criterion
+     * uses the unpreconditioned residual. If set, outer_res is
+     * called with the current relative (outer) residual before each
+     * application of M, which allows the accuracy of an inner
+     * iterative solver to be relaxed as the outer iteration
+     * converges.
+     *
+     *  Input vectors x and b have stride 1, length n
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t FGMRes(const SPMV<scalar_t>& A,
+                  const PREC<scalar_t>& M,
+                  std::size_t n, scalar_t* x, const scalar_t* b,
+                  real_t rtol, real_t atol, int& totit, int maxit,
+                  int restart, GramSchmidtType GStype,
+                  bool non_zero_guess, bool verbose,
+                  const std::function<void(real_t)>& outer_res=nullptr);
+
+
+    /*
+     * This is left preconditioned restarted GMRes with Krylov
+     * subspace recycling (GCRO-DR). On input, U can contain a recycle
+     * space from a previous solve with a related matrix and/or
+     * preconditioner (it is ignored if it does not have n rows). On
+     * output, U contains (at most) recycle vectors which can be
+     * passed to the next solve. The cycle length, including the
+     * recycled vectors, is restart.
+     *
+     *  Input vectors x and b have stride 1, length n
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t GCRODR(const SPMV<scalar_t>& A,
+                  const PREC<scalar_t>& M,
+                  std::size_t n, scalar_t* x, const scalar_t* b,
+                  real_t rtol, real_t atol, int& totit, int maxit,
+                  int restart, int recycle, DenseMatrix<scalar_t>& U,
+                  GramSchmidtType GStype,
+                  bool non_zero_guess, bool verbose);
+
+
     /**
      * http://www.netlib.org/templates/matlab/bicgstab.m
      */
@@ -95,6 +95,105 @@ namespace strumpack {
     }
 
 
+    /**
+     * GMRES based iterative refinement (GMRES-IR), the residual is
+     * computed in the working precision and each correction with
+     * left preconditioned GMResMPI. See iterative::GMResIR.
+     * Collective operation on comm.
+     *
+     * Vectors x and b should be divided over the processors in the
+     * same way as the matrix, with n the local size. Input vectors x
+     * and b have stride 1 and (local) length n.
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t GMResIRMPI(const MPIComm& comm,
+                      const std::function
+                      <void(const scalar_t*,scalar_t*)>& spmv,
+                      const std::function
+                      <void(scalar_t*)>& prec,
+                      std::size_t n, scalar_t* x, const scalar_t* b,
+                      real_t rtol, real_t atol, int& totit, int maxit,
+                      int restart, GramSchmidtType GStype,
+                      bool non_zero_guess, bool verbose);
+
+
+    /**
+     * Right preconditioned restarted flexible GMRes. The
+     * preconditioner M is allowed to change from one iteration to
+     * the next. The stopping criterion uses the unpreconditioned
+     * residual. Collective operation on comm. If set, outer_res is
+     * called (on all ranks) with the current relative outer residual
+     * before each application of prec.
+     *
+     * Vectors x and b should be divided over the processors in the
+     * same way as the matrix, with n the local size (ie number of
+     * rows of A stored on this rank). Input vectors x and b have
+     * stride 1 and (local) length n.
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t FGMResMPI(const MPIComm& comm,
+                     const std::function
+                     <void(const scalar_t*,scalar_t*)>& spmv,
+                     const std::function
+                     <void(scalar_t*)>& prec,
+                     std::size_t n, scalar_t* x, const scalar_t* b,
+                     real_t rtol, real_t atol, int& totit, int maxit,
+                     int restart, GramSchmidtType GStype,
+                     bool non_zero_guess, bool verbose,
+                     const std::function<void(real_t)>& outer_res=nullptr);
+
+    /**
+     * Left preconditioned restarted GMRes with Krylov subspace
+     * recycling (GCRO-DR). On input, U can contain a recycle space
+     * from a previous solve with a related matrix and/or
+     * preconditioner. On output, U contains (at most) recycle vectors
+     * which can be passed to the next solve. Collective operation on
+     * comm.
+     *
+     * Vectors x and b, and the rows of U, should be divided over the
+     * processors in the same way as the matrix, with n the local size
+     * (ie number of rows of A stored on this rank). Input vectors x
+     * and b have stride 1 and (local) length n.
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t GCRODRMPI(const MPIComm& comm,
+                     const std::function
+                     <void(const scalar_t*,scalar_t*)>& spmv,
+                     const std::function
+                     <void(scalar_t*)>& prec,
+                     std::size_t n, scalar_t* x, const scalar_t* b,
+                     real_t rtol, real_t atol, int& totit, int maxit,
+                     int restart, int recycle, DenseMatrix<scalar_t>& U,
+                     GramSchmidtType GStype,
+                     bool non_zero_guess, bool verbose);
+
+    /**
+     * Left preconditioned restarted pipelined GMRes. This uses a
+     * single (non-blocking) global reduction per iteration, which is
+     * overlapped with the application of the preconditioner and the
+     * sparse matrix-vector product. The orthogonalization is based
+     * on classical Gram-Schmidt. Collective operation on comm.
+     *
+     * Vectors x and b should be divided over the processors in the
+     * same way as the matrix, with n the local size (ie number of
+     * rows of A stored on this rank). Input vectors x and b have
+     * stride 1 and (local) length n.
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t PipelinedGMResMPI(const MPIComm& comm,
+                             const std::function
+                             <void(const scalar_t*,scalar_t*)>& spmv,
+                             const std::function
+                             <void(scalar_t*)>& prec,
+                             std::size_t n, scalar_t* x, const scalar_t* b,
+                             real_t rtol, real_t atol, int& totit, int maxit,
+                             int restart, bool non_zero_guess, bool verbose);
+
+
     /**
      * http://www.netlib.org/templates/matlab/bicgstab.m
      */
@@ -0,0 +1,215 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <iomanip>
+#include <limits>
+
+#include "IterativeSolversMPI.hpp"
+
+namespace strumpack {
+  namespace iterative {
+
+    /**
+     * Left preconditioned, restarted, pipelined GMRes, see
+     *   P. Ghysels, T.J. Ashby, K. Meerbergen, W. Vanroose, "Hiding
+     *   global communication latency in the GMRES algorithm on
+     *   massively parallel machines", SIAM J. Sci. Comput. 35(1),
+     *   2013.
+     *
+     * Besides the orthonormal basis V, this keeps Z = M^{-1}A V. In
+     * iteration i, the inner products of w = Z_i with the basis
+     * vectors, and the norm of w, are computed with a single
+     * non-blocking reduction, using classical Gram-Schmidt. While
+     * that reduction is in flight, t = M^{-1}A w is computed. Then,
+     * by linearity, Z_{i+1} = (t - Z h) / h_{i+1,i} is obtained
+     * without an additional application of M^{-1}A.
+     *
+     * The norm of the new basis vector is computed from the
+     * Pythagorean theorem, ||w - V h||^2 = ||w||^2 - ||h||^2. If
+     * that is inaccurate due to cancellation, an extra reduction is
+     * used to compute the norm explicitly.
+     */
+    template<typename scalar_t, typename real_t> real_t
+    PipelinedGMResMPI(const MPIComm& comm, const SPMV<scalar_t>& A,
+                      const PREC<scalar_t>& M,
+                      std::size_t n, scalar_t* x, const scalar_t* b,
+                      real_t rtol, real_t atol, int& totit, int maxit,
+                      int restart, bool non_zero_guess, bool verbose) {
+      if (restart > maxit) restart = maxit;
+      std::unique_ptr<scalar_t[]> work
+        (new scalar_t[restart + restart + restart+1 +
+                      (restart+1)*restart + 2*n*(restart+1) + n]);
+      auto givens_c = work.get();
+      auto givens_s = givens_c + restart;
+      auto b_ = givens_s + restart;
+      auto hess = b_ + restart+1;
+      auto V = hess + (restart+1)*restart;
+      auto Z = V + n*(restart+1);
+      auto b_prec = Z + n*(restart+1);
+
+      int ldh = restart+1;
+      real_t rho;
+      real_t rho0 = real_t(0.);
+      const real_t cancel_tol =
+        std::sqrt(std::numeric_limits<real_t>::epsilon());
+      blas::copy(n, b, 1, b_prec, 1);
+      M(b_prec);
+
+      auto BV = [&](const scalar_t* v, scalar_t* w) { A(v, w); M(w); };
+
+      bool no_conv = true;
+      totit = 0;
+      while (no_conv) {
+        if (non_zero_guess || totit > 0) {
+          BV(x, V);
+          blas::axpby(n, scalar_t(1.), b_prec, 1, scalar_t(-1.), V, 1);
+        } else {
+          std::copy(b_prec, b_prec+n, V);
+          std::fill(x, x+n, scalar_t(0.));
+        }
+        rho = norm2(n, V, 1, comm);
+        if (totit == 0) rho0 = rho;
+        if (rho < atol || rho/rho0 < rtol) {
+          no_conv = false;
+          break;
+        }
+        blas::scal(n, scalar_t(1./rho), V, 1);
+        BV(V, Z);
+        b_[0] = rho;
+        for (int i=1; i<=restart; i++) b_[i] = scalar_t(0.);
+        int nrit = restart-1;
+        if (verbose)
+          std::cout << "GMRES it. " << totit
+                    << "\tres = " << std::setw(12) << rho
+                    << "\trel.res = " << std::setw(12)
+                    << rho/rho0 << "\t restart!" << std::endl;
+        for (int it=0; it<restart; it++) {
+          totit++;
+          auto w = &Z[it*n];
+          auto h = &hess[it*ldh];
+          // h(0:it) = V^H w, h(it+1) = w^H w, in a single reduction
+          blas::gemv('C', n, it+1, scalar_t(1.), V, n,
+                     w, 1, scalar_t(0.), h, 1);
+          h[it+1] = blas::dotc(n, w, 1, w, 1);
+          MPI_Request req;
+          comm.iall_reduce(h, it+2, MPI_SUM, &req);
+          // overlap the reduction with the next operator application,
+          // not needed in the last iteration of this cycle
+          bool last = (it == restart-1) || (totit >= maxit);
+          if (!last) BV(w, &Z[(it+1)*n]);
+          MPI_Wait(&req, MPI_STATUS_IGNORE);
+
+          auto vnew = &V[(it+1)*n];
+          std::copy(w, w+n, vnew);
+          blas::gemv('N', n, it+1, scalar_t(-1.), V, n, h, 1,
+                     scalar_t(1.), vnew, 1);
+          real_t wnrm2 = std::real(h[it+1]), hnrm2 = 0.;
+          for (int k=0; k<=it; k++)
+            hnrm2 += std::real(blas::my_conj(h[k])*h[k]);
+          if (wnrm2 - hnrm2 > cancel_tol * wnrm2)
+            h[it+1] = std::sqrt(wnrm2 - hnrm2);
+          else h[it+1] = norm2(n, vnew, 1, comm);
+          blas::scal(n, scalar_t(1.)/h[it+1], vnew, 1);
+          if (!last) {
+            auto znew = &Z[(it+1)*n];
+            blas::gemv('N', n, it+1, scalar_t(-1.), Z, n, h, 1,
+                       scalar_t(1.), znew, 1);
+            blas::scal(n, scalar_t(1.)/h[it+1], znew, 1);
+          }
+
+          for (int k=1; k<it+1; k++) {
+            scalar_t gamma = blas::my_conj(givens_c[k-1])*hess[k-1+it*ldh]
+              + blas::my_conj(givens_s[k-1])*hess[k+it*ldh];
+            hess[k+it*ldh] = -givens_s[k-1]*hess[k-1+it*ldh] +
+              givens_c[k-1]*hess[k+it*ldh];
+            hess[k-1+it*ldh] = gamma;
+          }
+          scalar_t delta =
+            std::sqrt(std::pow(std::abs(hess[it+it*ldh]),scalar_t(2))
+                      + std::pow(hess[it+1+it*ldh],scalar_t(2)));
+          givens_c[it] = hess[it+it*ldh] / delta;
+          givens_s[it] = hess[it+1+it*ldh] / delta;
+          hess[it+it*ldh] = blas::my_conj(givens_c[it])*hess[it+it*ldh] +
+            blas::my_conj(givens_s[it])*hess[it+1+it*ldh];
+          b_[it+1] = -givens_s[it]*b_[it];
+          b_[it] = blas::my_conj(givens_c[it])*b_[it];
+          rho = std::abs(b_[it+1]);
+          if (verbose)
+            std::cout << "GMRES it. " << totit
+                      << "\tres = " << std::setw(12) << rho
+                      << "\trel.res = " << std::setw(12)
+                      << rho/rho0 << std::endl;
+          if ((rho < atol) || (rho/rho0 < rtol) || (totit >= maxit)) {
+            no_conv = false;
+            nrit = it;
+            break;
+          }
+        }
+        blas::trsv('U', 'N', 'N', nrit+1, hess, ldh, b_, 1);
+        blas::gemv('N', n, nrit+1, scalar_t(1.), V, std::max(n, 1ul),
+                   b_, 1, scalar_t(1.), x, 1);
+      }
+      return rho;
+    }
+
+    // explicit template instantiations
+    template
+    float PipelinedGMResMPI(const MPIComm& comm, const SPMV<float>& A,
+                            const PREC<float>& M,
+                            std::size_t n, float* x, const float* b,
+                            float rtol, float atol,
+                            int& totit, int maxit, int restart,
+                            bool non_zero_guess, bool verbose);
+    template
+    double PipelinedGMResMPI(const MPIComm& comm, const SPMV<double>& A,
+                             const PREC<double>& M,
+                             std::size_t n, double* x, const double* b,
+                             double rtol, double atol,
+                             int& totit, int maxit, int restart,
+                             bool non_zero_guess, bool verbose);
+    template
+    float PipelinedGMResMPI(const MPIComm& comm,
+                            const SPMV<std::complex<float>>& A,
+                            const PREC<std::complex<float>>& M, std::size_t n,
+                            std::complex<float>* x,
+                            const std::complex<float>* b,
+                            float rtol, float atol, int& totit, int maxit,
+                            int restart, bool non_zero_guess, bool verbose);
+    template
+    double PipelinedGMResMPI(const MPIComm& comm,
+                             const SPMV<std::complex<double>>& A,
+                             const PREC<std::complex<double>>& M,
+                             std::size_t n, std::complex<double>* x,
+                             const std::complex<double>* b,
+                             double rtol, double atol,
+                             int& totit, int maxit, int restart,
+                             bool non_zero_guess, bool verbose);
+
+  } // end namespace iterative
+} // end namespace strumpack
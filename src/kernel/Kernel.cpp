@@ -78,61 +78,68 @@ template<typename scalar_t> STRUMPACKKernel STRUMPACK_create_kernel
 }
 
 template<typename scalar_t> void STRUMPACK_kernel_fit_HSS
-(STRUMPACKKernel kernel, scalar_t* labels, int argc, char* argv[]) {
+(STRUMPACKKernel kernel, int nrhs, scalar_t* labels,
+ int argc, char* argv[]) {
   auto KR = static_cast<STRUMPACKKernelRegression<scalar_t>*>(kernel);
-  std::vector<scalar_t> vl(labels, labels+KR->K_->n());
+  int n = KR->K_->n();
+  DenseMatrix<scalar_t> L(n, nrhs, labels, n);
   HSSOptions<scalar_t> opts;
   opts.set_verbose(false);
   opts.set_clustering_algorithm(ClusteringAlgorithm::COBBLE);
   opts.set_from_command_line(argc, argv);
-  KR->weights_ = KR->K_->fit_HSS(vl, opts);
+  KR->weights_ = KR->K_->fit_HSS(L, opts);
 }
 
 #if defined(STRUMPACK_USE_MPI)
 template<typename scalar_t> void STRUMPACK_kernel_fit_HSS_MPI
-(STRUMPACKKernel kernel, scalar_t* labels, int argc, char* argv[]) {
+(STRUMPACKKernel kernel, int nrhs, scalar_t* labels,
+ int argc, char* argv[]) {
   auto KR = static_cast<STRUMPACKKernelRegression<scalar_t>*>(kernel);
   KR->grid_ = std::move(BLACSGrid(MPIComm(MPI_COMM_WORLD)));
-  std::vector<scalar_t> vl(labels, labels+KR->K_->n());
+  int n = KR->K_->n();
+  DenseMatrix<scalar_t> L(n, nrhs, labels, n);
   HSSOptions<scalar_t> opts;
   opts.set_verbose(false);
   opts.set_clustering_algorithm(ClusteringAlgorithm::COBBLE);
   opts.set_from_command_line(argc, argv);
-  KR->dweights_ = KR->K_->fit_HSS(KR->grid_, vl, opts);
+  KR->dweights_ = KR->K_->fit_HSS(KR->grid_, L, opts);
   KR->dist_ = true;
 }
 
 template<typename scalar_t> void STRUMPACK_kernel_fit_HODLR_MPI
-(STRUMPACKKernel kernel, scalar_t* labels, int argc, char* argv[]) {
+(STRUMPACKKernel kernel, int nrhs, scalar_t* labels,
+ int argc, char* argv[]) {
 #if defined(STRUMPACK_USE_BPACK)
   auto KR = static_cast<STRUMPACKKernelRegression<scalar_t>*>(kernel);
-  std::vector<scalar_t> vl(labels, labels+KR->K_->n());
+  int n = KR->K_->n();
+  DenseMatrix<scalar_t> L(n, nrhs, labels, n);
   HODLR::HODLROptions<scalar_t> opts;
   opts.set_verbose(false);
   opts.set_clustering_algorithm(ClusteringAlgorithm::COBBLE);
   opts.set_from_command_line(argc, argv);
-  KR->weights_ = KR->K_->fit_HODLR(MPI_COMM_WORLD, vl, opts);
+  KR->weights_ = KR->K_->fit_HODLR(MPI_COMM_WORLD, L, opts);
 #else
   std::cerr << "ERROR: STRUMPACK was not configured with HODLR support."
             << "       Using HSS compression as fallback!!" << std::endl;
-  STRUMPACK_kernel_fit_HSS_MPI<scalar_t>(kernel, labels, argc, argv);
+  STRUMPACK_kernel_fit_HSS_MPI<scalar_t>(kernel, nrhs, labels, argc, argv);
 #endif
 }
 #endif
 
 template<typename scalar_t> void STRUMPACK_kernel_predict
-(STRUMPACKKernel kernel, int m, scalar_t* test, scalar_t* prediction) {
+(STRUMPACKKernel kernel, int m, scalar_t* test, scalar_t* prediction,
+ bool all_outputs) {
   auto KR = static_cast<STRUMPACKKernelRegression<scalar_t>*>(kernel);
   DenseMatrixWrapper<scalar_t> test_(KR->K_->d(), m, test, KR->K_->d());
+  DenseMatrix<scalar_t> pred;
   if (KR->dist_) {
 #if defined(STRUMPACK_USE_MPI)
-    auto pred = KR->K_->predict(test_, KR->dweights_);
-    std::copy(pred.begin(), pred.end(), prediction);
+    KR->K_->predict(test_, KR->dweights_, pred);
 #endif
-  } else {
-    auto pred = KR->K_->predict(test_, KR->weights_);
-    std::copy(pred.begin(), pred.end(), prediction);
-  }
+  } else KR->K_->predict(test_, KR->weights_, pred);
+  // pred is m x nrhs, stored column major with leading dimension m
+  std::copy(pred.data(), pred.data() + (all_outputs ? m*pred.cols() : m),
+            prediction);
 }
 
 
@@ -158,40 +165,72 @@ extern "C" {
 
   void STRUMPACK_kernel_fit_HSS_double
   (STRUMPACKKernel kernel, double* labels, int argc, char* argv[]) {
-    STRUMPACK_kernel_fit_HSS<double>(kernel, labels, argc, argv);
+    STRUMPACK_kernel_fit_HSS<double>(kernel, 1, labels, argc, argv);
+  }
+  void STRUMPACK_kernel_fit_HSS_multi_double
+  (STRUMPACKKernel kernel, int nrhs, double* labels, int argc, char* argv[]) {
+    STRUMPACK_kernel_fit_HSS<double>(kernel, nrhs, labels, argc, argv);
   }
   void STRUMPACK_kernel_fit_HSS_float
   (STRUMPACKKernel kernel, float* labels, int argc, char* argv[]) {
-    STRUMPACK_kernel_fit_HSS<float>(kernel, labels, argc, argv);
+    STRUMPACK_kernel_fit_HSS<float>(kernel, 1, labels, argc, argv);
+  }
+  void STRUMPACK_kernel_fit_HSS_multi_float
+  (STRUMPACKKernel kernel, int nrhs, float* labels, int argc, char* argv[]) {
+    STRUMPACK_kernel_fit_HSS<float>(kernel, nrhs, labels, argc, argv);
   }
 
 #if defined(STRUMPACK_USE_MPI)
   void STRUMPACK_kernel_fit_HSS_MPI_double
   (STRUMPACKKernel kernel, double* labels, int argc, char* argv[]) {
-    STRUMPACK_kernel_fit_HSS_MPI<double>(kernel, labels, argc, argv);
+    STRUMPACK_kernel_fit_HSS_MPI<double>(kernel, 1, labels, argc, argv);
+  }
+  void STRUMPACK_kernel_fit_HSS_MPI_multi_double
+  (STRUMPACKKernel kernel, int nrhs, double* labels, int argc, char* argv[]) {
+    STRUMPACK_kernel_fit_HSS_MPI<double>(kernel, nrhs, labels, argc, argv);
   }
   void STRUMPACK_kernel_fit_HSS_MPI_float
   (STRUMPACKKernel kernel, float* labels, int argc, char* argv[]) {
-    STRUMPACK_kernel_fit_HSS_MPI<float>(kernel, labels, argc, argv);
+    STRUMPACK_kernel_fit_HSS_MPI<float>(kernel, 1, labels, argc, argv);
+  }
+  void STRUMPACK_kernel_fit_HSS_MPI_multi_float
+  (STRUMPACKKernel kernel, int nrhs, float* labels, int argc, char* argv[]) {
+    STRUMPACK_kernel_fit_HSS_MPI<float>(kernel, nrhs, labels, argc, argv);
   }
 
   void STRUMPACK_kernel_fit_HODLR_MPI_double
   (STRUMPACKKernel kernel, double* labels, int argc, char* argv[]) {
-    STRUMPACK_kernel_fit_HODLR_MPI<double>(kernel, labels, argc, argv);
+    STRUMPACK_kernel_fit_HODLR_MPI<double>(kernel, 1, labels, argc, argv);
+  }
+  void STRUMPACK_kernel_fit_HODLR_MPI_multi_double
+  (STRUMPACKKernel kernel, int nrhs, double* labels, int argc, char* argv[]) {
+    STRUMPACK_kernel_fit_HODLR_MPI<double>(kernel, nrhs, labels, argc, argv);
   }
   void STRUMPACK_kernel_fit_HODLR_MPI_float
   (STRUMPACKKernel kernel, float* labels, int argc, char* argv[]) {
-    STRUMPACK_kernel_fit_HODLR_MPI<float>(kernel, labels, argc, argv);
+    STRUMPACK_kernel_fit_HODLR_MPI<float>(kernel, 1, labels, argc, argv);
+  }
+  void STRUMPACK_kernel_fit_HODLR_MPI_multi_float
+  (STRUMPACKKernel kernel, int nrhs, float* labels, int argc, char* argv[]) {
+    STRUMPACK_kernel_fit_HODLR_MPI<float>(kernel, nrhs, labels, argc, argv);
   }
 #endif
 
   void STRUMPACK_kernel_predict_double
   (STRUMPACKKernel kernel, int m, double* test, double* prediction) {
-    STRUMPACK_kernel_predict<double>(kernel, m, test, prediction);
+    STRUMPACK_kernel_predict<double>(kernel, m, test, prediction, false);
+  }
+  void STRUMPACK_kernel_predict_multi_double
+  (STRUMPACKKernel kernel, int m, double* test, double* prediction) {
+    STRUMPACK_kernel_predict<double>(kernel, m, test, prediction, true);
   }
   void STRUMPACK_kernel_predict_float
   (STRUMPACKKernel kernel, int m, float* test, float* prediction) {
-    STRUMPACK_kernel_predict<float>(kernel, m, test, prediction);
+    STRUMPACK_kernel_predict<float>(kernel, m, test, prediction, false);
+  }
+  void STRUMPACK_kernel_predict_multi_float
+  (STRUMPACKKernel kernel, int m, float* test, float* prediction) {
+    STRUMPACK_kernel_predict<float>(kernel, m, test, prediction, true);
   }
 
 #ifdef __cplusplus
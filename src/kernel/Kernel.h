@@ -53,6 +53,17 @@ extern "C" {
   void STRUMPACK_kernel_fit_HSS_float
   (STRUMPACKKernel K, float* labels, int argc, char* argv[]);
 
+  /**
+   * Fit with nrhs outputs at once, for instance for one-vs-all
+   * multi-class classification. The labels are stored column major,
+   * n x nrhs, with leading dimension n. The kernel matrix is only
+   * compressed and factored once.
+   */
+  void STRUMPACK_kernel_fit_HSS_multi_double
+  (STRUMPACKKernel K, int nrhs, double* labels, int argc, char* argv[]);
+  void STRUMPACK_kernel_fit_HSS_multi_float
+  (STRUMPACKKernel K, int nrhs, float* labels, int argc, char* argv[]);
+
 #if defined(STRUMPACK_USE_MPI)
   /**
    * TODO should pass an MPIComm object from python
@@ -61,6 +72,10 @@ extern "C" {
   (STRUMPACKKernel K, double* labels, int argc, char* argv[]);
   void STRUMPACK_kernel_fit_HSS_MPI_float
   (STRUMPACKKernel K, float* labels, int argc, char* argv[]);
+  void STRUMPACK_kernel_fit_HSS_MPI_multi_double
+  (STRUMPACKKernel K, int nrhs, double* labels, int argc, char* argv[]);
+  void STRUMPACK_kernel_fit_HSS_MPI_multi_float
+  (STRUMPACKKernel K, int nrhs, float* labels, int argc, char* argv[]);
 
   /**
    * TODO should pass an MPIComm object from python
@@ -69,6 +84,10 @@ extern "C" {
   (STRUMPACKKernel K, double* labels, int argc, char* argv[]);
   void STRUMPACK_kernel_fit_HODLR_MPI_float
   (STRUMPACKKernel K, float* labels, int argc, char* argv[]);
+  void STRUMPACK_kernel_fit_HODLR_MPI_multi_double
+  (STRUMPACKKernel K, int nrhs, double* labels, int argc, char* argv[]);
+  void STRUMPACK_kernel_fit_HODLR_MPI_multi_float
+  (STRUMPACKKernel K, int nrhs, float* labels, int argc, char* argv[]);
 #endif
 
   /**
@@ -79,6 +98,16 @@ extern "C" {
   void STRUMPACK_kernel_predict_float
   (STRUMPACKKernel K, int m, float* test, float* prediction);
 
+  /**
+   * Predict all nrhs outputs of a fit with the *_multi_* routines,
+   * prediction is stored column major, m x nrhs, with leading
+   * dimension m. This works for both sequential and MPI fits.
+   */
+  void STRUMPACK_kernel_predict_multi_double
+  (STRUMPACKKernel K, int m, double* test, double* prediction);
+  void STRUMPACK_kernel_predict_multi_float
+  (STRUMPACKKernel K, int m, float* test, float* prediction);
+
 #ifdef __cplusplus
 }
 #endif
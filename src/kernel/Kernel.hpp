@@ -38,6 +38,7 @@
 
 #include "Metrics.hpp"
 #include "HSS/HSSOptions.hpp"
+#include "structured/ClusterTree.hpp"
 #include "dense/DenseMatrix.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "dense/DistributedMatrix.hpp"
@@ -70,6 +71,8 @@ namespace strumpack {
      * kernel representation. Can be float, double,
      * std::complex<float> or std::complex<double>.
      */
+    template<typename scalar_t> class Treecode;
+
     template<typename scalar_t> class Kernel {
       using real_t = typename RealType<scalar_t>::value_type;
       using DenseM_t = DenseMatrix<scalar_t>;
@@ -189,6 +192,24 @@ namespace strumpack {
       DenseM_t fit_HSS
       (std::vector<scalar_t>& labels, const HSS::HSSOptions<scalar_t>& opts);
 
+      /**
+       * Compute weights for kernel ridge regression with multiple
+       * outputs, for instance for one-vs-all multi-class
+       * classification. The kernel matrix is compressed and factored
+       * only once, all columns of labels are solved for at once. The
+       * data associated to this kernel, and the rows of labels, will
+       * get permuted.
+       *
+       * \param labels Matrix with one column of labels per output,
+       * labels.rows() == this->n().
+       * \param opts HSS options
+       * \return A matrix with scalar weights, with one column per
+       * output, to be used in predict
+       * \see predict, fit_HODLR
+       */
+      DenseM_t fit_HSS
+      (DenseM_t& labels, const HSS::HSSOptions<scalar_t>& opts);
+
       /**
        * Return prediction scores for the test points, using the
        * weights computed in fit_HSS() or fit_HODLR().
@@ -203,6 +224,25 @@ namespace strumpack {
       std::vector<scalar_t> predict
       (const DenseM_t& test, const DenseM_t& weights) const;
 
+      /**
+       * Return prediction scores for the test points, for all
+       * outputs, using the weights computed in fit_HSS() or
+       * fit_HODLR(). Each kernel entry is evaluated only once for all
+       * outputs.
+       *
+       * \param test Test data set, should be test.rows() == this->d()
+       * \param weights Weights computed by fit_HSS() or fit_HODLR(),
+       * one column per output
+       * \param prediction Output, the prediction scores, will be
+       * resized to test.cols() x weights.cols(). For one-vs-all
+       * classification, the class of a test point is the column
+       * with the largest score.
+       * \see fit_HSS, fit_HODLR
+       */
+      void predict
+      (const DenseM_t& test, const DenseM_t& weights,
+       DenseM_t& prediction) const;
+
 #if defined(STRUMPACK_USE_MPI)
       /**
        * Compute weights for kernel ridge regression
@@ -228,6 +268,27 @@ namespace strumpack {
       (const BLACSGrid& grid, std::vector<scalar_t>& labels,
        const HSS::HSSOptions<scalar_t>& opts);
 
+      /**
+       * Compute weights for kernel ridge regression with multiple
+       * outputs, using one distributed HSS compression and
+       * factorization for all outputs. The data associated to this
+       * kernel, and the rows of labels, will get permuted.
+       *
+       * \param grid Processor grid to use for the MPI distributed
+       * computations
+       * \param labels Matrix with one column of labels per output,
+       * labels.rows() == this->n(). This should be the same on all
+       * processes.
+       * \param opts HSS options
+       * \return A distributed matrix with one column of weights per
+       * output, to be used in predict(), distributed on the BLACSGrid
+       * grid.
+       * \see predict, fit_HODLR
+       */
+      DistM_t fit_HSS
+      (const BLACSGrid& grid, DenseM_t& labels,
+       const HSS::HSSOptions<scalar_t>& opts);
+
       /**
        * Return prediction scores for the test points, using the
        * weights computed in fit_HSS() or fit_HODLR().
@@ -242,6 +303,22 @@ namespace strumpack {
       std::vector<scalar_t> predict
       (const DenseM_t& test, const DistM_t& weights) const;
 
+      /**
+       * Return prediction scores for the test points, for all
+       * outputs, using the distributed weights computed in
+       * fit_HSS().
+       *
+       * \param test Test data set, should be test.rows() == this->d()
+       * \param weights Weights computed by fit_HSS(), one column per
+       * output
+       * \param prediction Output, the prediction scores, will be
+       * resized to test.cols() x weights.cols(), on all processes.
+       * \see fit_HSS
+       */
+      void predict
+      (const DenseM_t& test, const DistM_t& weights,
+       DenseM_t& prediction) const;
+
 #if defined(STRUMPACK_USE_BPACK)
       /**
        * Compute weights for kernel ridge regression
@@ -264,6 +341,24 @@ namespace strumpack {
       DenseM_t fit_HODLR
       (const MPIComm& c, std::vector<scalar_t>& labels,
        const HODLR::HODLROptions<scalar_t>& opts);
+
+      /**
+       * Compute weights for kernel ridge regression with multiple
+       * outputs, using one HODLR compression and factorization for
+       * all outputs. The data associated to this kernel, and the rows
+       * of labels, will get permuted.
+       *
+       * \param c MPI communicator on which to perform the calculation
+       * \param labels Matrix with one column of labels per output,
+       * labels.rows() == this->n().
+       * \param opts HODLR options
+       * \return A matrix with one column of weights per output, to
+       * be used in predict()
+       * \see predict, fit_HSS
+       */
+      DenseM_t fit_HODLR
+      (const MPIComm& c, DenseM_t& labels,
+       const HODLR::HODLROptions<scalar_t>& opts);
 #endif
 #endif
 
@@ -286,10 +381,22 @@ namespace strumpack {
 
       virtual void permute() {}
 
+      /**
+       * The cluster tree that was used to reorder the data in
+       * fit_HSS() or fit_HODLR(). The data() (and the weights
+       * returned by the fit routines) are ordered such that each node
+       * of this tree corresponds to a contiguous range of data
+       * points. This is empty if no (geometric) clustering was done.
+       * \see Treecode
+       */
+      structured::ClusterTree& cluster_tree() { return tree_; }
+      const structured::ClusterTree& cluster_tree() const { return tree_; }
+
     protected:
       DenseM_t& data_;
       scalar_t lambda_;
       std::vector<int> perm_;
+      structured::ClusterTree tree_;
 
       /**
        * Purely virtual function that needs to be defined in the
@@ -307,6 +414,8 @@ namespace strumpack {
        */
       virtual scalar_t eval_kernel_function
       (const scalar_t* x, const scalar_t* y) const = 0;
+
+      template<typename T> friend class Treecode;
     };
 
 
@@ -0,0 +1,249 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*!
+ * \file KernelData.hpp
+ *
+ * \brief Loading kernel training data from a memory mapped binary
+ * file.
+ */
+#ifndef STRUMPACK_KERNEL_DATA_HPP
+#define STRUMPACK_KERNEL_DATA_HPP
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "dense/DenseMatrix.hpp"
+
+namespace strumpack {
+
+  namespace kernel {
+
+    /**
+     * \class MappedData
+     *
+     * \brief Training data for a kernel matrix, stored in a binary
+     * file which is mapped in memory.
+     *
+     * The file contains n points of dimension d, as raw scalar_t
+     * values, stored point after point (a d x n column major
+     * matrix). Such a file can be created with from_csv (which
+     * streams the input) or with append. The matrix() is a
+     * DenseMatrixWrapper around the mapped file, and can be passed
+     * to any of the Kernel classes, for instance:
+     *
+     * \code
+     * auto d = kernel::MappedData<double>::from_csv("train.csv", "train.bin");
+     * kernel::MappedData<double> data("train.bin", d);
+     * kernel::GaussKernel<double> K(data.matrix(), h, lambda);
+     * auto weights = K.fit_HSS(labels, opts);
+     * \endcode
+     *
+     * This avoids reading the file into a separately allocated
+     * buffer, the pages are loaded from the file when they are first
+     * accessed. This is not an out-of-core method: the clustering in
+     * Kernel::fit_HSS and Kernel::fit_HODLR reorders the data
+     * in-place, which touches every page. With the default private
+     * mapping, all pages are then copied to (anonymous) memory and
+     * the file is never modified, so the data set has to fit in
+     * memory. With a shared mapping (opt-in), the reordered data is
+     * written back to the file, see Kernel::permutation for the
+     * ordering.
+     *
+     * \tparam scalar_t Scalar type of the data, float or double.
+     */
+    template<typename scalar_t> class MappedData {
+      using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+
+    public:
+      /**
+       * Map the binary file fname, containing points of dimension d,
+       * in memory. The number of points is derived from the file
+       * size. Throws a std::runtime_error if the file cannot be
+       * opened or mapped.
+       *
+       * \param fname Name of the binary file
+       * \param d Dimension of the data points
+       * \param shared Use a shared mapping, modifications (the
+       * reordering by the clustering) are written to the file. The
+       * default is a private mapping, which leaves the file as is.
+       */
+      MappedData(const std::string& fname, std::size_t d,
+                 bool shared=false) : shared_(shared) {
+#if defined(_WIN32)
+        throw std::runtime_error
+          ("kernel::MappedData is not supported on this platform");
+#else
+        fd_ = ::open(fname.c_str(), shared ? O_RDWR : O_RDONLY);
+        if (fd_ < 0)
+          throw std::runtime_error("Could not open " + fname);
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) {
+          ::close(fd_);
+          throw std::runtime_error("Could not stat " + fname);
+        }
+        bytes_ = st.st_size;
+        std::size_t n = bytes_ / (d * sizeof(scalar_t));
+        if (d == 0 || n == 0 || n * d * sizeof(scalar_t) != bytes_) {
+          ::close(fd_);
+          throw std::runtime_error
+            (fname + " does not contain points of dimension "
+             + std::to_string(d));
+        }
+        void* ptr = ::mmap
+          (nullptr, bytes_, PROT_READ | PROT_WRITE,
+           shared ? MAP_SHARED : MAP_PRIVATE, fd_, 0);
+        if (ptr == MAP_FAILED) {
+          ::close(fd_);
+          throw std::runtime_error("Could not map " + fname);
+        }
+        data_ = DenseMW_t(d, n, static_cast<scalar_t*>(ptr), d);
+#endif
+      }
+
+      MappedData(const MappedData&) = delete;
+      MappedData& operator=(const MappedData&) = delete;
+
+      ~MappedData() {
+#if !defined(_WIN32)
+        if (data_.data()) ::munmap(data_.data(), bytes_);
+        if (fd_ >= 0) ::close(fd_);
+#endif
+      }
+
+      /**
+       * Number of points.
+       */
+      std::size_t n() const { return data_.cols(); }
+
+      /**
+       * Dimension of the points.
+       */
+      std::size_t d() const { return data_.rows(); }
+
+      /**
+       * The data, a d x n matrix wrapping the mapped file. Pass
+       * this to the Kernel constructor.
+       */
+      DenseMW_t& matrix() { return data_; }
+      const DenseMW_t& matrix() const { return data_; }
+
+      /**
+       * Write all modifications to the file (shared mapping only).
+       */
+      void sync() const {
+#if !defined(_WIN32)
+        if (shared_)
+          ::msync(const_cast<scalar_t*>(data_.data()), bytes_, MS_SYNC);
+#endif
+      }
+
+      /**
+       * Append the points (columns) in P to the binary file fname,
+       * which is created if it does not exist.
+       */
+      static void append(const std::string& fname,
+                         const DenseMatrix<scalar_t>& P) {
+        std::ofstream f(fname, std::ios::binary | std::ios::app);
+        if (!f)
+          throw std::runtime_error("Could not open " + fname);
+        for (std::size_t j=0; j<P.cols(); j++)
+          f.write(reinterpret_cast<const char*>(P.ptr(0, j)),
+                  P.rows() * sizeof(scalar_t));
+      }
+
+      /**
+       * Convert a comma separated text file, with one point per line,
+       * to a binary file which can be mapped with MappedData. The
+       * input is streamed, only chunk points are kept in memory at
+       * once.
+       *
+       * \param csv Name of the input file
+       * \param fname Name of the output binary file, this is
+       * overwritten
+       * \param chunk Number of points to buffer
+       * \return Dimension of the points
+       */
+      static std::size_t from_csv(const std::string& csv,
+                                  const std::string& fname,
+                                  std::size_t chunk=4096) {
+        std::ifstream in(csv);
+        if (!in)
+          throw std::runtime_error("Could not open " + csv);
+        std::ofstream(fname, std::ios::binary | std::ios::trunc);
+        std::size_t d = 0, np = 0;
+        std::vector<scalar_t> buf;
+        std::string line;
+        auto flush = [&]() {
+          if (!np) return;
+          DenseMatrixWrapper<scalar_t> P(d, np, buf.data(), d);
+          append(fname, P);
+          buf.clear();
+          np = 0;
+        };
+        while (std::getline(in, line)) {
+          std::replace(line.begin(), line.end(), ',', ' ');
+          std::istringstream iss(line);
+          std::size_t k = 0;
+          scalar_t v;
+          while (iss >> v) {
+            buf.push_back(v);
+            k++;
+          }
+          if (!k) continue;
+          if (!d) d = k;
+          else if (k != d)
+            throw std::runtime_error
+              (csv + ": inconsistent number of columns");
+          if (++np == chunk) flush();
+        }
+        flush();
+        return d;
+      }
+
+    private:
+      DenseMW_t data_;
+      std::size_t bytes_ = 0;
+      int fd_ = -1;
+      bool shared_ = false;
+    };
+
+  } // end namespace kernel
+} // end namespace strumpack
+
+#endif // STRUMPACK_KERNEL_DATA_HPP
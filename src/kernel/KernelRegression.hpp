@@ -38,6 +38,8 @@
 
 #include "misc/TaskTimer.hpp"
 #include "Kernel.hpp"
+#include "KernelTreecode.hpp"
+#include "KernelData.hpp"
 #include "HSS/HSSMatrix.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "HSS/HSSMatrixMPI.hpp"
@@ -55,13 +57,20 @@ namespace strumpack {
     template<typename scalar_t>
     DenseMatrix<scalar_t> Kernel<scalar_t>::fit_HSS
     (std::vector<scalar_t>& labels, const HSS::HSSOptions<scalar_t>& opts) {
+      DenseMW_t B(n(), 1, labels.data(), n());
+      return fit_HSS(B, opts);
+    }
+
+    template<typename scalar_t>
+    DenseMatrix<scalar_t> Kernel<scalar_t>::fit_HSS
+    (DenseM_t& labels, const HSS::HSSOptions<scalar_t>& opts) {
+      assert(labels.rows() == n());
       TaskTimer timer("compression");
       if (opts.verbose())
         std::cout << "# starting HSS compression..." << std::endl;
       timer.start();
       HSS::HSSMatrix<scalar_t> H(*this, opts);
-      DenseMW_t B(1, n(), labels.data(), 1);
-      B.lapmt(perm_, true);
+      labels.lapmr(perm_, true);
       //perm_.clear(); // TODO not needed anymore??
       if (opts.verbose()) {
         std::cout << "# HSS compression time = "
@@ -82,26 +91,26 @@ namespace strumpack {
       if (opts.verbose())
         std::cout << "# factorization time = "
                   << timer.elapsed() << std::endl
-                  << "# solution start..." << std::endl;
+                  << "# solution start (" << labels.cols()
+                  << " outputs)..." << std::endl;
 #if defined(ITERATIVE_REFINEMENT)
-      DenseMW_t rhs(n(), 1, labels.data(), n());
-      DenseM_t weights(rhs), residual(n(), 1);
+      DenseM_t weights(labels);
       H.solve(weights);
-      auto rhs_normF = rhs.normF();
+      auto rhs_normF = labels.normF();
       using real_t = typename RealType<scalar_t>::value_type;
       for (int ref=0; ref<3; ref++) {
         auto residual = H.apply(weights);
-        residual.scaled_add(scalar_t(-1.), rhs);
+        residual.scaled_add(scalar_t(-1.), labels);
         auto rres = residual.normF() / rhs_normF;
         if (opts.verbose())
-          std::cout << "||H*weights - labels||_2/||labels||_2 = "
+          std::cout << "||H*weights - labels||_F/||labels||_F = "
                     << rres << std::endl;
         if (rres < 10*blas::lamch<real_t>('E')) break;
         H.solve(residual);
         weights.scaled_add(scalar_t(-1.), residual);
       }
 #else // no iterative refinement
-      DenseM_t weights(n(), 1, labels.data(), n());
+      DenseM_t weights(labels);
       H.solve(weights);
 #endif
       if (opts.verbose())
@@ -122,20 +131,44 @@ namespace strumpack {
       return prediction;
     }
 
+    template<typename scalar_t> void Kernel<scalar_t>::predict
+    (const DenseM_t& test, const DenseM_t& weights,
+     DenseM_t& prediction) const {
+      assert(test.rows() == d() && weights.rows() == n());
+      std::size_t k = weights.cols();
+      prediction = DenseM_t(test.cols(), k);
+      prediction.zero();
+#pragma omp parallel for
+      for (std::size_t c=0; c<test.cols(); c++)
+        for (std::size_t r=0; r<n(); r++) {
+          auto Krc = eval_kernel_function(data_.ptr(0, r), test.ptr(0, c));
+          for (std::size_t j=0; j<k; j++)
+            prediction(c, j) += weights(r, j) * Krc;
+        }
+    }
+
 
 #if defined(STRUMPACK_USE_MPI)
     template<typename scalar_t>
     DistributedMatrix<scalar_t> Kernel<scalar_t>::fit_HSS
     (const BLACSGrid& grid, std::vector<scalar_t>& labels,
      const HSS::HSSOptions<scalar_t>& opts) {
+      DenseMW_t B(n(), 1, labels.data(), n());
+      return fit_HSS(grid, B, opts);
+    }
+
+    template<typename scalar_t>
+    DistributedMatrix<scalar_t> Kernel<scalar_t>::fit_HSS
+    (const BLACSGrid& grid, DenseM_t& labels,
+     const HSS::HSSOptions<scalar_t>& opts) {
+      assert(labels.rows() == n());
       TaskTimer timer("HSScompression");
       auto& c = grid.Comm();
       bool verb = opts.verbose() && c.is_root();
       if (verb) std::cout << "# starting HSS compression..." << std::endl;
       timer.start();
       HSS::HSSMatrixMPI<scalar_t> H(*this, &grid, opts);
-      DenseMW_t B(1, n(), labels.data(), 1);
-      B.lapmt(perm_, true);
+      labels.lapmr(perm_, true);
       //perm.clear(); // TODO not needed anymore??
       if (opts.verbose()) {
         const auto lvls = H.max_levels();
@@ -161,12 +194,12 @@ namespace strumpack {
       if (verb)
         std::cout << "# factorization time = "
                   << timer.elapsed() << std::endl
-                  << "# solution start..." << std::endl;
-      DenseMW_t cB(n(), 1, labels.data(), n());
-      DistM_t weights(&grid, n(), 1);
-      weights.scatter(cB);
+                  << "# solution start (" << labels.cols()
+                  << " outputs)..." << std::endl;
+      DistM_t weights(&grid, n(), labels.cols());
+      weights.scatter(labels);
 #if defined(ITERATIVE_REFINEMENT)
-      DistM_t rhs(weights), residual(&grid, n(), 1);
+      DistM_t rhs(weights), residual(&grid, n(), labels.cols());
       H.solve(weights);
       auto rhs_normF = rhs.normF();
       using real_t = typename RealType<scalar_t>::value_type;
@@ -175,7 +208,7 @@ namespace strumpack {
         residual.scaled_add(scalar_t(-1.), rhs);
         auto rres = residual.normF() / rhs_normF;
         if (verb)
-          std::cout << "||H*weights - labels||_2/||labels||_2 = "
+          std::cout << "||H*weights - labels||_F/||labels||_F = "
                     << rres << std::endl;
         if (rres < 10*blas::lamch<real_t>('E')) break;
         H.solve(residual);
@@ -208,18 +241,48 @@ namespace strumpack {
       return prediction;
     }
 
+    template<typename scalar_t> void Kernel<scalar_t>::predict
+    (const DenseM_t& test, const DistM_t& weights,
+     DenseM_t& prediction) const {
+      std::size_t k = weights.cols();
+      prediction = DenseM_t(test.cols(), k);
+      prediction.zero();
+      if (weights.active() && weights.lcols()) {
+        // weights are distributed over rows and columns, each
+        // process computes a partial sum for its local columns
+#pragma omp parallel for
+        for (std::size_t c=0; c<test.cols(); c++)
+          for (int r=0; r<weights.lrows(); r++) {
+            auto Krc = eval_kernel_function
+              (data_.ptr(0, weights.rowl2g(r)), test.ptr(0, c));
+            for (int j=0; j<weights.lcols(); j++)
+              prediction(c, weights.coll2g(j)) += weights(r, j) * Krc;
+          }
+      }
+      weights.Comm().all_reduce
+        (prediction.data(), prediction.rows()*prediction.cols(), MPI_SUM);
+    }
+
 #if defined(STRUMPACK_USE_BPACK)
     template<typename scalar_t>
     DenseMatrix<scalar_t> Kernel<scalar_t>::fit_HODLR
     (const MPIComm& c, std::vector<scalar_t>& labels,
      const HODLR::HODLROptions<scalar_t>& opts) {
+      DenseMW_t B(n(), 1, labels.data(), n());
+      return fit_HODLR(c, B, opts);
+    }
+
+    template<typename scalar_t>
+    DenseMatrix<scalar_t> Kernel<scalar_t>::fit_HODLR
+    (const MPIComm& c, DenseM_t& labels,
+     const HODLR::HODLROptions<scalar_t>& opts) {
+      assert(labels.rows() == n());
       TaskTimer timer("HODLRcompression");
       bool verb = opts.verbose() && c.is_root();
       if (verb) std::cout << "# starting HODLR compression..." << std::endl;
       timer.start();
       HODLR::HODLRMatrix<scalar_t> H(c, *this, opts);
-      DenseMW_t B(1, n(), labels.data(), 1);
-      B.lapmt(perm_, true);
+      labels.lapmr(perm_, true);
       if (verb)
         std::cout << "# HODLR compression time = "
                   << timer.elapsed() << std::endl;
@@ -228,10 +291,11 @@ namespace strumpack {
       if (verb)
         std::cout << "# factorization time = "
                   << timer.elapsed() << std::endl
-                  << "# solution start..." << std::endl;
+                  << "# solution start (" << labels.cols()
+                  << " outputs)..." << std::endl;
       int lrows = H.lrows();
-      DenseMW_t lB(lrows, 1, &labels[H.begin_row()], lrows);
-      DenseM_t lw(lrows, 1);
+      DenseMW_t lB(lrows, labels.cols(), labels, H.begin_row(), 0);
+      DenseM_t lw(lrows, labels.cols());
       H.solve(lB, lw);
       auto weights = H.all_gather_from_1D(lw);
       if (verb)
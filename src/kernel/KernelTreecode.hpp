@@ -0,0 +1,502 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*!
+ * \file KernelTreecode.hpp
+ *
+ * \brief Fast evaluation of kernel regression predictions, using
+ * the cluster tree from the HSS/HODLR fit.
+ */
+#ifndef STRUMPACK_KERNEL_TREECODE_HPP
+#define STRUMPACK_KERNEL_TREECODE_HPP
+
+#include <random>
+#include <numeric>
+#include <algorithm>
+
+#include "Kernel.hpp"
+#include "HSS/HSSBasisID.hpp"
+#include "StrumpackParameters.hpp"
+
+namespace strumpack {
+
+  namespace kernel {
+
+    /**
+     * \class Treecode
+     *
+     * \brief Kernel-independent treecode for fast kernel regression
+     * prediction.
+     *
+     * This reuses the cluster tree (and the corresponding ordering of
+     * the training data) from Kernel::fit_HSS or
+     * Kernel::fit_HODLR. For every node in the tree, a set of
+     * skeleton training points is selected, with equivalent weights,
+     * such that the contribution of that node to the prediction at a
+     * point outside of the ball, centered at the node's centroid with
+     * radius eta times the node's radius, can be evaluated using only
+     * the skeleton points. The skeletons are nested: the skeleton of
+     * a node is selected from the skeletons of its children, using an
+     * interpolative decomposition with respect to a set of proxy
+     * points, which are sampled from the training points in the far
+     * field of the node and from the sphere bounding the far
+     * field. This assumes the kernel is symmetric.
+     *
+     * The accuracy is controlled by the tolerances of the
+     * interpolative decompositions. rel_tol bounds the error of the
+     * contribution of each node relative to the size of that
+     * contribution, abs_tol bounds the absolute error of the
+     * contribution of each node. The error of the prediction at a
+     * test point is roughly bounded by the number of nodes used in
+     * the far field of that point, which is at most two per level of
+     * the tree, times the largest of these errors. With large
+     * weights which cancel, for instance for a small regularization
+     * parameter, the relative bound can be much larger than the
+     * prediction itself, and rel_tol=1e-4 can give a relative error
+     * of several percent. In that case, use a small rel_tol and set
+     * abs_tol to the required absolute accuracy of the predictions.
+     *
+     * Construction is done once for a given set of weights. After
+     * that, predict can be called for different sets of test points,
+     * each test point only visits the nodes of the tree it is close
+     * to. Test points are handled in small batches, which share the
+     * tree traversal.
+     *
+     * \tparam scalar_t Scalar type of the kernel.
+     * \see Kernel::predict
+     */
+    template<typename scalar_t> class Treecode {
+      using real_t = typename RealType<scalar_t>::value_type;
+      using DenseM_t = DenseMatrix<scalar_t>;
+#if defined(STRUMPACK_USE_MPI)
+      using DistM_t = DistributedMatrix<scalar_t>;
+#endif
+
+    public:
+      /**
+       * Construct the treecode, computes the skeletons and the
+       * equivalent weights for all nodes in the cluster tree of K.
+       *
+       * \param K Kernel, fit_HSS or fit_HODLR should have been called
+       * on K, so that K.cluster_tree() is set. If the cluster tree is
+       * empty, prediction falls back to direct evaluation.
+       * \param weights Weights computed by fit_HSS() or fit_HODLR(),
+       * one column per output
+       * \param rel_tol Relative tolerance for the interpolative
+       * decompositions, bounds the error of the contribution of each
+       * node relative to the size of that contribution
+       * \param abs_tol Absolute tolerance for the contribution of
+       * each node to the prediction, the interpolative decomposition
+       * for a node uses abs_tol divided by the norm of the node's
+       * equivalent weights
+       * \param eta Admissibility parameter, a node is considered far
+       * from a point if the distance to its centroid is at least eta
+       * times its radius
+       */
+      Treecode(const Kernel<scalar_t>& K, const DenseM_t& weights,
+               real_t rel_tol=1e-4, real_t abs_tol=1e-10,
+               real_t eta=2.);
+
+#if defined(STRUMPACK_USE_MPI)
+      /**
+       * Construct the treecode from distributed weights, as
+       * computed by the distributed memory Kernel::fit_HSS. The
+       * weights are gathered to all processes.
+       *
+       * \see Treecode(const Kernel<scalar_t>&, const DenseM_t&,
+       * real_t, real_t, real_t)
+       */
+      Treecode(const Kernel<scalar_t>& K, const DistM_t& weights,
+               real_t rel_tol=1e-4, real_t abs_tol=1e-10,
+               real_t eta=2.)
+        : Treecode(K, weights.all_gather(), rel_tol, abs_tol, eta) {}
+#endif
+
+      /**
+       * Return prediction scores for the test points. This should
+       * give the same result as Kernel::predict, up to the tolerance
+       * used in the construction.
+       *
+       * \param test Test data set, should be test.rows() == K.d()
+       * \return Vector with prediction scores.
+       */
+      std::vector<scalar_t> predict(const DenseM_t& test) const;
+
+      /**
+       * Return prediction scores for the test points, for all
+       * outputs, when the treecode was constructed with weights with
+       * multiple columns. The tree traversal and the kernel
+       * evaluations are shared between all outputs.
+       *
+       * \param test Test data set, should be test.rows() == K.d()
+       * \param prediction Output, will be resized to test.cols() x
+       * weights.cols().
+       */
+      void predict(const DenseM_t& test, DenseM_t& prediction) const;
+
+#if defined(STRUMPACK_USE_MPI)
+      /**
+       * Return prediction scores for the test points. The test points
+       * are split over the processes in c, and the result is
+       * all-reduced, so it is available on every process in c.
+       *
+       * \param c communicator, all processes should have constructed
+       * this treecode with the same weights
+       * \param test Test data set, should be test.rows() == K.d()
+       * \return Vector with prediction scores.
+       */
+      std::vector<scalar_t> predict
+      (const MPIComm& c, const DenseM_t& test) const;
+
+      /**
+       * Return prediction scores for the test points, for all
+       * outputs. The test points are split over the processes in c,
+       * and the result is all-reduced.
+       *
+       * \see predict(const MPIComm&, const DenseM_t&)
+       */
+      void predict
+      (const MPIComm& c, const DenseM_t& test, DenseM_t& prediction) const;
+#endif
+
+      /**
+       * Largest skeleton size over all nodes in the tree.
+       */
+      std::size_t max_rank() const;
+
+      /**
+       * Memory used by the skeletons and the equivalent weights, in
+       * bytes.
+       */
+      std::size_t memory() const;
+
+    private:
+      struct Node {
+        std::size_t lo = 0, hi = 0;
+        int c0 = -1, c1 = -1;
+        real_t radius = 0.;
+        std::vector<scalar_t> center;
+        std::vector<std::size_t> J;   // skeleton points
+        DenseM_t W;                   // equivalent weights
+        bool leaf() const { return c0 < 0; }
+      };
+
+      const Kernel<scalar_t>& K_;
+      DenseM_t weights_;
+      real_t eta_;
+      std::vector<Node> nodes_;
+
+      static const std::size_t batch_size = 64;
+
+      int add_nodes(const structured::ClusterTree& t, std::size_t lo);
+      bool far(const Node& nd, const scalar_t* x) const;
+      void compress(int i, std::vector<int> anc, real_t rel_tol,
+                    real_t abs_tol, int depth);
+      void evaluate(int i, const DenseM_t& test,
+                    const std::vector<std::size_t>& idx,
+                    DenseM_t& pred) const;
+      void add_interactions(const DenseM_t& test,
+                            const std::vector<std::size_t>& T,
+                            const std::vector<std::size_t>& J,
+                            const DenseM_t& W, DenseM_t& pred) const;
+    };
+
+
+    template<typename scalar_t> Treecode<scalar_t>::Treecode
+    (const Kernel<scalar_t>& K, const DenseM_t& weights,
+     real_t rel_tol, real_t abs_tol, real_t eta)
+      : K_(K), weights_(weights), eta_(eta) {
+      assert(weights.rows() == K.n());
+      auto& t = K.cluster_tree();
+      if (std::size_t(t.size) == K.n())
+        add_nodes(t, 0);
+      else add_nodes(structured::ClusterTree(K.n()), 0);
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+      compress(0, std::vector<int>(), rel_tol, abs_tol, 0);
+    }
+
+    template<typename scalar_t> int Treecode<scalar_t>::add_nodes
+    (const structured::ClusterTree& t, std::size_t lo) {
+      int i = nodes_.size();
+      nodes_.emplace_back();
+      nodes_[i].lo = lo;
+      nodes_[i].hi = lo + t.size;
+      if (!t.c.empty()) {
+        int c0 = add_nodes(t.c[0], lo);
+        int c1 = add_nodes(t.c[1], lo + t.c[0].size);
+        nodes_[i].c0 = c0;
+        nodes_[i].c1 = c1;
+      }
+      return i;
+    }
+
+    template<typename scalar_t> bool Treecode<scalar_t>::far
+    (const Node& nd, const scalar_t* x) const {
+      return Euclidean_distance(K_.d(), x, nd.center.data())
+        >= eta_ * nd.radius;
+    }
+
+    template<typename scalar_t> void Treecode<scalar_t>::compress
+    (int i, std::vector<int> anc, real_t rel_tol,
+     real_t abs_tol, int depth) {
+      auto& nd = nodes_[i];
+      const auto& X = K_.data();
+      std::size_t d = K_.d();
+      nd.center.assign(d, scalar_t(0.));
+      for (auto j=nd.lo; j<nd.hi; j++)
+        for (std::size_t k=0; k<d; k++)
+          nd.center[k] += X(k, j);
+      for (auto& ck : nd.center)
+        ck /= scalar_t(std::max(nd.hi - nd.lo, std::size_t(1)));
+      for (auto j=nd.lo; j<nd.hi; j++)
+        nd.radius = std::max
+          (nd.radius, Euclidean_distance(d, X.ptr(0, j), nd.center.data()));
+      std::vector<std::size_t> I;
+      DenseM_t W;
+      std::size_t nrhs = weights_.cols();
+      if (nd.leaf()) {
+        for (auto j=nd.lo; j<nd.hi; j++)
+          I.push_back(j);
+        W = DenseM_t(nd.hi - nd.lo, nrhs, weights_, nd.lo, 0);
+      } else {
+        anc.push_back(i);
+        bool tasked = depth < params::task_recursion_cutoff_level;
+        if (tasked) {
+#pragma omp task default(shared) firstprivate(anc)                      \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+          compress(nd.c0, anc, rel_tol, abs_tol, depth+1);
+#pragma omp task default(shared) firstprivate(anc)                      \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+          compress(nd.c1, anc, rel_tol, abs_tol, depth+1);
+#pragma omp taskwait
+        } else {
+          compress(nd.c0, anc, rel_tol, abs_tol, depth+1);
+          compress(nd.c1, anc, rel_tol, abs_tol, depth+1);
+        }
+        anc.pop_back();
+        auto& ch0 = nodes_[nd.c0];
+        auto& ch1 = nodes_[nd.c1];
+        I.insert(I.end(), ch0.J.begin(), ch0.J.end());
+        I.insert(I.end(), ch1.J.begin(), ch1.J.end());
+        W = DenseM_t(I.size(), nrhs);
+        copy(ch0.W, W, 0, 0);
+        copy(ch1.W, W, ch0.J.size(), 0);
+      }
+      // Proxy points are sampled uniformly from the training points
+      // in the range of each of the ancestors, so that points closer
+      // to this node are sampled more densely. They should be in the
+      // far field of this node, or in the far field of one of its
+      // ancestors, since the skeleton of this node is also used to
+      // build the skeletons of the ancestors. The training data does
+      // not cover all directions around nodes at the boundary of the
+      // data set, so points on the spheres bounding the far fields
+      // of this node and of its ancestors are added as well.
+      std::vector<std::size_t> P;
+      DenseM_t sph;
+      if (I.size() > 1) {
+        std::size_t np = I.size() + 16, sz = nd.hi - nd.lo;
+        std::minstd_rand gen(nd.lo + 1);
+        for (auto a : anc) {
+          std::size_t s = (np + anc.size() - 1) / anc.size();
+          std::uniform_int_distribution<std::size_t>
+            u(nodes_[a].lo, nodes_[a].hi - sz - 1);
+          for (std::size_t t=0, ns=0; t<4*s && ns<s; t++) {
+            auto j = u(gen);
+            if (j >= nd.lo) j += sz;
+            bool adm = far(nd, X.ptr(0, j));
+            for (auto b : anc)
+              adm = adm || far(nodes_[b], X.ptr(0, j));
+            if (adm) {
+              P.push_back(j);
+              ns++;
+            }
+          }
+        }
+        sph = DenseM_t(d, np);
+        std::normal_distribution<real_t> nrm;
+        for (std::size_t c=0; c<sph.cols(); c++) {
+          auto& a = (anc.empty() || 2*c < np) ? nd :
+            nodes_[anc[c % anc.size()]];
+          real_t len(0.);
+          for (std::size_t k=0; k<d; k++) {
+            auto v = nrm(gen);
+            sph(k, c) = v;
+            len += v * v;
+          }
+          len = eta_ * a.radius / std::sqrt(len);
+          for (std::size_t k=0; k<d; k++)
+            sph(k, c) = a.center[k] + len * sph(k, c);
+        }
+      }
+      if (P.empty() && !sph.cols()) {
+        nd.J = std::move(I);
+        nd.W = std::move(W);
+        return;
+      }
+      std::size_t nsph = sph.cols();
+      DenseM_t S(I.size(), P.size() + nsph);
+      for (std::size_t c=0; c<P.size(); c++)
+        for (std::size_t r=0; r<I.size(); r++)
+          S(r, c) = K_.eval_kernel_function(X.ptr(0, I[r]), X.ptr(0, P[c]));
+      for (std::size_t c=0; c<nsph; c++)
+        for (std::size_t r=0; r<I.size(); r++)
+          S(r, P.size()+c) =
+            K_.eval_kernel_function(X.ptr(0, I[r]), sph.ptr(0, c));
+      // the error of the contribution of this node is about the
+      // error of the ID times the norm of its weights
+      auto nW = W.normF();
+      auto atol = (nW > real_t(0.)) ? abs_tol / nW : abs_tol;
+      HSS::HSSBasisID<scalar_t> B;
+      std::vector<std::size_t> Jind;
+      S.ID_row(B.E(), B.P(), Jind, rel_tol, atol, I.size(), depth);
+      nd.W = B.applyC(W, depth);
+      nd.J.resize(Jind.size());
+      for (std::size_t j=0; j<Jind.size(); j++)
+        nd.J[j] = I[Jind[j]];
+    }
+
+    template<typename scalar_t> void Treecode<scalar_t>::evaluate
+    (int i, const DenseM_t& test, const std::vector<std::size_t>& idx,
+     DenseM_t& pred) const {
+      auto& nd = nodes_[i];
+      std::vector<std::size_t> fr, near;
+      for (auto t : idx)
+        if (far(nd, test.ptr(0, t))) fr.push_back(t);
+        else near.push_back(t);
+      add_interactions(test, fr, nd.J, nd.W, pred);
+      if (near.empty()) return;
+      if (nd.leaf()) {
+        std::vector<std::size_t> J(nd.hi - nd.lo);
+        std::iota(J.begin(), J.end(), nd.lo);
+        auto W = ConstDenseMatrixWrapperPtr
+          (J.size(), weights_.cols(), weights_, nd.lo, 0);
+        add_interactions(test, near, J, *W, pred);
+      } else {
+        evaluate(nd.c0, test, near, pred);
+        evaluate(nd.c1, test, near, pred);
+      }
+    }
+
+    // pred(T,:) += K(test(:,T), X(:,J)) * W, the kernel block is
+    // evaluated first, and then multiplied with the (equivalent)
+    // weights W, for all outputs at once
+    template<typename scalar_t> void Treecode<scalar_t>::add_interactions
+    (const DenseM_t& test, const std::vector<std::size_t>& T,
+     const std::vector<std::size_t>& J, const DenseM_t& W,
+     DenseM_t& pred) const {
+      if (T.empty() || J.empty()) return;
+      const auto& X = K_.data();
+      DenseM_t KTJ(T.size(), J.size()), PT(T.size(), W.cols());
+      for (std::size_t c=0; c<J.size(); c++)
+        for (std::size_t r=0; r<T.size(); r++)
+          KTJ(r, c) = K_.eval_kernel_function
+            (X.ptr(0, J[c]), test.ptr(0, T[r]));
+      // called from within the parallel loop over the batches
+      gemm(Trans::N, Trans::N, scalar_t(1.), KTJ, W, scalar_t(0.), PT,
+           params::task_recursion_cutoff_level);
+      for (std::size_t j=0; j<W.cols(); j++)
+        for (std::size_t r=0; r<T.size(); r++)
+          pred(T[r], j) += PT(r, j);
+    }
+
+    template<typename scalar_t> std::vector<scalar_t>
+    Treecode<scalar_t>::predict(const DenseM_t& test) const {
+      DenseM_t prediction;
+      predict(test, prediction);
+      return std::vector<scalar_t>
+        (prediction.data(), prediction.data()+test.cols());
+    }
+
+    template<typename scalar_t> void Treecode<scalar_t>::predict
+    (const DenseM_t& test, DenseM_t& prediction) const {
+      assert(test.rows() == K_.d());
+      std::size_t m = test.cols();
+      // local copy, std::min takes a reference to the static member
+      const std::size_t nb = batch_size;
+      prediction = DenseM_t(m, weights_.cols());
+      prediction.zero();
+#pragma omp parallel for schedule(dynamic)
+      for (std::size_t b=0; b<m; b+=nb) {
+        std::vector<std::size_t> idx(std::min(nb, m-b));
+        std::iota(idx.begin(), idx.end(), b);
+        evaluate(0, test, idx, prediction);
+      }
+    }
+
+#if defined(STRUMPACK_USE_MPI)
+    template<typename scalar_t> std::vector<scalar_t>
+    Treecode<scalar_t>::predict
+    (const MPIComm& c, const DenseM_t& test) const {
+      DenseM_t prediction;
+      predict(c, test, prediction);
+      return std::vector<scalar_t>
+        (prediction.data(), prediction.data()+test.cols());
+    }
+
+    template<typename scalar_t> void Treecode<scalar_t>::predict
+    (const MPIComm& c, const DenseM_t& test, DenseM_t& prediction) const {
+      assert(test.rows() == K_.d());
+      std::size_t m = test.cols(), P = c.size(), r = c.rank(),
+        lo = m * r / P, hi = m * (r+1) / P;
+      const std::size_t nb = batch_size;
+      prediction = DenseM_t(m, weights_.cols());
+      prediction.zero();
+#pragma omp parallel for schedule(dynamic)
+      for (std::size_t b=lo; b<hi; b+=nb) {
+        std::vector<std::size_t> idx(std::min(nb, hi-b));
+        std::iota(idx.begin(), idx.end(), b);
+        evaluate(0, test, idx, prediction);
+      }
+      c.all_reduce
+        (prediction.data(), prediction.rows()*prediction.cols(), MPI_SUM);
+    }
+#endif
+
+    template<typename scalar_t> std::size_t
+    Treecode<scalar_t>::max_rank() const {
+      std::size_t r = 0;
+      for (auto& nd : nodes_)
+        r = std::max(r, nd.J.size());
+      return r;
+    }
+
+    template<typename scalar_t> std::size_t
+    Treecode<scalar_t>::memory() const {
+      std::size_t mem = sizeof(*this) + weights_.memory();
+      for (auto& nd : nodes_)
+        mem += sizeof(Node) + nd.center.size() * sizeof(scalar_t) +
+          nd.J.size() * sizeof(std::size_t) + nd.W.memory();
+      return mem;
+    }
+
+  } // end namespace kernel
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_KERNEL_TREECODE_HPP
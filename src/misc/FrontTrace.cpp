@@ -0,0 +1,183 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "FrontTrace.hpp"
+#include "StrumpackParameters.hpp"
+#if defined(STRUMPACK_USE_MPI)
+#include "misc/MPIWrapper.hpp"
+#endif
+
+namespace strumpack {
+
+  namespace {
+    using trace_clock = std::chrono::steady_clock;
+    trace_clock::time_point t0_ = trace_clock::now();
+    std::mutex mtx_;
+    std::vector<FrontEvent> events_;
+    int mpi_rank_ = 0, mpi_procs_ = 1;
+  }
+
+  std::atomic<bool> FrontTrace::enabled_(false);
+
+  std::string get_name(FrontPhase p) {
+    switch (p) {
+    case FrontPhase::ASSEMBLY: return "assembly";
+    case FrontPhase::FACTOR: return "factor";
+    case FrontPhase::EXTEND_ADD: return "extend_add";
+    }
+    return "unknown";
+  }
+
+  void FrontTrace::start() {
+#if defined(STRUMPACK_USE_MPI)
+    int flag = 0;
+    MPI_Initialized(&flag);
+    if (flag) {
+      MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank_);
+      MPI_Comm_size(MPI_COMM_WORLD, &mpi_procs_);
+    }
+#endif
+    std::lock_guard<std::mutex> lock(mtx_);
+    events_.clear();
+    t0_ = trace_clock::now();
+    enabled_.store(true);
+  }
+
+  void FrontTrace::stop() {
+    enabled_.store(false);
+  }
+
+  double FrontTrace::now() {
+    return std::chrono::duration<double>(trace_clock::now() - t0_).count();
+  }
+
+  void FrontTrace::record(const FrontEvent& e) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    events_.push_back(e);
+  }
+
+  std::vector<FrontEvent> FrontTrace::events() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return events_;
+  }
+
+  bool FrontTrace::write(const std::string& fname) {
+    auto f = fname;
+    if (mpi_procs_ > 1) {
+      auto dot = f.find_last_of('.');
+      auto slash = f.find_last_of('/');
+      auto r = "." + std::to_string(mpi_rank_);
+      if (dot == std::string::npos ||
+          (slash != std::string::npos && dot < slash))
+        f += r;
+      else f.insert(dot, r);
+    }
+    bool bin = fname.size() >= 4 &&
+      fname.compare(fname.size()-4, 4, ".bin") == 0;
+    std::ofstream os(f, bin ? std::ios::binary : std::ios::out);
+    if (!os) {
+      std::cerr << "# WARNING: could not open front trace file "
+                << f << std::endl;
+      return false;
+    }
+    if (bin) write_binary(os);
+    else write_chrome_trace(os);
+    return bool(os);
+  }
+
+  void FrontTrace::write_chrome_trace(std::ostream& os) {
+    auto ev = events();
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    os << std::setprecision(3) << std::fixed;
+    for (std::size_t i=0; i<ev.size(); i++) {
+      auto& e = ev[i];
+      os << (i ? ",\n" : "\n")
+         << "{\"name\":\"" << get_name(e.phase)
+         << "\",\"cat\":\""
+         << get_name(static_cast<CompressionType>(e.format))
+         << "\",\"ph\":\"X\",\"ts\":" << e.begin * 1e6
+         << ",\"dur\":" << (e.end - e.begin) * 1e6
+         << ",\"pid\":" << e.mpi_rank << ",\"tid\":" << e.thread
+         << ",\"args\":{\"level\":" << e.level
+         << ",\"dim_sep\":" << e.dim_sep
+         << ",\"dim_upd\":" << e.dim_upd
+         << ",\"rank\":" << e.rank
+         << ",\"flops\":" << e.flops
+         << ",\"bytes\":" << e.bytes
+         << ",\"peak_memory\":" << e.peak_memory << "}}";
+    }
+    os << "\n]}" << std::endl;
+  }
+
+  void FrontTrace::write_binary(std::ostream& os) {
+    auto ev = events();
+    const char magic[8] = {'S','T','R','U','M','P','F','T'};
+    std::uint32_t version = 1, size = sizeof(FrontEvent);
+    std::uint64_t n = ev.size();
+    os.write(magic, sizeof(magic));
+    os.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    os.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    os.write(reinterpret_cast<const char*>(ev.data()), n * size);
+  }
+
+  void FrontTraceScope::begin
+  (FrontPhase phase, CompressionType format, int level,
+   std::size_t dim_sep, std::size_t dim_upd) {
+    e_.phase = phase;
+    e_.format = static_cast<std::int8_t>(format);
+    e_.level = level;
+    e_.dim_sep = dim_sep;
+    e_.dim_upd = dim_upd;
+#if defined(_OPENMP)
+    e_.thread = omp_get_thread_num();
+#endif
+    e_.mpi_rank = mpi_rank_;
+    e_.flops = params::flops.load();
+    e_.bytes = params::bytes_moved.load();
+    e_.begin = FrontTrace::now();
+  }
+
+  void FrontTraceScope::end() {
+    e_.end = FrontTrace::now();
+    e_.flops = params::flops.load() - e_.flops;
+    e_.bytes = params::bytes_moved.load() - e_.bytes;
+    e_.peak_memory = params::peak_memory.load();
+    FrontTrace::record(e_);
+  }
+
+} // end namespace strumpack
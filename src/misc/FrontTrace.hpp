@@ -0,0 +1,190 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*!
+ * \file FrontTrace.hpp
+ * \brief Per-front telemetry for the multifrontal factorization.
+ */
+#ifndef STRUMPACK_FRONT_TRACE_HPP
+#define STRUMPACK_FRONT_TRACE_HPP
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <ostream>
+
+#include "StrumpackOptions.hpp"
+
+namespace strumpack {
+
+  /**
+   * Phase of the processing of a front recorded by FrontTrace.
+   */
+  enum class FrontPhase : std::int8_t {
+    ASSEMBLY,   /*!< extraction from the sparse matrix and
+                     assembly of the children's CBs          */
+    FACTOR,     /*!< (compression and) partial factorization */
+    EXTEND_ADD  /*!< assembly of the CB into the parent      */
+  };
+
+  /**
+   * Return a name/string for the FrontPhase.
+   */
+  std::string get_name(FrontPhase p);
+
+  /**
+   * A single event recorded by FrontTrace. Times are in seconds since
+   * FrontTrace::start. The flops and bytes are the increase of the
+   * global counters during the event, and are only available when
+   * STRUMPACK_COUNT_FLOPS is defined. Since those counters are shared
+   * by all threads, they also include work done concurrently by
+   * other threads. The layout of this struct is also the record
+   * format of the binary log.
+   */
+  struct FrontEvent {
+    double begin = 0., end = 0.;
+    std::int64_t flops = 0, bytes = 0, peak_memory = 0;
+    std::int64_t dim_sep = 0, dim_upd = 0, rank = -1;
+    std::int32_t level = -1, thread = 0, mpi_rank = 0;
+    FrontPhase phase = FrontPhase::FACTOR;
+    std::int8_t format = 0; // CompressionType, NONE for dense
+    std::int8_t pad[2] = {0, 0};
+  };
+
+  /**
+   * \class FrontTrace
+   *
+   * \brief Collects FrontEvents, for every front, during the
+   * multifrontal factorization, and exports them as a Chrome trace
+   * (which can also be loaded in Perfetto) or as a compact binary
+   * log.
+   *
+   * The trace is global to the process. When it is not enabled,
+   * recording an event only costs a check of an atomic flag. Events
+   * are usually recorded using a FrontTraceScope.
+   *
+   * \see SPOptions::set_front_trace
+   */
+  class FrontTrace {
+  public:
+    /**
+     * Clear all events and start recording.
+     */
+    static void start();
+
+    /**
+     * Stop recording, the events are kept until the next start.
+     */
+    static void stop();
+
+    static bool enabled() {
+      return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Time in seconds since the last call to start.
+     */
+    static double now();
+
+    static void record(const FrontEvent& e);
+
+    static std::vector<FrontEvent> events();
+
+    /**
+     * Write the events to a file, as a binary log if fname ends
+     * with ".bin", else as a Chrome trace. When running with
+     * multiple MPI processes, ".<rank>" is inserted before the
+     * extension. Returns false if the file could not be written.
+     */
+    static bool write(const std::string& fname);
+
+    /**
+     * Write a Chrome trace, ie, JSON in the Trace Event Format, with
+     * one complete ("X") event per FrontEvent. The MPI rank is used
+     * as the pid, and the OpenMP thread as the tid.
+     */
+    static void write_chrome_trace(std::ostream& os);
+
+    /**
+     * Write a binary log: the 8 byte magic "STRUMPFT", a uint32
+     * version, a uint32 record size, a uint64 number of records, and
+     * then the raw FrontEvent records.
+     */
+    static void write_binary(std::ostream& os);
+
+  private:
+    static std::atomic<bool> enabled_;
+  };
+
+
+  /**
+   * RAII helper to record a FrontEvent for the lifetime of the
+   * object, does nothing if FrontTrace is not enabled.
+   */
+  class FrontTraceScope {
+  public:
+    FrontTraceScope(FrontPhase phase, CompressionType format, int level,
+                    std::size_t dim_sep, std::size_t dim_upd)
+      : active_(FrontTrace::enabled()) {
+      if (active_) begin(phase, format, level, dim_sep, dim_upd);
+    }
+    ~FrontTraceScope() { if (active_) end(); }
+
+    FrontTraceScope(const FrontTraceScope&) = delete;
+    FrontTraceScope& operator=(const FrontTraceScope&) = delete;
+
+    bool active() const { return active_; }
+
+    /**
+     * Set the (maximum) rank of the compressed front.
+     */
+    void set_rank(std::size_t r) { if (active_) e_.rank = r; }
+
+    /**
+     * Record the event now, instead of at destruction.
+     */
+    void stop() { if (active_) { end(); active_ = false; } }
+
+    /**
+     * Do not record this event.
+     */
+    void discard() { active_ = false; }
+
+  private:
+    bool active_;
+    FrontEvent e_;
+
+    void begin(FrontPhase phase, CompressionType format, int level,
+               std::size_t dim_sep, std::size_t dim_upd);
+    void end();
+  };
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_FRONT_TRACE_HPP
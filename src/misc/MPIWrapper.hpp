@@ -65,6 +65,8 @@ namespace strumpack {
   template<> inline MPI_Datatype mpi_type<bool>() { return MPI_CHAR; }
   /** return MPI datatype for C++ int */
   template<> inline MPI_Datatype mpi_type<int>() { return MPI_INT; }
+  /** return MPI datatype for C++ unsigned int */
+  template<> inline MPI_Datatype mpi_type<unsigned int>() { return MPI_UNSIGNED; }
   /** return MPI datatype for C++ long */
   template<> inline MPI_Datatype mpi_type<long>() { return MPI_LONG; }
   /** return MPI datatype for C++ unsigned long */
@@ -559,6 +561,25 @@ namespace strumpack {
       all_reduce(t.data(), t.size(), op);
     }
 
+    /**
+     * Non-blocking version of all_reduce(T* t, int ssize, MPI_Op
+     * op). The result is only available in t after the request has
+     * completed, see MPI_Iallreduce. The array t should not be
+     * accessed before that.
+     *
+     * \tparam T type of variables to reduce, should have a
+     * corresponding mpi_type<T>() implementation
+     *
+     * \param t pointer to array of variables to reduce
+     * \param ssize size of array to reduce
+     * \param op reduction operator
+     * \param req MPI request object, to be waited on
+     */
+    template<typename T> void
+    iall_reduce(T* t, int ssize, MPI_Op op, MPI_Request* req) const {
+      MPI_Iallreduce(MPI_IN_PLACE, t, ssize, mpi_type<T>(), op, comm_, req);
+    }
+
     /**
      * Compute the reduction of op(t[]_i) over all processes i, t[] is
      * an array, and where op can be any MPI_Op, on the root
@@ -95,10 +95,53 @@ namespace strumpack {
   };
 
 
+  /**
+   * In-place inclusive prefix sum, a[i] = a[0] + ... + a[i]. For
+   * large arrays, and when not called from within a parallel region,
+   * each OpenMP thread scans a contiguous block, the block sums are
+   * scanned, and then added to the blocks.
+   */
+  template<typename T> void parallel_prefix_sum(T* a, std::size_t n) {
+#if defined(_OPENMP)
+    if (n >= 100000 && !omp_in_parallel() && omp_get_max_threads() > 1) {
+      std::vector<T> bsum(omp_get_max_threads()+1, T(0));
+#pragma omp parallel
+      {
+        std::size_t P = omp_get_num_threads(), t = omp_get_thread_num(),
+          lo = n * t / P, hi = n * (t+1) / P;
+        for (std::size_t i=lo+1; i<hi; i++) a[i] += a[i-1];
+        if (hi > lo) bsum[t+1] = a[hi-1];
+#pragma omp barrier
+#pragma omp single
+        for (std::size_t p=1; p<=P; p++) bsum[p] += bsum[p-1];
+        auto offset = bsum[t];
+        for (std::size_t i=lo; i<hi; i++) a[i] += offset;
+      }
+      return;
+    }
+#endif
+    for (std::size_t i=1; i<n; i++) a[i] += a[i-1];
+  }
+
   // this sorts both indices and values at the same time
   template<typename scalar_t,typename integer_t>
   void sort_indices_values(integer_t *ind, scalar_t *val,
                            integer_t begin, integer_t end) {
+    if (end - begin <= 16) {
+      // insertion sort, typical sparse matrix rows are short
+      for (integer_t i=begin+1; i<end; i++) {
+        auto ti = ind[i];
+        auto tv = val[i];
+        integer_t j = i;
+        for (; j>begin && ind[j-1]>ti; j--) {
+          ind[j] = ind[j-1];
+          val[j] = val[j-1];
+        }
+        ind[j] = ti;
+        val[j] = tv;
+      }
+      return;
+    }
     if (end > begin) {
       integer_t left = begin + 1, right = end;
       integer_t pivot = (begin+(end-begin)/2);
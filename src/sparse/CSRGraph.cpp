@@ -31,6 +31,7 @@
 #include <algorithm>
 
 #include "CSRGraph.hpp"
+#include "misc/Tools.hpp"
 #include "ordering/MetisReordering.hpp"
 
 namespace strumpack {
@@ -90,6 +91,32 @@ namespace strumpack {
     std::cout << std::endl;
   }
 
+  /**
+   * Replace the graph (ptr, ind) by its rows in the order iorder, and
+   * apply f to all column indices. The new row pointers are computed
+   * with a parallel prefix sum, then the rows are copied in parallel.
+   */
+  template<typename integer_t,typename F> void
+  permute_rows_map_cols(std::vector<integer_t>& ptr,
+                        std::vector<integer_t>& ind,
+                        const integer_t* iorder, const F& f) {
+    integer_t n = ptr.size() - 1;
+    std::vector<integer_t> pptr(ptr.size()), pind(ind.size());
+    pptr[0] = 0;
+#pragma omp parallel for
+    for (integer_t i=0; i<n; i++)
+      pptr[i+1] = ptr[iorder[i]+1] - ptr[iorder[i]];
+    parallel_prefix_sum(pptr.data()+1, n);
+#pragma omp parallel for schedule(dynamic,512)
+    for (integer_t i=0; i<n; i++) {
+      auto ub = ptr[iorder[i]+1];
+      for (integer_t j=ptr[iorder[i]], k=pptr[i]; j<ub; j++, k++)
+        pind[k] = f(ind[j]);
+    }
+    std::swap(ptr, pptr);
+    std::swap(ind, pind);
+  }
+
   /**
    * order and iorder are of size this->size() == chi-clo.
    * order has elements in the range [clo, chi).
@@ -105,58 +132,29 @@ namespace strumpack {
   CSRGraph<integer_t>::permute_local
   (const std::vector<integer_t>& order, const std::vector<integer_t>& iorder,
    integer_t clo, integer_t chi) {
-    std::vector<integer_t> ptr(ptr_.size()), ind(ind_.size());
-    integer_t nnz = 0;
-    auto n = size();
-    for (integer_t i=0; i<n; i++) {
-      auto lb = ptr_[iorder[i]];
-      auto ub = ptr_[iorder[i]+1];
-      for (integer_t j=lb; j<ub; j++) {
-        auto c = ind_[j];
-        ind[nnz++] = (c >= clo && c < chi) ? order[c-clo] : c;
-      }
-      ptr[i+1] = nnz;
-    }
-    std::swap(ptr_, ptr);
-    std::swap(ind_, ind);
+    permute_rows_map_cols
+      (ptr_, ind_, iorder.data(), [&](integer_t c) {
+        return (c >= clo && c < chi) ? order[c-clo] : c; });
   }
 
   template<typename integer_t> void CSRGraph<integer_t>::permute
   (const integer_t* order, const integer_t* iorder) {
-    std::vector<integer_t> ptr(ptr_.size()), ind(ind_.size());
-    integer_t nnz = 0;
-    auto n = size();
-    for (integer_t i=0; i<n; i++) {
-      auto ub = ptr_[iorder[i]+1];
-      for (integer_t j=ptr_[iorder[i]]; j<ub; j++)
-        ind[nnz++] = order[ind_[j]];
-      ptr[i+1] = nnz;
-    }
-    std::swap(ptr_, ptr);
-    std::swap(ind_, ind);
+    permute_rows_map_cols
+      (ptr_, ind_, iorder, [&](integer_t c) { return order[c]; });
   }
 
   template<typename integer_t> void CSRGraph<integer_t>::permute_rows
   (const integer_t* iorder) {
-    std::vector<integer_t> ptr(ptr_.size()), ind(ind_.size());
-    integer_t nnz = 0;
-    auto n = size();
-    for (integer_t i=0; i<n; i++) {
-      auto ub = ptr_[iorder[i]+1];
-      for (integer_t j=ptr_[iorder[i]]; j<ub; j++)
-        ind[nnz++] = ind_[j];
-      ptr[i+1] = nnz;
-    }
-    std::swap(ptr_, ptr);
-    std::swap(ind_, ind);
+    permute_rows_map_cols
+      (ptr_, ind_, iorder, [](integer_t c) { return c; });
   }
 
   template<typename integer_t> void CSRGraph<integer_t>::permute_cols
   (const integer_t* order) {
-    auto n = size();
-    for (integer_t i=0; i<n; i++)
-      for (integer_t j=ptr_[i]; j<ptr_[i+1]; j++)
-        ind_[j] = order[ind_[j]];
+    auto nnz = ind_.size();
+#pragma omp parallel for
+    for (std::size_t j=0; j<nnz; j++)
+      ind_[j] = order[ind_[j]];
   }
 
   /**
@@ -169,18 +167,8 @@ namespace strumpack {
   (const std::vector<integer_t>& order,
    const std::vector<integer_t>& iorder,
    integer_t clo, integer_t chi) {
-    std::vector<integer_t> ptr(ptr_.size()), ind(ind_.size());
-    integer_t nnz = 0;
-    auto n = size();
-    ptr[0] = 0;
-    for (integer_t i=0; i<n; i++) {
-      auto ub = ptr_[iorder[i]+1];
-      for (integer_t j=ptr_[iorder[i]]; j<ub; j++)
-        ind[nnz++] = order[ind_[j]];
-      ptr[i+1] = nnz;
-    }
-    std::swap(ptr_, ptr);
-    std::swap(ind_, ind);
+    permute_rows_map_cols
+      (ptr_, ind_, iorder.data(), [&](integer_t c) { return order[c]; });
   }
 
   template<typename integer_t> std::vector<std::size_t>
@@ -574,6 +574,63 @@ namespace strumpack {
     }
   }
 
+  template<typename scalar_t,typename integer_t> void
+  CSRMatrix<scalar_t,integer_t>::front_assembly_map
+  (integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
+   FrontAssemblyMap<integer_t>& M) const {
+    integer_t ds = shi - slo, du = upd.size();
+    M.clear();
+    // same traversal as extract_front, F11 and F12 entries are
+    // first collected per row and then split
+    std::vector<integer_t> nz12, r12, c12;
+    for (integer_t row=0; row<ds; row++) { // separator rows
+      integer_t upd_ptr = 0;
+      const auto hij = ptr_[row+slo+1];
+      for (integer_t j=ptr_[row+slo]; j<hij; j++) {
+        integer_t col = ind_[j];
+        if (col >= slo) {
+          if (col < shi) {
+            M.nz.push_back(j);
+            M.r.push_back(row);
+            M.c.push_back(col-slo);
+          } else {
+            while (upd_ptr<du && upd[upd_ptr]<col)
+              upd_ptr++;
+            if (upd_ptr == du) break;
+            if (upd[upd_ptr] == col) {
+              nz12.push_back(j);
+              r12.push_back(row);
+              c12.push_back(upd_ptr);
+            }
+          }
+        }
+      }
+    }
+    M.n11 = M.nz.size();
+    M.n12 = nz12.size();
+    M.nz.insert(M.nz.end(), nz12.begin(), nz12.end());
+    M.r.insert(M.r.end(), r12.begin(), r12.end());
+    M.c.insert(M.c.end(), c12.begin(), c12.end());
+    for (integer_t i=0; i<du; i++) { // update rows
+      auto row = upd[i];
+      const auto hij = ptr_[row+1];
+      for (integer_t j=ptr_[row]; j<hij; j++) {
+        integer_t col = ind_[j];
+        if (col >= slo) {
+          if (col < shi) {
+            M.nz.push_back(j);
+            M.r.push_back(i);
+            M.c.push_back(col-slo);
+          } else break;
+        }
+      }
+    }
+    M.nz.shrink_to_fit();
+    M.r.shrink_to_fit();
+    M.c.shrink_to_fit();
+    M.Annz = nnz_;
+  }
+
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::front_multiply
   (integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
@@ -637,7 +694,7 @@ namespace strumpack {
               const auto hicc = std::min(c+B, nbvec);
               for (integer_t cc=c; cc<hicc; cc++) {
                 Sr(ds+i, cc) += vj * R(col-slo, cc);
-                Sc(col-slo, cc) += vj * R(ds+i, cc);
+                Sc(col-slo, cc) += blas::my_conj(vj) * R(ds+i, cc);
               }
               local_flops += 4*(hicc-c);
             } else break;
@@ -859,6 +916,7 @@ namespace strumpack {
   CSRMatrix<scalar_t,integer_t>::permute_columns
   (const std::vector<integer_t>& perm) {
     std::unique_ptr<integer_t[]> iperm(new integer_t[n_]);
+#pragma omp parallel for
     for (integer_t i=0; i<n_; i++) iperm[perm[i]] = i;
 #pragma omp parallel for
     for (integer_t row=0; row<n_; row++)
@@ -125,6 +125,9 @@ namespace strumpack {
                        integer_t sep_begin, integer_t sep_end,
                        const std::vector<integer_t>& upd,
                        int depth) const override;
+    void front_assembly_map(integer_t sep_begin, integer_t sep_end,
+                            const std::vector<integer_t>& upd,
+                            FrontAssemblyMap<integer_t>& M) const override;
 
     void push_front_elements(integer_t, integer_t,
                              const std::vector<integer_t>&,
@@ -507,13 +507,25 @@ namespace strumpack {
     spmv_rind.erase
       (std::unique(spmv_rind.begin(), spmv_rind.end()), spmv_rind.end());
 
-    spmv_bufs_.prbuf.reserve(nr_offdiag_nnz);
+    spmv_bufs_.prbuf.resize(nr_offdiag_nnz);
+    integer_t nr_offdiag = 0;
     for (integer_t r=0; r<lrows_; r++)
+      if (offdiag_start_[r] < ptr_[r+1]) {
+        spmv_bufs_.brows.push_back(r);
+        spmv_bufs_.bptr.push_back(nr_offdiag);
+        nr_offdiag += ptr_[r+1] - offdiag_start_[r];
+      }
+    spmv_bufs_.bptr.push_back(nr_offdiag);
+    integer_t nb = spmv_bufs_.brows.size();
+#pragma omp parallel for
+    for (integer_t b=0; b<nb; b++) {
+      auto r = spmv_bufs_.brows[b];
+      auto pb = spmv_bufs_.prbuf.data() + spmv_bufs_.bptr[b];
       for (integer_t j=offdiag_start_[r]; j<ptr_[r+1]; j++)
-        spmv_bufs_.prbuf.push_back
-          (std::distance
-           (spmv_rind.begin(), std::lower_bound
-            (spmv_rind.begin(), spmv_rind.end(), ind_[j])));
+        *pb++ = std::distance
+          (spmv_rind.begin(), std::lower_bound
+           (spmv_rind.begin(), spmv_rind.end(), ind_[j]));
+    }
 
     // how much to receive from each proc
     std::vector<int> rsizes(P), ssizes(P);
@@ -568,48 +580,75 @@ namespace strumpack {
     assert(x.cols() == y.cols());
     assert(x.rows() == std::size_t(lrows_));
     assert(y.rows() == std::size_t(lrows_));
-    for (std::size_t c=0; c<x.cols(); c++)
-      spmv(x.ptr(0,c), y.ptr(0,c));
+    if (!x.cols()) return;
+    spmv(x.cols(), x.data(), x.ld(), y.data(), y.ld());
   }
 
   template<typename scalar_t,typename integer_t> void
   CSRMatrixMPI<scalar_t,integer_t>::spmv
   (const scalar_t* x, scalar_t* y) const {
+    spmv(1, x, lrows_, y, lrows_);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  CSRMatrixMPI<scalar_t,integer_t>::spmv
+  (std::size_t nrhs, const scalar_t* x, std::size_t ldx,
+   scalar_t* y, std::size_t ldy) const {
     setup_spmv_buffers();
+    auto& sbuf = spmv_bufs_.sbuf;
+    auto& rbuf = spmv_bufs_.rbuf;
+    sbuf.resize(spmv_bufs_.sind.size() * nrhs);
+    rbuf.resize(spmv_bufs_.roffs.back() * nrhs);
 
-    for (std::size_t i=0; i<spmv_bufs_.sind.size(); i++)
-      spmv_bufs_.sbuf[i] =
-        x[spmv_bufs_.sind[i]-brow_];
+    // ghost values are interleaved, sbuf[i*nrhs+c] holds entry i of
+    // column c, so the data for each neighbor remains contiguous
+    integer_t ns = spmv_bufs_.sind.size();
+#pragma omp parallel for
+    for (integer_t i=0; i<ns; i++) {
+      auto xi = x + spmv_bufs_.sind[i] - brow_;
+      for (std::size_t c=0; c<nrhs; c++)
+        sbuf[i*nrhs+c] = xi[c*ldx];
+    }
 
     std::vector<MPI_Request> sreq(spmv_bufs_.sranks.size()),
       rreq(spmv_bufs_.rranks.size());
-    for (std::size_t p=0; p<spmv_bufs_.sranks.size(); p++)
-      comm_.isend(spmv_bufs_.sbuf.data() + spmv_bufs_.soff[p],
-                  spmv_bufs_.soff[p+1] - spmv_bufs_.soff[p],
-                  spmv_bufs_.sranks[p], 0, &sreq[p]);
-
     for (std::size_t p=0; p<spmv_bufs_.rranks.size(); p++)
-      comm_.irecv(spmv_bufs_.rbuf.data() + spmv_bufs_.roffs[p],
-                  spmv_bufs_.roffs[p+1] - spmv_bufs_.roffs[p],
+      comm_.irecv(rbuf.data() + spmv_bufs_.roffs[p] * nrhs,
+                  (spmv_bufs_.roffs[p+1] - spmv_bufs_.roffs[p]) * nrhs,
                   spmv_bufs_.rranks[p], 0, &rreq[p]);
+    for (std::size_t p=0; p<spmv_bufs_.sranks.size(); p++)
+      comm_.isend(sbuf.data() + spmv_bufs_.soff[p] * nrhs,
+                  (spmv_bufs_.soff[p+1] - spmv_bufs_.soff[p]) * nrhs,
+                  spmv_bufs_.sranks[p], 0, &sreq[p]);
 
-    // first do the block diagonal part, while the communication is going on
+    // first do the block diagonal part, while the communication is
+    // going on, this completes all interior rows
 #pragma omp parallel for
     for (integer_t r=0; r<lrows_; r++) {
-      auto yrow = scalar_t(0.);
-      for (auto j=ptr_[r]; j<offdiag_start_[r]; j++)
-        yrow += val_[j] * x[ind_[j] - brow_];
-      y[r] = yrow;
+      for (std::size_t c=0; c<nrhs; c++) {
+        auto xc = x + c*ldx - brow_;
+        auto yrow = scalar_t(0.);
+        for (auto j=ptr_[r]; j<offdiag_start_[r]; j++)
+          yrow += val_[j] * xc[ind_[j]];
+        y[r+c*ldy] = yrow;
+      }
     }
     // wait for incoming messages
     wait_all(rreq);
 
-    // do the block off-diagonal part of the matrix
-    // TODO some openmp here
-    auto pbuf = spmv_bufs_.prbuf.begin();
-    for (integer_t r=0; r<lrows_; r++)
-      for (integer_t j=offdiag_start_[r]; j<ptr_[r+1]; j++)
-        y[r] += val_[j] * spmv_bufs_.rbuf[*pbuf++];
+    // do the block off-diagonal part, only for the boundary rows
+    integer_t nb = spmv_bufs_.brows.size();
+#pragma omp parallel for
+    for (integer_t b=0; b<nb; b++) {
+      auto r = spmv_bufs_.brows[b];
+      for (std::size_t c=0; c<nrhs; c++) {
+        auto pb = spmv_bufs_.prbuf.data() + spmv_bufs_.bptr[b];
+        auto yrow = scalar_t(0.);
+        for (integer_t j=offdiag_start_[r]; j<ptr_[r+1]; j++)
+          yrow += val_[j] * rbuf[(*pb++)*nrhs+c];
+        y[r+c*ldy] += yrow;
+      }
+    }
 
     // wait for all send messages to finish
     wait_all(sreq);
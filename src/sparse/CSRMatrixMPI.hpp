@@ -53,6 +53,9 @@ namespace strumpack {
     // for each off-diagonal entry spmv_prbuf stores the
     // corresponding index in the receive buffer
     std::vector<integer_t> prbuf;
+    // boundary rows, ie, rows with at least one off-diagonal entry,
+    // and for each boundary row the start of its entries in prbuf
+    std::vector<integer_t> brows, bptr;
   };
 
 
@@ -114,6 +117,10 @@ namespace strumpack {
     void spmv(const scalar_t* x, scalar_t* y) const override;
 
     void permute(const integer_t* iorder, const integer_t* order) override;
+    void permute_in_place(const integer_t* iorder,
+                          const integer_t* order) override {
+      permute(iorder, order);
+    }
 
     std::unique_ptr<CSRMatrix<scalar_t,integer_t>> gather() const;
     std::unique_ptr<CSRGraph<integer_t>> gather_graph() const;
@@ -241,6 +248,18 @@ namespace strumpack {
     void split_diag_offdiag();
     void setup_spmv_buffers() const;
 
+    /**
+     * Multiply with nrhs vectors, stored column major in x (leading
+     * dimension ldx), and store the result in y (leading dimension
+     * ldy). The ghost values for all columns are exchanged with a
+     * single message per neighbor. The block diagonal part, which
+     * includes all interior rows, is computed while that
+     * communication is in flight, only the boundary rows need to
+     * wait for the ghost values.
+     */
+    void spmv(std::size_t nrhs, const scalar_t* x, std::size_t ldx,
+              scalar_t* y, std::size_t ldy) const;
+
     // TODO use MPIComm
     MPIComm comm_;
 
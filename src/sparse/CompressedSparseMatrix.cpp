@@ -136,54 +136,57 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   CompressedSparseMatrix<scalar_t,integer_t>::symmetrize_sparsity() {
     if (symm_sparse_) return;
-    std::vector<integer_t> a2_ctr(n_);
-#pragma omp parallel for
-    for (integer_t i=0; i<n_; i++)
-      a2_ctr[i] = ptr_[i+1]-ptr_[i];
-
+    // count, for every row, the number of missing transposed entries
+    std::vector<integer_t> a2_ctr(n_, 0);
     bool change = false;
-#pragma omp parallel for
+#pragma omp parallel for reduction(||:change) schedule(dynamic,512)
     for (integer_t i=0; i<n_; i++)
       for (integer_t jj=ptr_[i]; jj<ptr_[i+1]; jj++) {
         integer_t kb = ptr_[ind_[jj]], ke = ptr_[ind_[jj]+1];
         if (std::find(ind()+kb, ind()+ke, i) == ind()+ke) {
-#pragma omp critical
-          {
-            a2_ctr[ind_[jj]]++;
-            change = true;
-          }
+#pragma omp atomic
+          a2_ctr[ind_[jj]]++;
+          change = true;
         }
       }
     if (change) {
       std::vector<integer_t> a2_ptr(n_+1);
       a2_ptr[0] = 0;
-      for (integer_t i=0; i<n_; i++) a2_ptr[i+1] = a2_ptr[i] + a2_ctr[i];
-      auto new_nnz = a2_ptr[n_] - a2_ptr[0];
+#pragma omp parallel for
+      for (integer_t i=0; i<n_; i++)
+        a2_ptr[i+1] = ptr_[i+1] - ptr_[i] + a2_ctr[i];
+      parallel_prefix_sum(a2_ptr.data()+1, n_);
+      auto new_nnz = a2_ptr[n_];
       std::vector<integer_t> a2_ind(new_nnz);
       std::vector<scalar_t> a2_val(new_nnz);
       nnz_ = new_nnz;
 #pragma omp parallel for
       for (integer_t i=0; i<n_; i++) {
         a2_ctr[i] = a2_ptr[i] + ptr_[i+1] - ptr_[i];
-        for (integer_t jj=ptr_[i], k=a2_ptr[i]; jj<ptr_[i+1]; jj++) {
-          a2_ind[k  ] = ind_[jj];
-          a2_val[k++] = val_[jj];
-        }
+        std::copy(ind_.begin()+ptr_[i], ind_.begin()+ptr_[i+1],
+                  a2_ind.begin()+a2_ptr[i]);
+        std::copy(val_.begin()+ptr_[i], val_.begin()+ptr_[i+1],
+                  a2_val.begin()+a2_ptr[i]);
       }
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic,512)
       for (integer_t i=0; i<n_; i++)
         for (integer_t jj=ptr_[i]; jj<ptr_[i+1]; jj++) {
           integer_t kb = ptr_[ind_[jj]], ke = ptr_[ind_[jj]+1];
           if (std::find(ind()+kb,ind()+ke, i) == ind()+ke) {
-            integer_t t = ind_[jj];
-#pragma omp critical
-            {
-              a2_ind[a2_ctr[t]] = i;
-              a2_val[a2_ctr[t]] = scalar_t(0.);
-              a2_ctr[t]++;
-            }
+            integer_t t = ind_[jj], k;
+#pragma omp atomic capture
+            k = a2_ctr[t]++;
+            a2_ind[k] = i;
+            a2_val[k] = scalar_t(0.);
           }
         }
+      // the padding is added in a non-deterministic order
+#pragma omp parallel for
+      for (integer_t i=0; i<n_; i++)
+        if (a2_ptr[i+1] - a2_ptr[i] != ptr_[i+1] - ptr_[i])
+          sort_indices_values<scalar_t>
+            (a2_ind.data(), a2_val.data(),
+             a2_ptr[i] + ptr_[i+1] - ptr_[i], a2_ptr[i+1]);
       std::swap(ptr_, a2_ptr);
       std::swap(ind_, a2_ind);
       std::swap(val_, a2_val);
@@ -326,29 +329,150 @@ namespace strumpack {
   (const integer_t* iorder, const integer_t* order) {
     std::vector<integer_t> ptr(n_+1), ind(nnz_);
     std::vector<scalar_t> val(nnz_);
-    integer_t nnz = 0;
+    ptr[0] = 0;
+#pragma omp parallel for
+    for (integer_t i=0; i<n_; i++)
+      ptr[i+1] = ptr_[iorder[i]+1] - ptr_[iorder[i]];
+    parallel_prefix_sum(ptr.data()+1, n_);
+    // gather and sort each row while it is still in cache
+#pragma omp parallel for schedule(dynamic,512)
     for (integer_t i=0; i<n_; i++) {
-      auto ub = ptr_[iorder[i]+1];
-      for (integer_t j=ptr_[iorder[i]]; j<ub; j++) {
-        ind[nnz] = order[ind_[j]];
-        val[nnz++] = val_[j];
+      auto lb = ptr_[iorder[i]], ub = ptr_[iorder[i]+1];
+      for (integer_t j=lb, k=ptr[i]; j<ub; j++, k++) {
+        ind[k] = order[ind_[j]];
+        val[k] = val_[j];
       }
-      ptr[i+1] = nnz;
+      sort_indices_values<scalar_t>
+        (ind.data(), val.data(), ptr[i], ptr[i+1]);
     }
-#pragma omp parallel for
-    for (integer_t i=0; i<n_; i++)
-      sort_indices_values
-        (ind.data()+ptr[i], val.data()+ptr[i], integer_t(0), ptr[i+1]-ptr[i]);
     std::swap(ptr_, ptr);
     std::swap(ind_, ind);
     std::swap(val_, val);
   }
 
+  template<typename scalar_t,typename integer_t> void
+  CompressedSparseMatrix<scalar_t,integer_t>::permute_in_place
+  (const integer_t* iorder, const integer_t* order) {
+    // relabel and sort the columns in the current row storage
+#pragma omp parallel for schedule(dynamic,512)
+    for (integer_t i=0; i<n_; i++) {
+      for (integer_t j=ptr_[i]; j<ptr_[i+1]; j++)
+        ind_[j] = order[ind_[j]];
+      sort_indices_values<scalar_t>
+        (ind_.data(), val_.data(), ptr_[i], ptr_[i+1]);
+    }
+    std::vector<integer_t> ptr(n_+1);
+    ptr[0] = 0;
+#pragma omp parallel for
+    for (integer_t i=0; i<n_; i++)
+      ptr[i+1] = ptr_[iorder[i]+1] - ptr_[iorder[i]];
+    parallel_prefix_sum(ptr.data()+1, n_);
+    // move the rows, first the indices, then the values, so that at
+    // most one extra index or value array is allocated at a time
+    {
+      std::vector<integer_t> ind(nnz_);
+#pragma omp parallel for
+      for (integer_t i=0; i<n_; i++)
+        std::copy(ind_.begin()+ptr_[iorder[i]], ind_.begin()+ptr_[iorder[i]+1],
+                  ind.begin()+ptr[i]);
+      std::swap(ind_, ind);
+    }
+    {
+      std::vector<scalar_t> val(nnz_);
+#pragma omp parallel for
+      for (integer_t i=0; i<n_; i++)
+        std::copy(val_.begin()+ptr_[iorder[i]], val_.begin()+ptr_[iorder[i]+1],
+                  val.begin()+ptr[i]);
+      std::swap(val_, val);
+    }
+    std::swap(ptr_, ptr);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  CompressedSparseMatrix<scalar_t,integer_t>::extract_front_mapped
+  (DenseM_t& F11, DenseM_t& F12, DenseM_t& F21,
+   const FrontAssemblyMap<integer_t>& M) const {
+    const std::size_t n1 = M.n11, n2 = n1 + M.n12, n3 = M.nz.size();
+    const auto nz = M.nz.data();
+    const auto r = M.r.data();
+    const auto c = M.c.data();
+    for (std::size_t k=0; k<n1; k++) F11(r[k], c[k]) = val_[nz[k]];
+    for (std::size_t k=n1; k<n2; k++) F12(r[k], c[k]) = val_[nz[k]];
+    for (std::size_t k=n2; k<n3; k++) F21(r[k], c[k]) = val_[nz[k]];
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  CompressedSparseMatrix<scalar_t,integer_t>::push_front_elements_mapped
+  (const FrontAssemblyMap<integer_t>& M,
+   std::vector<Triplet<scalar_t>>& e11, std::vector<Triplet<scalar_t>>& e12,
+   std::vector<Triplet<scalar_t>>& e21) const {
+    const std::size_t n1 = M.n11, n2 = n1 + M.n12, n3 = M.nz.size();
+    e11.reserve(e11.size() + n1);
+    e12.reserve(e12.size() + n2 - n1);
+    e21.reserve(e21.size() + n3 - n2);
+    for (std::size_t k=0; k<n1; k++)
+      e11.emplace_back(M.r[k], M.c[k], val_[M.nz[k]]);
+    for (std::size_t k=n1; k<n2; k++)
+      e12.emplace_back(M.r[k], M.c[k], val_[M.nz[k]]);
+    for (std::size_t k=n2; k<n3; k++)
+      e21.emplace_back(M.r[k], M.c[k], val_[M.nz[k]]);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  CompressedSparseMatrix<scalar_t,integer_t>::front_multiply_mapped
+  (integer_t ds, const FrontAssemblyMap<integer_t>& M,
+   const DenseM_t& R, DenseM_t& Sr, DenseM_t& Sc, int depth) const {
+    const integer_t nbvec = R.cols();
+    const std::size_t n1 = M.n11, n2 = n1 + M.n12, n3 = M.nz.size();
+    const auto B = 4; // blocking parameter
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)                    \
+  if(depth < params::task_recursion_cutoff_level)
+#endif
+    for (integer_t c=0; c<nbvec; c+=B) {
+      const auto hicc = std::min(c+B, nbvec);
+      // i, j are the row and column in the front
+      auto mult = [&](std::size_t k, integer_t i, integer_t j) {
+        const auto vk = val_[M.nz[k]];
+        for (integer_t cc=c; cc<hicc; cc++) {
+          Sr(i, cc) += vk * R(j, cc);
+          Sc(j, cc) += blas::my_conj(vk) * R(i, cc);
+        }
+      };
+      for (std::size_t k=0; k<n1; k++) mult(k, M.r[k], M.c[k]);
+      for (std::size_t k=n1; k<n2; k++) mult(k, M.r[k], ds+M.c[k]);
+      for (std::size_t k=n2; k<n3; k++) mult(k, ds+M.r[k], M.c[k]);
+      STRUMPACK_FLOPS((is_complex<scalar_t>() ? 4 : 1) * 4 * n3 * (hicc-c));
+      STRUMPACK_SPARSE_SAMPLE_FLOPS
+        ((is_complex<scalar_t>() ? 4 : 1) * 4 * n3 * (hicc-c));
+    }
+  }
+
   template<typename scalar_t,typename integer_t> long long
   CompressedSparseMatrix<scalar_t,integer_t>::spmv_flops() const {
     return (is_complex<scalar_t>() ? 4 : 1 ) * (2ll * nnz_ - n_);
   }
 
+  template<typename scalar_t,typename integer_t> std::uint64_t
+  CompressedSparseMatrix<scalar_t,integer_t>::pattern_hash() const {
+    // splitmix64 finalizer
+    auto mix = [](std::uint64_t z) {
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      return z ^ (z >> 31);
+    };
+    // sum over the nonzeros, so the order within a row does not
+    // matter, the padding from symmetrize_sparsity is not sorted
+    std::uint64_t h = mix(n_);
+#pragma omp parallel for reduction(+:h) schedule(static,512)
+    for (integer_t i=0; i<n_; i++) {
+      auto hi = mix(std::uint64_t(i) + 0x9e3779b97f4a7c15ULL);
+      for (integer_t j=ptr_[i]; j<ptr_[i+1]; j++)
+        h += mix(hi ^ std::uint64_t(ind_[j]));
+    }
+    return h;
+  }
+
   template<typename scalar_t,typename integer_t> long long
   CompressedSparseMatrix<scalar_t,integer_t>::spmv_bytes() const {
     // read   ind  nnz  integer_t
@@ -37,6 +37,7 @@
 #include <vector>
 #include <string>
 #include <tuple>
+#include <cstdint>
 
 #include "misc/Tools.hpp"
 #include "misc/Triplet.hpp"
@@ -126,6 +127,35 @@ namespace strumpack {
     }
   };
 
+  /**
+   * \class FrontAssemblyMap
+   * \brief Positions of the sparse matrix nonzeros in a front.
+   *
+   * For each nonzero of the sparse matrix which is assembled in the
+   * F11, F12 or F21 block of a frontal matrix, this stores the offset
+   * in the values array of the sparse matrix, and the row and column
+   * in that block. The first n11 entries are for F11, the next n12
+   * for F12 and the remaining entries for F21. This only depends on
+   * the sparsity pattern, so it can be reused for a matrix with the
+   * same pattern but different values.
+   *
+   * \see CompressedSparseMatrix::front_assembly_map
+   */
+  template<typename integer_t> class FrontAssemblyMap {
+  public:
+    std::vector<integer_t> nz, r, c;
+    std::size_t n11 = 0, n12 = 0;
+    // nnz of the matrix this was built for, -1 if not built
+    integer_t Annz = -1;
+
+    bool built_for(integer_t nnz) const { return Annz == nnz; }
+    void clear() { *this = FrontAssemblyMap<integer_t>(); }
+    std::size_t memory() const {
+      return 3 * nz.capacity() * sizeof(integer_t);
+    }
+  };
+
+
   /**
    * \class CompressedSparseMatrix
    * \brief Abstract base class for compressed sparse matrix storage.
@@ -334,6 +364,21 @@ namespace strumpack {
       permute(iorder.data(), order.data());
     }
 
+    /**
+     * Same as permute, but with a lower peak memory usage: the
+     * columns are relabeled and sorted in the existing storage, and
+     * then the indices and values are moved one after the other, so
+     * the whole matrix is never stored twice. This is slightly more
+     * expensive than permute.
+     */
+    virtual void permute_in_place(const integer_t* iorder,
+                                  const integer_t* order);
+
+    void permute_in_place(const std::vector<integer_t>& iorder,
+                          const std::vector<integer_t>& order) {
+      permute_in_place(iorder.data(), order.data());
+    }
+
     virtual void permute_columns(const std::vector<integer_t>& perm) = 0;
 
     virtual Equil_t equilibration() const { return Equil_t(this->size()); }
@@ -346,6 +391,15 @@ namespace strumpack {
 
     virtual void symmetrize_sparsity();
 
+    /**
+     * Hash of the sparsity pattern (ptr and ind), independent of
+     * the order of the indices within a row. This is cheap, linear
+     * in nnz, and is used to check that a SymbolicAnalysis matches
+     * the matrix. For a distributed matrix this only hashes the
+     * local rows.
+     */
+    std::uint64_t pattern_hash() const;
+
     virtual void print() const;
     virtual void print_dense(const std::string& name) const {
       std::cerr << "print_dense not implemented for this matrix type"
@@ -386,6 +440,20 @@ namespace strumpack {
                   const std::vector<integer_t>& upd,
                   int depth) const = 0;
     virtual void
+    front_assembly_map(integer_t slo, integer_t shi,
+                       const std::vector<integer_t>& upd,
+                       FrontAssemblyMap<integer_t>& M) const {}
+    void extract_front_mapped(DenseM_t& F11, DenseM_t& F12, DenseM_t& F21,
+                              const FrontAssemblyMap<integer_t>& M) const;
+    void push_front_elements_mapped(const FrontAssemblyMap<integer_t>& M,
+                                    std::vector<Triplet<scalar_t>>& e11,
+                                    std::vector<Triplet<scalar_t>>& e12,
+                                    std::vector<Triplet<scalar_t>>& e21) const;
+    void front_multiply_mapped(integer_t ds,
+                               const FrontAssemblyMap<integer_t>& M,
+                               const DenseM_t& R, DenseM_t& Sr, DenseM_t& Sc,
+                               int depth) const;
+    virtual void
     push_front_elements(integer_t, integer_t, const std::vector<integer_t>&,
                         std::vector<Triplet<scalar_t>>&,
                         std::vector<Triplet<scalar_t>>&,
@@ -47,6 +47,14 @@ namespace strumpack {
     root_ = setup_tree(opts, A, sep_tree, upd, sep_tree.root(), true, 0);
   }
 
+  template<typename scalar_t,typename integer_t>
+  EliminationTree<scalar_t,integer_t>::EliminationTree
+  (const SPOptions<scalar_t>& opts, const SpMat_t& A,
+   SeparatorTree<integer_t>& sep_tree,
+   std::vector<std::vector<integer_t>> upd) {
+    root_ = setup_tree(opts, A, sep_tree, upd, sep_tree.root(), true, 0);
+  }
+
   template<typename scalar_t,typename integer_t>
   EliminationTree<scalar_t,integer_t>::~EliminationTree() {}
 
@@ -56,6 +64,14 @@ namespace strumpack {
     return root_.get();
   }
 
+  template<typename scalar_t,typename integer_t>
+  std::vector<std::vector<integer_t>>
+  EliminationTree<scalar_t,integer_t>::update_indices() const {
+    std::vector<std::vector<integer_t>> upd;
+    root_->update_indices(upd);
+    return upd;
+  }
+
   template<typename scalar_t,typename integer_t> void
   EliminationTree<scalar_t,integer_t>::print_rank_statistics
   (std::ostream &out) const {
@@ -159,6 +175,14 @@ namespace strumpack {
     return root_->multifrontal_factorization(A, opts);
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  EliminationTree<scalar_t,integer_t>::multifrontal_refactorization
+  (const SpMat_t& A, const SPOptions<scalar_t>& opts,
+   const std::vector<bool>& changed, int& refactored) {
+    VectorPool<scalar_t> workspace;
+    return root_->refactor(A, opts, changed, workspace, refactored);
+  }
+
   template<typename scalar_t,typename integer_t> void
   EliminationTree<scalar_t,integer_t>::delete_factors() {
     root_->delete_factors();
@@ -179,6 +203,18 @@ namespace strumpack {
     return max_rank;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::HSS_compression_counts
+  (long long& samples, long long& reused) const {
+    samples = reused = 0;
+    root_->HSS_compression_counts(samples, reused);
+  }
+
+  template<typename scalar_t,typename integer_t> long long
+  EliminationTree<scalar_t,integer_t>::CB_nonzeros() const {
+    return root_->CB_nonzeros();
+  }
+
   template<typename scalar_t,typename integer_t> long long
   EliminationTree<scalar_t,integer_t>::factor_nonzeros() const {
     long long nonzeros;
@@ -55,12 +55,33 @@ namespace strumpack {
     EliminationTree(const SPOptions<scalar_t>& opts,
                     const SpMat_t& A,
                     SeparatorTree<integer_t>& sep_tree);
+
+    /*
+     * Skip the symbolic factorization, use the update indices upd
+     * (for each separator in sep_tree) from an earlier analysis.
+     */
+    EliminationTree(const SPOptions<scalar_t>& opts,
+                    const SpMat_t& A,
+                    SeparatorTree<integer_t>& sep_tree,
+                    std::vector<std::vector<integer_t>> upd);
     virtual ~EliminationTree();
 
     virtual ReturnCode
     multifrontal_factorization(const SpMat_t& A,
                                const SPOptions<scalar_t>& opts);
 
+    /*
+     * Refactor only the fronts affected by the changed rows/columns
+     * (in the permuted ordering of A), see FrontalMatrix::refactor.
+     * On output, refactored is the number of refactored fronts, or
+     * -1 if all fronts were refactored.
+     */
+    virtual ReturnCode
+    multifrontal_refactorization(const SpMat_t& A,
+                                 const SPOptions<scalar_t>& opts,
+                                 const std::vector<bool>& changed,
+                                 int& refactored);
+
     virtual void delete_factors();
 
     virtual void multifrontal_solve(DenseM_t& x) const;
@@ -72,6 +93,8 @@ namespace strumpack {
     virtual integer_t maximum_rank() const;
     virtual long long factor_nonzeros() const;
     virtual long long dense_factor_nonzeros() const;
+    void HSS_compression_counts(long long& samples, long long& reused) const;
+    long long CB_nonzeros() const;
 
     virtual ReturnCode inertia(integer_t& neg,
                                integer_t& zero,
@@ -87,6 +110,12 @@ namespace strumpack {
 
     F_t* root() const;
 
+    /*
+     * Copy of the update indices of all fronts, indexed by the
+     * separator number.
+     */
+    std::vector<std::vector<integer_t>> update_indices() const;
+
   protected:
     FrontCounter nr_fronts_;
     std::unique_ptr<F_t> root_;
@@ -66,6 +66,15 @@ namespace strumpack {
     ReturnCode
     multifrontal_factorization(const CompressedSparseMatrix<scalar_t,integer_t>& A,
                                const Opts_t& opts) override;
+    ReturnCode
+    multifrontal_refactorization(const CompressedSparseMatrix<scalar_t,integer_t>& A,
+                                 const Opts_t& opts,
+                                 const std::vector<bool>& changed,
+                                 int& refactored) override {
+      // distributed fronts do not keep their contribution blocks
+      refactored = -1;
+      return multifrontal_factorization(A, opts);
+    }
 
     void multifrontal_solve_dist(DenseM_t& x,
                                  const std::vector<integer_t>& dist) override;
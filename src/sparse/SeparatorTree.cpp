@@ -330,6 +330,58 @@ namespace strumpack {
     return top;
   }
 
+  template<typename integer_t> bool
+  check_sep_tree_ordering(const SeparatorTree<integer_t>& tree,
+                          const std::vector<integer_t>& perm,
+                          const integer_t* ptr, const integer_t* ind,
+                          integer_t lo, integer_t hi) {
+    integer_t n = perm.size(), nsep = tree.separators();
+    if (!nsep || tree.sizes[0] != 0 || tree.sizes[nsep] != n ||
+        tree.parent[nsep-1] != -1)
+      return false;
+    // first[s] is the first vertex in the subtree rooted at s
+    std::vector<integer_t> first(nsep);
+    for (integer_t s=0; s<nsep; s++) {
+      auto l = tree.lch[s], r = tree.rch[s];
+      if (tree.sizes[s+1] < tree.sizes[s] ||
+          (s != nsep-1 && (tree.parent[s] <= s || tree.parent[s] >= nsep)))
+        return false;
+      if (l == -1 && r == -1) first[s] = tree.sizes[s];
+      else {
+        if (l < 0 || r < 0 || l >= s || r >= s ||
+            tree.parent[l] != s || tree.parent[r] != s ||
+            tree.sizes[l+1] != first[r] || tree.sizes[r+1] != tree.sizes[s])
+          return false;
+        first[s] = first[l];
+      }
+    }
+    std::vector<integer_t> sep(n, -1);
+    for (integer_t s=0; s<nsep; s++)
+      std::fill(sep.begin()+tree.sizes[s], sep.begin()+tree.sizes[s+1], s);
+    // check that perm is a permutation, marking visited entries
+    for (integer_t i=0; i<n; i++) {
+      auto pi = perm[i];
+      if (pi < 0 || pi >= n || sep[pi] < 0) return false;
+      sep[pi] = -sep[pi] - 1;
+    }
+    for (auto& s : sep) s = -s - 1;
+    bool ok = true;
+#pragma omp parallel for reduction(&&:ok)
+    for (integer_t r=lo; r<hi; r++) {
+      auto i = perm[r];
+      auto si = sep[i];
+      for (integer_t k=ptr[r-lo]; k<ptr[r-lo+1]; k++) {
+        auto j = perm[ind[k]];
+        auto sj = sep[j];
+        // si is an ancestor of sj, or the other way around
+        if (!((first[si] <= j && j < tree.sizes[si+1]) ||
+              (first[sj] <= i && i < tree.sizes[sj+1])))
+          ok = false;
+      }
+    }
+    return ok;
+  }
+
   template<typename integer_t> std::vector<integer_t>
   etree_postorder(const std::vector<integer_t>& etree) {
     integer_t n = etree.size();
@@ -601,6 +653,18 @@ namespace strumpack {
              const long long int* arow, long long int n,
              long long int subgraph_begin);
 
+  template bool check_sep_tree_ordering
+  (const SeparatorTree<int>& tree, const std::vector<int>& perm,
+   const int* ptr, const int* ind, int lo, int hi);
+  template bool check_sep_tree_ordering
+  (const SeparatorTree<long int>& tree, const std::vector<long int>& perm,
+   const long int* ptr, const long int* ind, long int lo, long int hi);
+  template bool check_sep_tree_ordering
+  (const SeparatorTree<long long int>& tree,
+   const std::vector<long long int>& perm,
+   const long long int* ptr, const long long int* ind,
+   long long int lo, long long int hi);
+
   template std::vector<int>
   etree_postorder(const std::vector<int>& etree);
   template std::vector<long int>
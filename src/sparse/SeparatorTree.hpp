@@ -31,6 +31,7 @@
 
 #include <vector>
 #include <memory>
+#include <algorithm>
 #if defined(STRUMPACK_USE_MPI)
 #include "misc/MPIWrapper.hpp"
 #endif
@@ -60,6 +61,20 @@ namespace strumpack {
     SeparatorTree(integer_t nr_nodes);
     SeparatorTree(const std::vector<Separator<integer_t>>& seps);
 
+    // sizes, parent, lch and rch point into iwork_, so a copy needs
+    // to reset them, a move keeps the buffer
+    SeparatorTree(const SeparatorTree<integer_t>& t) { *this = t; }
+    SeparatorTree(SeparatorTree<integer_t>&& t) = default;
+    SeparatorTree<integer_t>& operator=(const SeparatorTree<integer_t>& t) {
+      if (this != &t) {
+        allocate(t.nr_seps_);
+        std::copy(t.iwork_.begin(), t.iwork_.end(), iwork_.begin());
+        root_ = t.root_;
+      }
+      return *this;
+    }
+    SeparatorTree<integer_t>& operator=(SeparatorTree<integer_t>&& t) = default;
+
     integer_t levels() const;
     integer_t level(integer_t i) const;
     integer_t root() const;
@@ -153,6 +168,22 @@ namespace strumpack {
              integer_t n,                  // dimension of A
              integer_t subgraph_begin=0);  // first row/column of subgraph
 
+  /**
+   * Check whether a (user supplied) separator tree can be used with
+   * the permutation perm, where perm[i] is the new index of
+   * row/column i, for the graph rows [lo, hi) stored in (ptr, ind),
+   * with global column indices. The tree should be postordered, and
+   * the vertices of separator s should be numbered sizes[s],
+   * .. sizes[s+1]-1 in the permuted ordering. The end points of every
+   * edge should then be in the same separator, or in separators
+   * where one is an ancestor of the other.
+   */
+  template<typename integer_t> bool
+  check_sep_tree_ordering(const SeparatorTree<integer_t>& tree,
+                          const std::vector<integer_t>& perm,
+                          const integer_t* ptr, const integer_t* ind,
+                          integer_t lo, integer_t hi);
+
   template<typename integer_t>
   std::vector<integer_t>
   etree_postorder(const std::vector<integer_t>& etree);
@@ -0,0 +1,188 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*!
+ * \file SymbolicAnalysis.hpp
+ * \brief Contains the SymbolicAnalysis class, the scalar type
+ * independent result of SparseSolver::reorder.
+ */
+#ifndef STRUMPACK_SYMBOLIC_ANALYSIS_HPP
+#define STRUMPACK_SYMBOLIC_ANALYSIS_HPP
+
+#include <vector>
+#include <cstdint>
+
+#include "StrumpackOptions.hpp"
+#include "sparse/SeparatorTree.hpp"
+#include "sparse/CompressedSparseMatrix.hpp"
+
+namespace strumpack {
+
+  /**
+   * \class SymbolicAnalysis
+   *
+   * \brief Result of the analysis phase (SparseSolver::reorder) of
+   * the sparse solver.
+   *
+   * This contains the column permutation and scaling from the
+   * matching, the fill-reducing permutation, the separator tree and
+   * the symbolic factorization (the update indices of each
+   * front). None of this depends on the scalar type, so it can be
+   * exported from a solver with SparseSolver::symbolic_analysis(),
+   * and imported with SparseSolver::reorder(analysis) by other
+   * solvers for matrices with the same sparsity pattern, with the
+   * same or a different scalar type (float, double, complex), but
+   * with the same integer type. The object is immutable, and is
+   * shared (not copied) between the solvers.
+   *
+   * The scaling from the matching (MatchingJob::
+   * MAX_DIAGONAL_PRODUCT_SCALING) was computed for the values of the
+   * matrix in the solver that did the analysis. It is reused as is
+   * for the other matrices, which is still correct, but can be less
+   * effective if the values are very different.
+   *
+   * \tparam integer_t Integer type used for the sparse matrix, the
+   * permutations and the index sets.
+   */
+  template<typename integer_t> class SymbolicAnalysis {
+  public:
+    /**
+     * Construct the symbolic analysis, this is called by the sparse
+     * solver, there should be no need to call this directly.
+     *
+     * \param nnz number of nonzeros in the matrix, after
+     * symmetrization of the sparsity pattern
+     * \param hash hash of the symmetrized sparsity pattern, before
+     * the fill reducing permutation, see
+     * CompressedSparseMatrix::pattern_hash
+     * \param job matching job used
+     * \param Q column permutation from the matching
+     * \param R row scaling from the matching
+     * \param C column scaling from the matching
+     * \param perm fill reducing permutation
+     * \param iperm inverse of perm
+     * \param tree separator tree, corresponding to perm
+     * \param upd for every separator in tree, the (sorted) indices
+     * of its update (contribution) block
+     */
+    SymbolicAnalysis(integer_t nnz, std::uint64_t hash, MatchingJob job,
+                     std::vector<integer_t> Q,
+                     std::vector<double> R, std::vector<double> C,
+                     std::vector<integer_t> perm,
+                     std::vector<integer_t> iperm,
+                     SeparatorTree<integer_t> tree,
+                     std::vector<std::vector<integer_t>> upd)
+      : nnz_(nnz), hash_(hash), job_(job), Q_(std::move(Q)),
+        R_(std::move(R)), C_(std::move(C)),
+        perm_(std::move(perm)), iperm_(std::move(iperm)),
+        tree_(std::move(tree)), upd_(std::move(upd)) {}
+
+    /**
+     * Number of rows/columns of the matrix.
+     */
+    integer_t size() const { return perm_.size(); }
+
+    /**
+     * Number of nonzeros of the matrix, after symmetrization of the
+     * sparsity pattern.
+     */
+    integer_t nnz() const { return nnz_; }
+
+    /**
+     * Hash of the sparsity pattern of the matrix, after
+     * symmetrization and before the fill reducing permutation. A
+     * matrix with the same size and number of nonzeros, but a
+     * different pattern, is rejected on import.
+     */
+    std::uint64_t pattern_hash() const { return hash_; }
+
+    /**
+     * Matching job that was used during the analysis.
+     */
+    MatchingJob matching_job() const { return job_; }
+
+    /**
+     * Get the matching (column permutation and scaling), converted
+     * to the real type of scalar_t.
+     */
+    template<typename scalar_t> MatchingData<scalar_t,integer_t>
+    matching() const {
+      MatchingData<scalar_t,integer_t> M(job_, size());
+      M.Q = Q_;
+      std::copy(R_.begin(), R_.end(), M.R.begin());
+      std::copy(C_.begin(), C_.end(), M.C.begin());
+      return M;
+    }
+
+    /**
+     * Fill reducing permutation.
+     */
+    const std::vector<integer_t>& perm() const { return perm_; }
+
+    /**
+     * Inverse of the fill reducing permutation.
+     */
+    const std::vector<integer_t>& iperm() const { return iperm_; }
+
+    /**
+     * The separator tree, corresponding to perm().
+     */
+    const SeparatorTree<integer_t>& tree() const { return tree_; }
+
+    /**
+     * Update indices for each separator in tree().
+     */
+    const std::vector<std::vector<integer_t>>& upd() const {
+      return upd_;
+    }
+
+    /**
+     * Memory used by this object, in bytes.
+     */
+    std::size_t memory() const {
+      std::size_t m = (Q_.size() + perm_.size() + iperm_.size() +
+                       4*tree_.separators() + 1) * sizeof(integer_t)
+        + (R_.size() + C_.size()) * sizeof(double);
+      for (auto& u : upd_) m += u.size() * sizeof(integer_t);
+      return m;
+    }
+
+  private:
+    integer_t nnz_;
+    std::uint64_t hash_;
+    MatchingJob job_;
+    std::vector<integer_t> Q_;
+    std::vector<double> R_, C_;
+    std::vector<integer_t> perm_, iperm_;
+    SeparatorTree<integer_t> tree_;
+    std::vector<std::vector<integer_t>> upd_;
+  };
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_SYMBOLIC_ANALYSIS_HPP
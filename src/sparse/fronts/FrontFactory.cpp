@@ -28,11 +28,13 @@
  */
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 
 #include "FrontFactory.hpp"
 
 #include "sparse/CSRGraph.hpp"
 #include "FrontalMatrixDense.hpp"
+#include "FrontalMatrixMixedPrecision.hpp"
 #include "FrontalMatrixHSS.hpp"
 #include "FrontalMatrixBLR.hpp"
 #if defined(STRUMPACK_USE_BPACK)
@@ -61,6 +63,129 @@
 
 namespace strumpack {
 
+  // dense: LU of F11, triangular solves for F12/F21, Schur update
+  static FrontCost dense_front_cost(double s, double u) {
+    FrontCost c;
+    c.flops = 2./3. * s*s*s + 2. * s*s*u + 2. * s*u*u;
+    c.memory = s*s + 2. * s*u;
+    return c;
+  }
+
+  // Low-rank kernels run at a lower flop rate than dense LU/GEMM, so
+  // the flop counts of the compressed formats are scaled by these
+  // (rough) inefficiency factors, only to rank the formats. The
+  // returned flops are the unweighted estimate.
+  static const double blr_penalty = 2., hss_penalty = 8.;
+
+  // number of digits requested, the ranks grow with this
+  static double digits(double tol) {
+    return std::max(1., std::log10(1. / std::max(tol, 1e-16)));
+  }
+
+  // BLR: tiles of size b, admissible tiles of rank r. Without a
+  // measured rank (r < 0), r ~ log(b).
+  template<typename scalar_t> static FrontCost blr_front_cost
+  (double s, double u, const SPOptions<scalar_t>& opts, double r) {
+    double b = std::min(s, double(opts.BLR_options().tile_size(s + u)));
+    if (r < 0)
+      r = std::min(b / 2., digits(opts.BLR_options().rel_tol())
+                   * std::log2(std::max(b, 2.)));
+    FrontCost c;
+    c.type = CompressionType::BLR;
+    c.flops = 2./3. * s*b*b + s*s*r + 8./3. * s*s*s*r*r / (b*b)
+      + 2. * (s*s*u + s*u*u) * r / b  // F12, F21 and F22 updates
+      + 4. * (s*s + 2.*s*u) * r;      // tile compression
+    c.memory = s*b + 2. * (s*s + 2.*s*u) * r / b;
+    return c;
+  }
+
+  template<typename scalar_t> bool blr_pays_off
+  (int dsep, int dupd, const SPOptions<scalar_t>& opts, double rank) {
+    return blr_front_cost(dsep, dupd, opts, rank).flops * blr_penalty
+      < dense_front_cost(dsep, dupd).flops;
+  }
+
+  template<typename scalar_t> FrontCost auto_front_cost
+  (int dsep, int dupd, bool compressed_parent,
+   const SPOptions<scalar_t>& opts) {
+    double s = dsep, u = dupd, m = s + u;
+    auto c = dense_front_cost(s, u);
+    if (!dsep) return c;
+    double best = c.flops;
+    auto eligible = [&](int min_sep, int min_front) {
+      return dsep >= min_sep || dsep + dupd >= min_front;
+    };
+    if (eligible(opts.blr_min_sep_size(), opts.blr_min_front_size())) {
+      auto blr = blr_front_cost(s, u, opts, -1.);
+      if (blr.flops * blr_penalty < best) {
+        best = blr.flops * blr_penalty;
+        c = blr;
+      }
+    }
+#if defined(STRUMPACK_USE_BPACK)
+    // HSS and HODLR fronts cannot be nested, prefer HODLR when
+    // available, as with CompressionType::BLR_HODLR
+    if (eligible(opts.hodlr_min_sep_size(), opts.hodlr_min_front_size())) {
+      // top level rank grows as sqrt of the size of the (2D) separator
+      double l = opts.HODLR_options().leaf_size(),
+        r = std::min(m / 2., digits(opts.HODLR_options().rel_tol())
+                     * std::sqrt(m));
+      double levels = std::max(1., std::log2(m / l));
+      double f = 2. * m*m * r  // sampling of the front
+        + 8. * m * r*r * levels + m * l*l;
+      if (f * hss_penalty < best) {
+        best = f * hss_penalty;
+        c.type = CompressionType::HODLR;
+        c.flops = f;
+        c.memory = 2. * s * r * levels + s * l + 2. * s*u * r / l;
+      }
+    }
+#else
+    if (compressed_parent &&
+        eligible(opts.hss_min_sep_size(), opts.hss_min_front_size())) {
+      // top level rank grows as sqrt of the size of the (2D) separator
+      double l = opts.HSS_options().leaf_size(),
+        r = std::min(m / 2., digits(opts.HSS_options().rel_tol())
+                     * std::sqrt(m)),
+        d = r + opts.HSS_options().p();
+      double f = 2. * m*m * d  // random sampling of the front
+        + 20. * m * d*d + m * l*l;
+      if (f * hss_penalty < best) {
+        best = f * hss_penalty;
+        c.type = CompressionType::HSS;
+        c.flops = f;
+        c.memory = 4. * m * r + m * l;
+      }
+    }
+#endif
+    return c;
+  }
+
+  template FrontCost auto_front_cost
+  (int dsep, int dupd, bool compressed_parent,
+   const SPOptions<float>& opts);
+  template FrontCost auto_front_cost
+  (int dsep, int dupd, bool compressed_parent,
+   const SPOptions<double>& opts);
+  template FrontCost auto_front_cost
+  (int dsep, int dupd, bool compressed_parent,
+   const SPOptions<std::complex<float>>& opts);
+  template FrontCost auto_front_cost
+  (int dsep, int dupd, bool compressed_parent,
+   const SPOptions<std::complex<double>>& opts);
+
+  template bool blr_pays_off
+  (int dsep, int dupd, const SPOptions<float>& opts, double rank);
+  template bool blr_pays_off
+  (int dsep, int dupd, const SPOptions<double>& opts, double rank);
+  template bool blr_pays_off
+  (int dsep, int dupd, const SPOptions<std::complex<float>>& opts,
+   double rank);
+  template bool blr_pays_off
+  (int dsep, int dupd, const SPOptions<std::complex<double>>& opts,
+   double rank);
+
+
   template<typename scalar_t, typename integer_t>
   std::unique_ptr<FrontalMatrix<scalar_t,integer_t>> create_frontal_matrix
   (const SPOptions<scalar_t>& opts, integer_t s, integer_t sbegin,
@@ -153,12 +278,56 @@ namespace strumpack {
 #endif
       }
     } break;
+    case CompressionType::AUTO: {
+      auto c = auto_front_cost(dsep, dupd, compressed_parent, opts);
+      switch (c.type) {
+      case CompressionType::HSS:
+        front.reset
+          (new FrontalMatrixHSS<scalar_t,integer_t>(s, sbegin, send, upd));
+        if (root) fc.HSS++;
+        break;
+      case CompressionType::NONE:
+        // the estimated rank can be too pessimistic, let a BLR front
+        // measure the rank once it is assembled
+        if (dsep && (dsep >= opts.blr_min_sep_size() ||
+                     dsep + integer_t(dupd) >= opts.blr_min_front_size())) {
+          front.reset
+            (new FrontalMatrixBLR<scalar_t,integer_t>(s, sbegin, send, upd));
+          if (root) fc.BLR++;
+        }
+        break;
+      case CompressionType::BLR:
+        front.reset
+          (new FrontalMatrixBLR<scalar_t,integer_t>(s, sbegin, send, upd));
+        if (root) fc.BLR++;
+        break;
+#if defined(STRUMPACK_USE_BPACK)
+      case CompressionType::HODLR:
+        front.reset
+          (new FrontalMatrixHODLR<scalar_t,integer_t>(s, sbegin, send, upd));
+        if (root) fc.HODLR++;
+        break;
+#endif
+      default: break;
+      }
+      if (root) {
+        fc.flops += c.flops;
+        fc.memory += c.memory;
+      }
+    } break;
     };
     if (!front) {
       // fallback in case support for cublas/zfp/hodlr is missing
-      front.reset
-        (new FrontalMatrixDense<scalar_t,integer_t>(s, sbegin, send, upd));
-      if (root) fc.dense++;
+      if (is_mixed_precision(dsep, opts)) {
+        front.reset
+          (new FrontalMatrixMixedPrecision<scalar_t,integer_t>
+           (s, sbegin, send, upd));
+        if (root) fc.mixed++;
+      } else {
+        front.reset
+          (new FrontalMatrixDense<scalar_t,integer_t>(s, sbegin, send, upd));
+        if (root) fc.dense++;
+      }
     }
     return front;
   }
@@ -256,23 +425,24 @@ namespace strumpack {
       }
     } break;
     case CompressionType::HODLR: {
-      if (is_HODLR(dsep, dupd, compressed_parent, opts)) {
 #if defined(STRUMPACK_USE_BPACK)
+      if (is_HODLR(dsep, dupd, compressed_parent, opts)) {
         front.reset
           (new FrontalMatrixHODLRMPI<scalar_t,integer_t>
            (s, sbegin, send, upd, comm, P));
         if (root) fc.HODLR++;
-#endif
       }
+#endif
     } break;
     case CompressionType::BLR_HODLR: {
-      if (is_HODLR(dsep, dupd, compressed_parent, opts, 0)) {
 #if defined(STRUMPACK_USE_BPACK)
+      if (is_HODLR(dsep, dupd, compressed_parent, opts, 0)) {
         front.reset
           (new FrontalMatrixHODLRMPI<scalar_t,integer_t>(s, sbegin, send, upd, comm, P));
         if (root) fc.HODLR++;
+      } else
 #endif
-      } else if (is_BLR(dsep, dupd, compressed_parent, opts, 1)) {
+      if (is_BLR(dsep, dupd, compressed_parent, opts, 1)) {
         front.reset
           (new FrontalMatrixBLRMPI<scalar_t,integer_t>
            (s, sbegin, send, upd, comm, P, opts.BLR_options().leaf_size()));
@@ -280,19 +450,55 @@ namespace strumpack {
       }
     } break;
     case CompressionType::ZFP_BLR_HODLR: {
-      if (is_HODLR(dsep, dupd, compressed_parent, opts, 0)) {
 #if defined(STRUMPACK_USE_BPACK)
+      if (is_HODLR(dsep, dupd, compressed_parent, opts, 0)) {
         front.reset
           (new FrontalMatrixHODLRMPI<scalar_t,integer_t>(s, sbegin, send, upd, comm, P));
         if (root) fc.HODLR++;
+      } else
 #endif
-      } else if (is_BLR(dsep, dupd, compressed_parent, opts, 1)) {
+      if (is_BLR(dsep, dupd, compressed_parent, opts, 1)) {
         front.reset
           (new FrontalMatrixBLRMPI<scalar_t,integer_t>
            (s, sbegin, send, upd, comm, P, opts.BLR_options().leaf_size()));
         if (root) fc.BLR++;
       }
     } break;
+    case CompressionType::AUTO: {
+      auto c = auto_front_cost(dsep, dupd, compressed_parent, opts);
+      switch (c.type) {
+      case CompressionType::HSS:
+        front.reset
+          (new FrontalMatrixHSSMPI<scalar_t,integer_t>
+           (s, sbegin, send, upd, comm, P));
+        if (root) fc.HSS++;
+        break;
+      case CompressionType::BLR:
+        // FrontalMatrixBLRMPI cannot be sampled by an HSS parent
+        if (compressed_parent && level > 0) {
+          c = dense_front_cost(dsep, dupd);
+          break;
+        }
+        front.reset
+          (new FrontalMatrixBLRMPI<scalar_t,integer_t>
+           (s, sbegin, send, upd, comm, P, opts.BLR_options().leaf_size()));
+        if (root) fc.BLR++;
+        break;
+#if defined(STRUMPACK_USE_BPACK)
+      case CompressionType::HODLR:
+        front.reset
+          (new FrontalMatrixHODLRMPI<scalar_t,integer_t>
+           (s, sbegin, send, upd, comm, P));
+        if (root) fc.HODLR++;
+        break;
+#endif
+      default: break;
+      }
+      if (root) {
+        fc.flops += c.flops;
+        fc.memory += c.memory;
+      }
+    } break;
     case CompressionType::LOSSY: // handled in DenseMPI
     case CompressionType::LOSSLESS: // handled in DenseMPI
     case CompressionType::NONE: break;
@@ -30,6 +30,7 @@
 #define FRONT_FACTORY_HPP
 
 #include <array>
+#include <type_traits>
 
 #include "StrumpackConfig.hpp"
 #if defined(STRUMPACK_USE_MPI)
@@ -41,19 +42,70 @@
 namespace strumpack {
 
   struct FrontCounter {
-    int dense, HSS, BLR, HODLR, lossy;
-    FrontCounter() : dense(0), HSS(0), BLR(0), HODLR(0), lossy(0) {}
-    FrontCounter(int* c) :
-      dense(c[0]), HSS(c[1]), BLR(c[2]), HODLR(c[3]), lossy(c[4]) {}
+    // mixed: dense fronts factored in lower precision
+    int dense, HSS, BLR, HODLR, lossy, mixed;
+    // predicted factorization flops and factor nonzeros, only
+    // accumulated with CompressionType::AUTO
+    double flops, memory;
+    FrontCounter() : dense(0), HSS(0), BLR(0), HODLR(0), lossy(0),
+                     mixed(0), flops(0.), memory(0.) {}
+    FrontCounter(int* c, double* p) :
+      dense(c[0]), HSS(c[1]), BLR(c[2]), HODLR(c[3]), lossy(c[4]),
+      mixed(c[5]), flops(p[0]), memory(p[1]) {}
+    int total() const { return dense + HSS + BLR + HODLR + lossy + mixed; }
 #if defined(STRUMPACK_USE_MPI)
     FrontCounter reduce(const MPIComm& comm) const {
-      std::array<int,5> w = {dense, HSS, BLR, HODLR, lossy};
+      std::array<int,6> w = {dense, HSS, BLR, HODLR, lossy, mixed};
+      std::array<double,2> p = {flops, memory};
       comm.reduce(w.data(), w.size(), MPI_SUM);
-      return FrontCounter(w.data());
+      comm.reduce(p.data(), p.size(), MPI_SUM);
+      return FrontCounter(w.data(), p.data());
     }
 #endif
   };
 
+  /**
+   * Predicted cost of a single front, used with
+   * CompressionType::AUTO. type is the selected representation
+   * (NONE for dense), flops is the estimated number of flops for
+   * the partial factorization and memory the estimated number of
+   * nonzeros in the factors. The formats are ranked on flops scaled
+   * by a per format inefficiency factor, but flops itself is not
+   * scaled, so it can be compared to the actual flop count.
+   */
+  struct FrontCost {
+    CompressionType type = CompressionType::NONE;
+    double flops = 0., memory = 0.;
+  };
+
+  /**
+   * Select the cheapest representation for a front with separator
+   * size dsep and update size dupd, based on a flop model for each
+   * format and an estimate of the off-diagonal ranks derived from
+   * the front size and the compression tolerances. Only formats
+   * which are available in this build, and which can be nested in
+   * the parent front, are considered. An HSS front requires an HSS
+   * parent (compressed_parent). The fronts are created before they
+   * are assembled, so the ranks can not be measured here. Instead,
+   * (sequential) fronts which are large enough for BLR are created
+   * as BLR fronts, which measure the rank of the assembled front
+   * and only compress when that pays off, see blr_pays_off.
+   */
+  template<typename scalar_t> FrontCost auto_front_cost
+  (int dsep, int dupd, bool compressed_parent,
+   const SPOptions<scalar_t>& opts);
+
+  /**
+   * Whether a BLR front with separator size dsep and update size
+   * dupd, with off-diagonal tiles of rank rank, is predicted to be
+   * cheaper than a dense front, using the same cost model as
+   * auto_front_cost. Used by a BLR front selected with
+   * CompressionType::AUTO, once the rank has been measured on the
+   * assembled front.
+   */
+  template<typename scalar_t> bool blr_pays_off
+  (int dsep, int dupd, const SPOptions<scalar_t>& opts, double rank);
+
   template<typename scalar_t> bool is_GPU
   (const SPOptions<scalar_t>& opts) {
 #if defined(STRUMPACK_USE_CUDA) || defined(STRUMPACK_USE_HIP) || defined(STRUMPACK_USE_SYCL)
@@ -64,6 +116,9 @@ namespace strumpack {
   template<typename scalar_t> bool is_HSS
   (int dsep, int dupd, bool compressed_parent,
    const SPOptions<scalar_t>& opts) {
+    if (opts.compression() == CompressionType::AUTO)
+      return auto_front_cost(dsep, dupd, compressed_parent, opts).type
+        == CompressionType::HSS;
     return opts.compression() == CompressionType::HSS &&
       compressed_parent &&
       (dsep >= opts.compression_min_sep_size() ||
@@ -72,6 +127,9 @@ namespace strumpack {
   template<typename scalar_t> bool is_BLR
   (int dsep, int dupd, bool compressed_parent,
    const SPOptions<scalar_t>& opts, int l=0) {
+    if (opts.compression() == CompressionType::AUTO)
+      return auto_front_cost(dsep, dupd, compressed_parent, opts).type
+        == CompressionType::BLR;
     return (opts.compression() == CompressionType::BLR ||
             opts.compression() == CompressionType::BLR_HODLR ||
             opts.compression() == CompressionType::ZFP_BLR_HODLR) &&
@@ -82,6 +140,9 @@ namespace strumpack {
   (int dsep, int dupd, bool compressed_parent,
    const SPOptions<scalar_t>& opts, int l=0) {
 #if defined(STRUMPACK_USE_BPACK)
+    if (opts.compression() == CompressionType::AUTO)
+      return auto_front_cost(dsep, dupd, compressed_parent, opts).type
+        == CompressionType::HODLR;
     return (opts.compression() == CompressionType::HODLR ||
             opts.compression() == CompressionType::BLR_HODLR ||
             opts.compression() == CompressionType::ZFP_BLR_HODLR) &&
@@ -103,9 +164,22 @@ namespace strumpack {
     return false;
 #endif
   }
+  template<typename scalar_t> bool is_mixed_precision
+  (int dsep, const SPOptions<scalar_t>& opts) {
+    // only for double precision, float has no lower precision
+    return opts.mixed_precision_fronts() && !is_GPU(opts) &&
+      dsep < opts.mixed_precision_sep_size() &&
+      !std::is_same<scalar_t,typename LowerPrecisionType<scalar_t>::
+                    value_type>::value;
+  }
   template<typename scalar_t> bool is_compressed
   (int dsep, int dupd, bool compressed_parent,
    const SPOptions<scalar_t>& opts) {
+    // this is passed as compressed_parent to the children. With
+    // AUTO, only HSS fronts can have HSS children, BLR/HODLR fronts
+    // cannot assemble from an HSS contribution block.
+    if (opts.compression() == CompressionType::AUTO)
+      return is_HSS(dsep, dupd, compressed_parent, opts);
     return opts.compression() != CompressionType::NONE &&
       (is_HSS(dsep, dupd, compressed_parent, opts) ||
        is_BLR(dsep, dupd, compressed_parent, opts, 1) ||
@@ -256,7 +256,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontSYCL<scalar_t,integer_t>::extend_add_to_dense
   (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
-   const F_t* p, int task_depth) {
+   const F_t* p, int etree_level, int task_depth) {
     const std::size_t pdsep = paF11.rows();
     const std::size_t dupd = dim_upd();
     std::size_t upd2sep;
@@ -744,12 +744,14 @@ namespace strumpack {
     if (lchild_) {
 #pragma omp parallel
 #pragma omp single
-      lchild_->extend_add_to_dense(F11_, F12_, F21_, F22_, this, 0);
+      lchild_->extend_add_to_dense
+        (F11_, F12_, F21_, F22_, this, etree_level+1, 0);
     }
     if (rchild_) {
 #pragma omp parallel
 #pragma omp single
-      rchild_->extend_add_to_dense(F11_, F12_, F21_, F22_, this, 0);
+      rchild_->extend_add_to_dense
+        (F11_, F12_, F21_, F22_, this, etree_level+1, 0);
     }
     TaskTimer tl("");
     tl.start();
@@ -210,6 +210,22 @@ namespace strumpack {
     return std::max(r, std::max(rl, rr));
   }
 
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrix<scalar_t,integer_t>::HSS_compression_counts
+  (long long& samples, long long& reused) const {
+    node_HSS_compression_counts(samples, reused);
+    if (lchild_) lchild_->HSS_compression_counts(samples, reused);
+    if (rchild_) rchild_->HSS_compression_counts(samples, reused);
+  }
+
+  template<typename scalar_t,typename integer_t> long long
+  FrontalMatrix<scalar_t,integer_t>::CB_nonzeros() const {
+    long long nnz = node_CB_nonzeros();
+    if (lchild_) nnz += lchild_->CB_nonzeros();
+    if (rchild_) nnz += rchild_->CB_nonzeros();
+    return nnz;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontalMatrix<scalar_t,integer_t>::multifrontal_solve(DenseM_t& b) const {
     auto max_dupd = max_dim_upd();
@@ -616,9 +632,23 @@ namespace strumpack {
     for (integer_t i=0; i<dim_upd(); i++)
       upd_[i] = perm[upd_[i]];
     std::sort(upd_.begin(), upd_.end());
+    amap_.clear();
 #pragma omp taskwait
   }
 
+  template<typename scalar_t,typename integer_t>
+  const FrontAssemblyMap<integer_t>*
+  FrontalMatrix<scalar_t,integer_t>::assembly_map
+  (const SpMat_t& A, const Opts_t& opts) {
+    if (!opts.use_assembly_map()) return nullptr;
+    if (!amap_.built_for(A.nnz())) {
+      // the permutation or the sparsity pattern changed
+      A.front_assembly_map(sep_begin_, sep_end_, upd_, amap_);
+      if (!amap_.built_for(A.nnz())) return nullptr;
+    }
+    return &amap_;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontalMatrix<scalar_t,integer_t>::get_level_fronts
   (std::vector<const F_t*>& ldata, int elvl, int l) const {
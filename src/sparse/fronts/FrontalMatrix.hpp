@@ -105,6 +105,25 @@ namespace strumpack {
       return multifrontal_factorization(A, opts, etree_level, task_depth);
     };
 
+    /**
+     * Refactor this subtree after a change of the values of A, where
+     * changed[i] is true when a nonzero in row or column i, with i
+     * the smallest of the row/column index, has changed. Only fronts
+     * with a changed separator, or with a refactored child, need to
+     * be refactored, the others keep their factors and contribution
+     * block. On output, refactored is the number of fronts in this
+     * subtree which were refactored, 0 when this front kept its
+     * factors. By default the whole subtree is refactored.
+     */
+    virtual ReturnCode refactor(const SpMat_t& A, const Opts_t& opts,
+                                const std::vector<bool>& changed,
+                                VectorPool<scalar_t>& workspace,
+                                int& refactored,
+                                int etree_level=0, int task_depth=0) {
+      refactored = fronts();
+      return factor(A, opts, workspace, etree_level, task_depth);
+    }
+
     virtual void delete_factors() {}
 
     virtual void multifrontal_solve(DenseM_t& b) const;
@@ -139,7 +158,7 @@ namespace strumpack {
     extend_add_to_dense(DenseM_t& paF11, DenseM_t& paF12,
                         DenseM_t& paF21, DenseM_t& paF22,
                         const FrontalMatrix<scalar_t,integer_t>* p,
-                        int task_depth) {
+                        int etree_level, int task_depth) {
       assert(false);
     }
     virtual void
@@ -147,8 +166,9 @@ namespace strumpack {
                         DenseM_t& paF21, DenseM_t& paF22,
                         const FrontalMatrix<scalar_t,integer_t>* p,
                         VectorPool<scalar_t>& workspace,
-                        int task_depth) {
-      extend_add_to_dense(paF11, paF12, paF21, paF22, p, task_depth);
+                        int etree_level, int task_depth) {
+      extend_add_to_dense
+        (paF11, paF12, paF21, paF22, p, etree_level, task_depth);
     }
 
     virtual void
@@ -211,6 +231,17 @@ namespace strumpack {
 
     virtual long long factor_nonzeros(int task_depth=0) const;
     virtual long long dense_factor_nonzeros(int task_depth=0) const;
+    // random samples drawn, and HSS nodes reused by the warm start,
+    // in the last compression of the HSS fronts in this subtree
+    void HSS_compression_counts(long long& samples, long long& reused) const;
+    virtual void node_HSS_compression_counts
+    (long long& samples, long long& reused) const {}
+    // entries stored for the contribution blocks of this subtree in
+    // the last factorization, dense unless BLR CB compression is used
+    long long CB_nonzeros() const;
+    virtual long long node_CB_nonzeros() const {
+      return (long long)(dim_upd()) * dim_upd();
+    }
     virtual bool isHSS() const { return false; }
     virtual bool isMPI() const { return false; }
     virtual void print_rank_statistics(std::ostream &out) const {}
@@ -228,9 +259,26 @@ namespace strumpack {
       return std::max(ll, lr) + 1;
     }
 
+    // number of fronts in the subtree rooted at this front
+    int fronts() const {
+      int n = 1;
+      if (lchild_) n += lchild_->fronts();
+      if (rchild_) n += rchild_->fronts();
+      return n;
+    }
+
     void set_lchild(std::unique_ptr<F_t> ch) { lchild_ = std::move(ch); }
     void set_rchild(std::unique_ptr<F_t> ch) { rchild_ = std::move(ch); }
 
+    // copy the update indices of this front and its descendants to
+    // upd[sep_]
+    void update_indices(std::vector<std::vector<integer_t>>& upd) const {
+      if (integer_t(upd.size()) <= sep_) upd.resize(sep_+1);
+      upd[sep_] = upd_;
+      if (lchild_) lchild_->update_indices(upd);
+      if (rchild_) rchild_->update_indices(upd);
+    }
+
     // TODO compute this (and levels) once, store it
     // maybe compute it when setting pointers to the children
     // create setters/getters for the children
@@ -360,6 +408,12 @@ namespace strumpack {
     integer_t sep_, sep_begin_, sep_end_;
     std::vector<integer_t> upd_;
     std::unique_ptr<F_t> lchild_, rchild_;
+    // where the nonzeros of the sparse matrix go in this front, only
+    // used with opts.use_assembly_map()
+    FrontAssemblyMap<integer_t> amap_;
+
+    const FrontAssemblyMap<integer_t>*
+    assembly_map(const SpMat_t& A, const Opts_t& opts);
 
     virtual long long node_factor_nonzeros() const {
       return dense_node_factor_nonzeros();
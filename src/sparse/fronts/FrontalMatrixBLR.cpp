@@ -29,10 +29,14 @@
 
 #include <iostream>
 #include <fstream>
+#include <numeric>
 
 #include "FrontalMatrixBLR.hpp"
+#include "FrontFactory.hpp"
 #include "sparse/CSRGraph.hpp"
+#include "misc/RandomWrapper.hpp"
 #include "misc/TaskTimer.hpp"
+#include "misc/FrontTrace.hpp"
 #include "dense/BLASLAPACKWrapper.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "ExtendAdd.hpp"
@@ -110,15 +114,48 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixBLR<scalar_t,integer_t>::extend_add_to_dense
   (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
-   const F_t* p, int task_depth) {
+   const F_t* p, int etree_level, int task_depth) {
+    FrontTraceScope ts(FrontPhase::EXTEND_ADD, CompressionType::BLR,
+                       etree_level, dim_sep(), dim_upd());
     const std::size_t pdsep = paF11.rows();
     const std::size_t dupd = dim_upd();
     std::size_t upd2sep;
     auto I = this->upd_to_parent(p, upd2sep);
-    // if ACA was used, a compressed version of the CB was constructed
-    // in F22blr_, so we need to expand it first into F22_
-    if (F22blr_.rows() == dupd)
-      F22_ = F22blr_.dense();
+    if (F22blr_.rows() == dupd) {
+      // if ACA was used, or with CB compression, the CB is stored in
+      // F22blr_, expand and add it one tile at a time
+      const std::size_t rb = F22blr_.rowblocks();
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(1)       \
+  if(task_depth < params::task_recursion_cutoff_level)
+#endif
+      for (std::size_t tj=0; tj<F22blr_.colblocks(); tj++) {
+        for (std::size_t ti=0; ti<rb; ti++) {
+          auto T = F22blr_.tile(ti, tj).dense();
+          const std::size_t r0 = F22blr_.tileroff(ti),
+            c0 = F22blr_.tilecoff(tj), m = T.rows(),
+            msep = std::min(m, upd2sep > r0 ? upd2sep - r0 : 0);
+          for (std::size_t c=0; c<T.cols(); c++) {
+            auto pc = I[c0+c];
+            if (pc < pdsep) {
+              for (std::size_t r=0; r<msep; r++)
+                paF11(I[r0+r],pc) += T(r,c);
+              for (std::size_t r=msep; r<m; r++)
+                paF21(I[r0+r]-pdsep,pc) += T(r,c);
+            } else {
+              for (std::size_t r=0; r<msep; r++)
+                paF12(I[r0+r],pc-pdsep) += T(r,c);
+              for (std::size_t r=msep; r<m; r++)
+                paF22(I[r0+r]-pdsep,pc-pdsep) += T(r,c);
+            }
+          }
+        }
+      }
+      STRUMPACK_FLOPS((is_complex<scalar_t>()?2:1) * dupd * dupd);
+      STRUMPACK_FULL_RANK_FLOPS((is_complex<scalar_t>()?2:1) * dupd * dupd);
+      release_work_memory();
+      return;
+    }
 #if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
 #pragma omp taskloop default(shared) grainsize(64)      \
   if(task_depth < params::task_recursion_cutoff_level)
@@ -151,9 +188,9 @@ namespace strumpack {
     const std::size_t dupd = dim_upd();
     std::size_t upd2sep;
     auto I = this->upd_to_parent(p, upd2sep);
-    if (opts.BLR_options().BLR_factor_algorithm() ==
-        BLR::BLRFactorAlgorithm::COLWISE)
-      F22blr_.decompress(); // change to colwise
+    // the CB can hold low-rank tiles, with COLWISE or with CB
+    // compression, expand those before the element-wise access below
+    F22blr_.decompress();
 #if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
 #pragma omp taskloop default(shared) grainsize(64)      \
   if(task_depth < params::task_recursion_cutoff_level)
@@ -200,9 +237,9 @@ namespace strumpack {
         break;
       }
     }
-    if (opts.BLR_options().BLR_factor_algorithm() ==
-        BLR::BLRFactorAlgorithm::COLWISE)
-      F22blr_.decompress_local_columns(c_min, c_max);
+    // expand low-rank tiles in the touched columns, see
+    // extend_add_to_blr
+    F22blr_.decompress_local_columns(c_min, c_max);
 #if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
 #pragma omp taskloop default(shared) grainsize(64)      \
   if(task_depth < params::task_recursion_cutoff_level)
@@ -235,6 +272,28 @@ namespace strumpack {
     auto I = this->upd_to_parent(pa);
     auto cR = R.extract_rows(I);
     DenseM_t cS(dim_upd(), R.cols());
+    if (F22blr_.rows() == std::size_t(dim_upd())) {
+      // compressed CB, multiply tile by tile
+      const std::size_t rb = F22blr_.rowblocks(), cb = F22blr_.colblocks();
+      DenseM_t cSc(dim_upd(), R.cols());
+      cS.zero();
+      cSc.zero();
+      for (std::size_t j=0; j<cb; j++)
+        for (std::size_t i=0; i<rb; i++) {
+          auto& T = F22blr_.tile(i, j);
+          DenseMW_t Rj(T.cols(), R.cols(), cR, F22blr_.tilecoff(j), 0),
+            Ri(T.rows(), R.cols(), cR, F22blr_.tileroff(i), 0),
+            Si(T.rows(), R.cols(), cS, F22blr_.tileroff(i), 0),
+            Scj(T.cols(), R.cols(), cSc, F22blr_.tilecoff(j), 0);
+          T.gemm_a(Trans::N, Trans::N, scalar_t(1.), Rj,
+                   scalar_t(1.), Si, task_depth);
+          T.gemm_a(Trans::C, Trans::N, scalar_t(1.), Ri,
+                   scalar_t(1.), Scj, task_depth);
+        }
+      Sr.scatter_rows_add(I, cS, task_depth);
+      Sc.scatter_rows_add(I, cSc, task_depth);
+      return;
+    }
     gemm(Trans::N, Trans::N, scalar_t(1.), F22_, cR,
          scalar_t(0.), cS, task_depth);
     Sr.scatter_rows_add(I, cS, task_depth);
@@ -300,6 +359,10 @@ namespace strumpack {
     const auto dsep = dim_sep();
     const auto dupd = dim_upd();
     auto& blr_opts = opts.BLR_options();
+    // with the dense RRQR path, assembly and factorization are
+    // recorded separately, otherwise they are interleaved
+    FrontTraceScope ts(FrontPhase::FACTOR, CompressionType::BLR,
+                       etree_level, dsep, dupd);
     if (blr_opts.low_rank_algorithm() ==
         BLR::LowRankAlgorithm::RRQR) {
       if (blr_opts.BLR_factor_algorithm() ==
@@ -312,8 +375,11 @@ namespace strumpack {
           F22blr_ = BLRM_t(dupd, upd_tiles_, dupd, upd_tiles_);
           using Trip_t = Triplet<scalar_t>;
           std::vector<Trip_t> e11, e12, e21;
-          A.push_front_elements
-            (sep_begin_, sep_end_, this->upd(), e11, e12, e21);
+          if (auto M = this->assembly_map(A, opts))
+            A.push_front_elements_mapped(*M, e11, e12, e21);
+          else
+            A.push_front_elements
+              (sep_begin_, sep_end_, this->upd(), e11, e12, e21);
           BLRM_t::construct_and_partial_factor_col
             (F11blr_, F12blr_, F21blr_, F22blr_, sep_tiles_,
              upd_tiles_, admissibility_, blr_opts,
@@ -323,28 +389,66 @@ namespace strumpack {
              });
         }
       } else {
+        ts.discard();
+        FrontTraceScope ta(FrontPhase::ASSEMBLY, CompressionType::BLR,
+                           etree_level, dsep, dupd);
         DenseM_t F11(dsep, dsep), F12(dsep, dupd), F21(dupd, dsep);
         F11.zero(); F12.zero(); F21.zero();
-        A.extract_front
-          (F11, F12, F21, sep_begin_, sep_end_, this->upd_, task_depth);
-        if (dupd) {
-          F22_ = DenseM_t(dupd, dupd);
-          F22_.zero();
+        if (auto M = this->assembly_map(A, opts))
+          A.extract_front_mapped(F11, F12, F21, *M);
+        else
+          A.extract_front
+            (F11, F12, F21, sep_begin_, sep_end_, this->upd_, task_depth);
+        // with CB compression, the CB is built one tile at a time
+        // in compress_CB, and never stored as a single dense matrix,
+        // so here the children only add to F11, F12 and F21
+        const bool CB_tiles = dupd && blr_opts.CB_compression();
+        if (CB_tiles) {
+          std::vector<std::size_t> gsep(dsep),
+            gupd(this->upd_.begin(), this->upd_.end());
+          std::iota(gsep.begin(), gsep.end(), sep_begin_);
+          for (auto ch : {lchild_.get(), rchild_.get()}) {
+            if (!ch) continue;
+            ch->extract_CB_sub_matrix(gsep, gsep, F11, task_depth);
+            ch->extract_CB_sub_matrix(gsep, gupd, F12, task_depth);
+            ch->extract_CB_sub_matrix(gupd, gsep, F21, task_depth);
+          }
+        } else {
+          if (dupd) {
+            F22_ = DenseM_t(dupd, dupd);
+            F22_.zero();
+          }
+          if (lchild_)
+            lchild_->extend_add_to_dense
+              (F11, F12, F21, F22_, this, etree_level+1, task_depth);
+          if (rchild_)
+            rchild_->extend_add_to_dense
+              (F11, F12, F21, F22_, this, etree_level+1, task_depth);
         }
-        if (lchild_)
-          lchild_->extend_add_to_dense(F11, F12, F21, F22_, this, task_depth);
-        if (rchild_)
-          rchild_->extend_add_to_dense(F11, F12, F21, F22_, this, task_depth);
         auto nF11 = F11.normF();
         auto nF12 = F12.normF();
         auto nF21 = F21.normF();
         auto nF = std::sqrt(nF11*nF11 + nF12*nF12 + nF21*nF21);
         auto lopts = blr_opts;
         lopts.set_abs_tol(lopts.abs_tol() * nF);
+        // with AUTO compression, the rank estimate used to select
+        // this front is replaced by the rank measured on the
+        // assembled front, F11 is only compressed if that pays off
+        if (opts.compression() == CompressionType::AUTO && dsep) {
+          auto r = probe_rank(F11, F12, F21, lopts);
+          if (r >= 0 && !blr_pays_off(dsep, dupd, opts, r))
+            admissibility_.fill(false);
+        }
+        ta.stop();
+        FrontTraceScope tf(FrontPhase::FACTOR, CompressionType::BLR,
+                           etree_level, dsep, dupd);
         if (dsep)
           BLRM_t::construct_and_partial_factor
             (F11, F12, F21, F22_, F11blr_, F12blr_, F21blr_,
              sep_tiles_, upd_tiles_, admissibility_, lopts);
+        if (CB_tiles)
+          compress_CB(lopts, task_depth);
+        if (tf.active()) tf.set_rank(F11blr_.rank());
       }
     } else { // ACA or BACA
       auto F11elem = [&](const std::vector<std::size_t>& lI,
@@ -388,8 +492,15 @@ namespace strumpack {
          F11blr_, F12blr_, F21blr_, F22blr_,
          sep_tiles_, upd_tiles_, admissibility_, blr_opts);
     }
+    if (ts.active()) ts.set_rank(F11blr_.rank());
+    ts.stop();
+    // the parent releases the CB, keep its size for CB_nonzeros
+    CB_nnz_ = (F22blr_.rows() == std::size_t(dupd)) ?
+      F22blr_.nonzeros() : F22_.nonzeros();
     if (lchild_) lchild_->release_work_memory();
     if (rchild_) rchild_->release_work_memory();
+    if (blr_opts.tiling() == BLR::Tiling::ADAPTIVE && dsep)
+      observe_tile_ranks();
     if (opts.print_compressed_front_stats()) {
       auto time = t.elapsed();
       auto nnz = F11blr_.nonzeros();
@@ -568,27 +679,156 @@ namespace strumpack {
     return ReturnCode::SUCCESS;
   }
 
+  /**
+   * Record the average rank of the low-rank tiles in F11, F12 and
+   * F21, and whether many admissible tiles of F11 did not compress
+   * (rank too large to be stored as low-rank). Both are used by
+   * partition for the next factorization with adaptive tiling. Once
+   * strong admissibility is selected for a front, it is kept.
+   */
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixBLR<scalar_t,integer_t>::observe_tile_ranks() {
+    std::size_t lr = 0, rank = 0;
+    auto add = [&](const BLRM_t& M) {
+      for (std::size_t j=0; j<M.colblocks(); j++)
+        for (std::size_t i=0; i<M.rowblocks(); i++)
+          if (M.tile(i, j).is_low_rank()) {
+            lr++;
+            rank += M.tile(i, j).rank();
+          }
+    };
+    add(F11blr_);
+    add(F12blr_);
+    add(F21blr_);
+    if (lr) tile_rank_ = float(rank) / lr;
+    std::size_t adm = 0, dense = 0;
+    for (std::size_t j=0; j<F11blr_.colblocks(); j++)
+      for (std::size_t i=0; i<F11blr_.rowblocks(); i++)
+        if (i != j && admissibility_(i, j)) {
+          adm++;
+          if (!F11blr_.tile(i, j).is_low_rank()) dense++;
+        }
+    // if more than a quarter of the admissible tiles stayed dense,
+    // weak admissibility does not pay off for this front. With
+    // strong admissibility, the admissible tiles do compress, so
+    // switching back would alternate between the two.
+    if (adm && 4 * dense > adm) strong_adm_ = true;
+  }
+
+  /**
+   * Estimate the rank of the off-diagonal tiles of the assembled
+   * front with a randomized range finder on the first tile of F12
+   * and F21 (or of F11 for a front without update), doubling the
+   * number of samples until the rank is revealed. Returns -1 if
+   * there is no off-diagonal tile.
+   */
+  template<typename scalar_t,typename integer_t> int
+  FrontalMatrixBLR<scalar_t,integer_t>::probe_rank
+  (DenseM_t& F11, DenseM_t& F12, DenseM_t& F21,
+   const BLR::BLROptions<scalar_t>& opts) const {
+    using real_t = typename RealType<scalar_t>::value_type;
+    auto rgen = random::make_default_random_generator<real_t>();
+    int rank = -1;
+    auto probe = [&](const DenseM_t& T) {
+      std::size_t mn = std::min(T.rows(), T.cols()),
+        d = std::min(mn, std::size_t(8));
+      while (true) {
+        DenseM_t R(T.cols(), d), S(T.rows(), d), U, V;
+        R.random(*rgen);
+        gemm(Trans::N, Trans::N, scalar_t(1.), T, R, scalar_t(0.), S);
+        S.low_rank(U, V, opts.rel_tol(), opts.abs_tol(), d, 0);
+        if (U.cols() < d || d == mn) {
+          rank = std::max(rank, int(U.cols()));
+          return;
+        }
+        d = std::min(2 * d, mn);
+      }
+    };
+    if (dim_upd()) {
+      DenseMW_t T12(sep_tiles_[0], upd_tiles_[0], F12, 0, 0),
+        T21(upd_tiles_[0], sep_tiles_[0], F21, 0, 0);
+      probe(T12);
+      probe(T21);
+    } else if (sep_tiles_.size() > 1) {
+      DenseMW_t T01(sep_tiles_[0], sep_tiles_[1], F11, 0, sep_tiles_[0]),
+        T10(sep_tiles_[1], sep_tiles_[0], F11, sep_tiles_[0], 0);
+      probe(T01);
+      probe(T10);
+    }
+    return rank;
+  }
+
+  /**
+   * Build the CB as a BLR matrix F22blr_, one tile at a time. Each
+   * tile is assembled from the children, receives the Schur
+   * complement update from F21blr_ and F12blr_, and off-diagonal
+   * tiles are then compressed. At most one dense tile per task is
+   * stored besides the compressed CB.
+   */
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixBLR<scalar_t,integer_t>::compress_CB
+  (const BLR::BLROptions<scalar_t>& opts, int task_depth) {
+    const auto dupd = dim_upd();
+    const std::size_t nt = upd_tiles_.size(),
+      kt = dim_sep() ? F12blr_.rowblocks() : 0;
+    F22blr_ = BLRM_t(dupd, upd_tiles_, dupd, upd_tiles_);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(1)       \
+  if(task_depth < params::task_recursion_cutoff_level)
+#endif
+    for (std::size_t j=0; j<nt; j++)
+      for (std::size_t i=0; i<nt; i++) {
+        const std::size_t m = F22blr_.tilerows(i), n = F22blr_.tilecols(j);
+        auto uI = this->upd_.begin() + F22blr_.tileroff(i);
+        auto uJ = this->upd_.begin() + F22blr_.tilecoff(j);
+        std::vector<std::size_t> gI(uI, uI+m), gJ(uJ, uJ+n);
+        std::unique_ptr<BLR::DenseTile<scalar_t>> T
+          (new BLR::DenseTile<scalar_t>(m, n));
+        auto& D = T->D();
+        D.zero();
+        if (lchild_) lchild_->extract_CB_sub_matrix(gI, gJ, D, task_depth);
+        if (rchild_) rchild_->extract_CB_sub_matrix(gI, gJ, D, task_depth);
+        for (std::size_t k=0; k<kt; k++)
+          gemm(Trans::N, Trans::N, scalar_t(-1.), F21blr_.tile(i, k),
+               F12blr_.tile(k, j), scalar_t(1.), D);
+        if (i != j) {
+          std::unique_ptr<BLR::LRTile<scalar_t>> t
+            (new BLR::LRTile<scalar_t>(D, opts));
+          if (t->rank()*(m + n) < m*n) {
+            F22blr_.block(i, j) = std::move(t);
+            continue;
+          }
+        }
+        F22blr_.block(i, j) = std::move(T);
+      }
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixBLR<scalar_t,integer_t>::partition
   (const Opts_t& opts, const SpMat_t& A,
    integer_t* sorder, bool is_root, int task_depth) {
+    auto& blr_opts = opts.BLR_options();
+    const bool adaptive = blr_opts.tiling() == BLR::Tiling::ADAPTIVE;
+    const auto leaf = adaptive ?
+      blr_opts.tile_size(this->dim_blk(), tile_rank_) :
+      blr_opts.leaf_size();
     if (dim_sep()) {
       auto g = A.extract_graph
         (opts.separator_ordering_level(), sep_begin_, sep_end_);
 #if 0
       auto sep_tree = g.recursive_bisection
-        (opts.BLR_options().leaf_size(), 0,
-         sorder+sep_begin_, nullptr, 0, 0, dim_sep());
+        (leaf, 0, sorder+sep_begin_, nullptr, 0, 0, dim_sep());
       sep_tiles_ = sep_tree.template leaf_sizes<std::size_t>();
 #else
-      int K = std::round((1.* dim_sep()) / opts.BLR_options().leaf_size());
+      int K = std::round((1.* dim_sep()) / leaf);
       sep_tiles_ = g.partition_K_way
         (std::max(K, 1), sorder+sep_begin_, nullptr, 0, 0, dim_sep());
 #endif
       std::vector<integer_t> siorder(dim_sep());
       for (integer_t i=sep_begin_; i<sep_end_; i++)
         siorder[sorder[i]] = i - sep_begin_;
-      if (opts.BLR_options().admissibility() == BLR::Admissibility::STRONG) {
+      if (blr_opts.admissibility() == BLR::Admissibility::STRONG ||
+          (adaptive && strong_adm_)) {
         g.permute(sorder+sep_begin_, siorder.data());
         admissibility_ = g.admissibility(sep_tiles_);
       } else {
@@ -602,10 +842,18 @@ namespace strumpack {
         sorder[i] += sep_begin_;
     }
     if (dim_upd()) {
-      auto leaf = opts.BLR_options().leaf_size();
-      auto nt = std::ceil(float(dim_upd()) / leaf);
-      upd_tiles_.resize(nt, leaf);
-      upd_tiles_.back() = dim_upd() - leaf*(nt-1);
+      if (adaptive) {
+        // balanced tiles, no small remainder tile
+        std::size_t nt = std::max
+          (std::size_t(1), std::size_t(std::round(float(dim_upd()) / leaf)));
+        upd_tiles_.assign(nt, dim_upd() / nt);
+        for (std::size_t t=0; t<dim_upd()%nt; t++)
+          upd_tiles_[t]++;
+      } else {
+        auto nt = std::ceil(float(dim_upd()) / leaf);
+        upd_tiles_.resize(nt, leaf);
+        upd_tiles_.back() = dim_upd() - leaf*(nt-1);
+      }
     }
   }
 
@@ -65,7 +65,8 @@ namespace strumpack {
 
     void extend_add_to_dense(DenseM_t& paF11, DenseM_t& paF12,
                              DenseM_t& paF21, DenseM_t& paF22,
-                             const F_t* p, int task_depth) override;
+                             const F_t* p, int etree_level,
+                             int task_depth) override;
     void extend_add_to_blr(BLRM_t& paF11, BLRM_t& paF12,
                            BLRM_t& paF21, BLRM_t& paF22, const F_t* p,
                            int task_depth, const Opts_t& opts) override;
@@ -117,6 +118,12 @@ namespace strumpack {
     DenseM_t F22_;
     std::vector<std::size_t> sep_tiles_, upd_tiles_;
     DenseMatrix<bool> admissibility_;
+    // observed in the previous factorization, used for adaptive tiling
+    float tile_rank_ = 0.;
+    // entries in the CB after the last factorization
+    long long CB_nnz_ = 0;
+    // sticky, once set this front keeps using strong admissibility
+    bool strong_adm_ = false;
 
     FrontalMatrixBLR(const FrontalMatrixBLR&) = delete;
     FrontalMatrixBLR& operator=(FrontalMatrixBLR const&) = delete;
@@ -128,7 +135,13 @@ namespace strumpack {
 
     void draw_node(std::ostream& of, bool is_root) const override;
 
+    void observe_tile_ranks();
+    int probe_rank(DenseM_t& F11, DenseM_t& F12, DenseM_t& F21,
+                   const BLR::BLROptions<scalar_t>& opts) const;
+    void compress_CB(const BLR::BLROptions<scalar_t>& opts, int task_depth);
+
     long long node_factor_nonzeros() const override;
+    long long node_CB_nonzeros() const override { return CB_nnz_; }
 
     virtual ReturnCode node_subnormals(std::size_t& ns,
                                        std::size_t& nz) const override;
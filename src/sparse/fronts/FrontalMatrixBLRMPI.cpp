@@ -457,7 +457,7 @@ namespace strumpack {
         g = A.extract_graph
           (opts.separator_ordering_level(), sep_begin_, sep_end_);
         auto sep_tree = g.recursive_bisection
-          (opts.BLR_options().leaf_size(), 0,
+          (opts.BLR_options().tile_size(this->dim_blk()), 0,
            sorder+sep_begin_, nullptr, 0, 0, dim_sep());
         sep_tiles_ = sep_tree.template leaf_sizes<std::size_t>();
       }
@@ -487,7 +487,7 @@ namespace strumpack {
         sorder[i] += sep_begin_;
     }
     if (dim_upd()) {
-      auto leaf = opts.BLR_options().leaf_size();
+      auto leaf = opts.BLR_options().tile_size(this->dim_blk());
       auto nt = std::ceil(float(dim_upd()) / leaf);
       upd_tiles_.resize(nt, leaf);
       upd_tiles_.back() = dim_upd() - leaf*(nt-1);
@@ -28,6 +28,7 @@
  */
 
 #include "FrontalMatrixDense.hpp"
+#include "misc/FrontTrace.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "ExtendAdd.hpp"
 #include "FrontalMatrixMPI.hpp"
@@ -44,6 +45,7 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDense<scalar_t,integer_t>::release_work_memory() {
+    if (keep_CB_) return;
     STRUMPACK_SUB_MEMORY(CBstorage_.size()*sizeof(scalar_t));
     CBstorage_.clear();
     F22_.clear();
@@ -51,6 +53,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDense<scalar_t,integer_t>::release_work_memory
   (VectorPool<scalar_t>& workspace) {
+    if (keep_CB_) return;
     workspace.restore(CBstorage_);
     F22_.clear();
   }
@@ -94,15 +97,19 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDense<scalar_t,integer_t>::extend_add_to_dense
   (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
-   const F_t* p, int task_depth) {
+   const F_t* p, int etree_level, int task_depth) {
     VectorPool<scalar_t> workspace;
-    extend_add_to_dense(paF11, paF12, paF21, paF22, p, workspace, task_depth);
+    extend_add_to_dense
+      (paF11, paF12, paF21, paF22, p, workspace, etree_level, task_depth);
   }
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDense<scalar_t,integer_t>::extend_add_to_dense
   (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
-   const F_t* p, VectorPool<scalar_t>& workspace, int task_depth) {
+   const F_t* p, VectorPool<scalar_t>& workspace, int etree_level,
+   int task_depth) {
+    FrontTraceScope ts(FrontPhase::EXTEND_ADD, CompressionType::NONE,
+                       etree_level, dim_sep(), dim_upd());
     const std::size_t pdsep = paF11.rows();
     const std::size_t dupd = dim_upd();
     std::size_t upd2sep;
@@ -201,6 +208,13 @@ namespace strumpack {
   (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
    int etree_level, int task_depth) {
     ReturnCode e1, e2;
+    if (task_depth == 0 && opts.use_task_dag() &&
+        opts.use_openmp_tree() && params::num_threads > 1) {
+      std::vector<FD_t*> fronts;
+      std::vector<int> lvl, lch, rch;
+      if (dense_subtree_postorder(fronts, lvl, lch, rch, etree_level) >= 0)
+        return factor_dag(A, opts, workspace, fronts, lvl, lch, rch);
+    }
     if (task_depth == 0) {
 #pragma omp parallel if(!omp_in_parallel()) default(shared)
 #pragma omp single nowait
@@ -215,6 +229,66 @@ namespace strumpack {
     return (e1 == ReturnCode::SUCCESS) ? e2 : e1;
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontalMatrixDense<scalar_t,integer_t>::refactor
+  (const SpMat_t& A, const Opts_t& opts, const std::vector<bool>& changed,
+   VectorPool<scalar_t>& workspace, int& refactored,
+   int etree_level, int task_depth) {
+    // derived (lossy, HODLR) fronts do not keep their CB, only
+    // FrontalMatrixDense sets keep_CB_. Mixed precision fronts are
+    // therefore not incremental, they are always fully refactored.
+    if (this->type() != "FrontalMatrixDense")
+      return F_t::refactor
+        (A, opts, changed, workspace, refactored, etree_level, task_depth);
+    ReturnCode e;
+    if (task_depth == 0) {
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+      e = refactor(A, opts, changed, workspace, refactored,
+                   etree_level, task_depth+1);
+      return e;
+    }
+    ReturnCode el = ReturnCode::SUCCESS, er = ReturnCode::SUCCESS;
+    int rl = 0, rr = 0;
+    if (opts.use_openmp_tree() &&
+        task_depth < params::task_recursion_cutoff_level) {
+      if (lchild_)
+#pragma omp task default(shared)                                        \
+  final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
+        el = lchild_->refactor
+          (A, opts, changed, workspace, rl, etree_level+1, task_depth+1);
+      if (rchild_)
+#pragma omp task default(shared)                                        \
+  final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
+        er = rchild_->refactor
+          (A, opts, changed, workspace, rr, etree_level+1, task_depth+1);
+#pragma omp taskwait
+    } else {
+      if (lchild_)
+        el = lchild_->refactor
+          (A, opts, changed, workspace, rl, etree_level+1, task_depth);
+      if (rchild_)
+        er = rchild_->refactor
+          (A, opts, changed, workspace, rr, etree_level+1, task_depth);
+    }
+    if (!rl && !rr && keep_CB_ &&
+        std::none_of(changed.begin()+this->sep_begin_,
+                     changed.begin()+this->sep_end_,
+                     [](bool c) { return c; })) {
+      refactored = 0;
+      return ReturnCode::SUCCESS;
+    }
+    refactored = rl + rr + 1;
+    // the children kept their CB, reuse the memory of the old CB
+    keep_CB_ = false;
+    release_work_memory(workspace);
+    assemble_front(A, opts, workspace, etree_level, task_depth);
+    e = factor_phase2(A, opts, etree_level, task_depth);
+    if (el != ReturnCode::SUCCESS) return el;
+    if (er != ReturnCode::SUCCESS) return er;
+    return e;
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   FrontalMatrixDense<scalar_t,integer_t>::factor_phase1
   (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
@@ -237,16 +311,32 @@ namespace strumpack {
       if (rchild_)
         er = rchild_->factor(A, opts, workspace, etree_level+1, task_depth);
     }
-    ReturnCode err_code = (el == ReturnCode::SUCCESS) ? er : el;
+    assemble_front(A, opts, workspace, etree_level, task_depth);
+    return (el == ReturnCode::SUCCESS) ? er : el;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::assemble_front
+  (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
+   int etree_level, int task_depth) {
     // TODO can we allocate the memory in one go??
     const auto dsep = dim_sep();
     const auto dupd = dim_upd();
+    FrontTraceScope ts(FrontPhase::ASSEMBLY, CompressionType::NONE,
+                       etree_level, dsep, dupd);
+    // only plain dense fronts are refactored in place, derived fronts
+    // would only hold on to their CB without ever reusing it
+    keep_CB_ = opts.incremental_factorization() &&
+      this->type() == "FrontalMatrixDense";
     F11_ = DenseM_t(dsep, dsep); F11_.zero();
     F12_ = DenseM_t(dsep, dupd); F12_.zero();
     F21_ = DenseM_t(dupd, dsep); F21_.zero();
-    A.extract_front
-      (F11_, F12_, F21_, this->sep_begin_, this->sep_end_,
-       this->upd_, task_depth);
+    if (auto M = this->assembly_map(A, opts))
+      A.extract_front_mapped(F11_, F12_, F21_, *M);
+    else
+      A.extract_front
+        (F11_, F12_, F21_, this->sep_begin_, this->sep_end_,
+         this->upd_, task_depth);
     if (dupd) {
       CBstorage_ = workspace.get();
       integer_t old_size = CBstorage_.size();
@@ -259,18 +349,19 @@ namespace strumpack {
     }
     if (lchild_)
       lchild_->extend_add_to_dense
-        (F11_, F12_, F21_, F22_, this, workspace, task_depth);
+        (F11_, F12_, F21_, F22_, this, workspace, etree_level+1, task_depth);
     if (rchild_)
       rchild_->extend_add_to_dense
-        (F11_, F12_, F21_, F22_, this, workspace, task_depth);
+        (F11_, F12_, F21_, F22_, this, workspace, etree_level+1, task_depth);
     if (etree_level == 0 && opts.write_root_front()) F11_.write("Froot");
-    return err_code;
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
   FrontalMatrixDense<scalar_t,integer_t>::factor_phase2
   (const SpMat_t& A, const Opts_t& opts,
    int etree_level, int task_depth) {
+    FrontTraceScope ts(FrontPhase::FACTOR, CompressionType::NONE,
+                       etree_level, dim_sep(), dim_upd());
     ReturnCode err_code = ReturnCode::SUCCESS;
     if (dim_sep()) {
       if (F11_.LU(piv_, task_depth))
@@ -299,6 +390,170 @@ namespace strumpack {
     return err_code;
   }
 
+  template<typename scalar_t,typename integer_t> int
+  FrontalMatrixDense<scalar_t,integer_t>::dense_subtree_postorder
+  (std::vector<FD_t*>& fronts, std::vector<int>& lvl,
+   std::vector<int>& lch, std::vector<int>& rch, int etree_level) {
+    // only plain dense or mixed precision fronts, not derived
+    // (lossy) or other types
+    auto dag_type = [](const F_t* f) {
+      return f->type() == "FrontalMatrixDense" ||
+        f->type() == "FrontalMatrixMixedPrecision";
+    };
+    if (!dag_type(this)) return -1;
+    int l = -1, r = -1;
+    if (lchild_) {
+      if (!dag_type(lchild_.get())) return -1;
+      l = static_cast<FD_t*>(lchild_.get())->dense_subtree_postorder
+        (fronts, lvl, lch, rch, etree_level+1);
+      if (l < 0) return -1;
+    }
+    if (rchild_) {
+      if (!dag_type(rchild_.get())) return -1;
+      r = static_cast<FD_t*>(rchild_.get())->dense_subtree_postorder
+        (fronts, lvl, lch, rch, etree_level+1);
+      if (r < 0) return -1;
+    }
+    fronts.push_back(this);
+    lvl.push_back(etree_level);
+    lch.push_back(l);
+    rch.push_back(r);
+    return fronts.size() - 1;
+  }
+
+  /*
+   * Factor the (all dense) subtree as a single task graph. Every
+   * front is a task which depends only on the tasks of its children,
+   * so there is no taskwait per level of the tree and no recursion
+   * cutoff. Large fronts are factored with a tiled LU, see
+   * factor_phase2_tiled, whose tile tasks run concurrently with the
+   * other ready fronts.
+   */
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontalMatrixDense<scalar_t,integer_t>::factor_dag
+  (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
+   const std::vector<FD_t*>& fronts, const std::vector<int>& lvl,
+   const std::vector<int>& lch, const std::vector<int>& rch) {
+    const int N = fronts.size();
+    std::vector<ReturnCode> err(N, ReturnCode::SUCCESS);
+    // dependency tokens, one per front, and a dummy for no child
+    std::unique_ptr<char[]> dep(new char[N+1]);
+    char* none = dep.get() + N;
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+    {
+      for (int i=0; i<N; i++) {
+        char* dl = (lch[i] >= 0) ? dep.get() + lch[i] : none;
+        char* dr = (rch[i] >= 0) ? dep.get() + rch[i] : none;
+        char* di = dep.get() + i;
+#pragma omp task default(shared) firstprivate(i, dl, dr, di)    \
+  depend(in: dl[0], dr[0]) depend(out: di[0])
+        {
+          auto F = fronts[i];
+          bool tiled = F->dim_sep() + F->dim_upd() > 2 * dense_tile_size
+            && F->type() == "FrontalMatrixDense";
+          // small fronts are a single task, large fronts use tasks
+          // for the assembly and the tiled factorization
+          int td = tiled ? 1 : params::task_recursion_cutoff_level;
+          F->assemble_front(A, opts, workspace, lvl[i], td);
+          err[i] = tiled ? F->factor_phase2_tiled(opts, lvl[i]) :
+            F->factor_phase2(A, opts, lvl[i], td);
+        }
+      }
+#pragma omp taskwait
+    }
+    for (auto e : err)
+      if (e != ReturnCode::SUCCESS) return e;
+    return ReturnCode::SUCCESS;
+  }
+
+  /*
+   * Right-looking blocked LU of the front, with partial pivoting
+   * restricted to F11, expressed as a graph of tasks. The front
+   * [F11 F12; F21 F22] is split in column blocks of width
+   * dense_tile_size. Task panel(k) factors the k-th column block of
+   * F11 and applies U_kk^{-1} to the corresponding columns of
+   * F21. Task update(k,j) applies the pivots and L_kk^{-1} of panel
+   * k to column block j (of F11/F21 or F12/F22) and does the Schur
+   * complement update. Panel k+1 only waits for update(k,k+1), which
+   * gives lookahead. The result is the same as the F11_.LU, laswp,
+   * trsm, trsm, gemm sequence in factor_phase2.
+   */
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontalMatrixDense<scalar_t,integer_t>::factor_phase2_tiled
+  (const Opts_t& opts, int etree_level) {
+    const int ds = dim_sep(), du = dim_upd(), nb = dense_tile_size;
+    if (!ds) return ReturnCode::SUCCESS;
+    FrontTraceScope ts(FrontPhase::FACTOR, CompressionType::NONE,
+                       etree_level, ds, du);
+    piv_.resize(ds);
+    const int K = (ds + nb - 1) / nb, Ku = (du + nb - 1) / nb;
+    std::vector<int> info(K, 0);
+    std::unique_ptr<char[]> dep(new char[K+Ku]);
+    auto thresh = opts.pivot_threshold();
+    bool replace = opts.replace_tiny_pivots();
+    // column block j, j < K is in F11/F21, j >= K is in F12/F22
+    auto top = [&](int j) -> scalar_t* {
+      return (j < K) ? F11_.ptr(0, j*nb) : F12_.ptr(0, (j-K)*nb); };
+    auto ldt = [&](int j) { return (j < K) ? F11_.ld() : F12_.ld(); };
+    auto bot = [&](int j) -> scalar_t* {
+      return (j < K) ? F21_.ptr(0, j*nb) : F22_.ptr(0, (j-K)*nb); };
+    auto ldb = [&](int j) { return (j < K) ? F21_.ld() : F22_.ld(); };
+    auto width = [&](int j) {
+      return (j < K) ? std::min(nb, ds-j*nb) : std::min(nb, du-(j-K)*nb); };
+    for (int k=0; k<K; k++) {
+      const int c0 = k*nb, w = width(k);
+      char* dk = dep.get() + k;
+#pragma omp task default(shared) firstprivate(k, c0, w, dk)     \
+  depend(inout: dk[0]) priority(1)
+      {
+        info[k] = blas::getrf
+          (ds-c0, w, F11_.ptr(c0, c0), F11_.ld(), piv_.data()+c0);
+        for (int i=c0; i<c0+w; i++) piv_[i] += c0;
+        if (replace)
+          for (int i=c0; i<c0+w; i++)
+            if (std::abs(F11_(i,i)) < thresh)
+              F11_(i,i) = (std::real(F11_(i,i)) < 0) ? -thresh : thresh;
+        if (du)
+          blas::trsm('R', 'U', 'N', 'N', du, w, scalar_t(1.),
+                     F11_.ptr(c0, c0), F11_.ld(), F21_.ptr(0, c0),
+                     F21_.ld());
+      }
+      for (int j=k+1; j<K+Ku; j++) {
+        char* dj = dep.get() + j;
+#pragma omp task default(shared) firstprivate(k, j, c0, w, dk, dj)      \
+  depend(in: dk[0]) depend(inout: dj[0]) priority(j == k+1 ? 1 : 0)
+        {
+          const int wj = width(j);
+          auto T = top(j);
+          blas::laswp(wj, T, ldt(j), c0+1, c0+w, piv_.data(), 1);
+          blas::trsm('L', 'L', 'N', 'U', w, wj, scalar_t(1.),
+                     F11_.ptr(c0, c0), F11_.ld(), T+c0, ldt(j));
+          blas::gemm('N', 'N', ds-c0-w, wj, w, scalar_t(-1.),
+                     F11_.ptr(c0+w, c0), F11_.ld(), T+c0, ldt(j),
+                     scalar_t(1.), T+c0+w, ldt(j));
+          if (du)
+            blas::gemm('N', 'N', du, wj, w, scalar_t(-1.),
+                       F21_.ptr(0, c0), F21_.ld(), T+c0, ldt(j),
+                       scalar_t(1.), bot(j), ldb(j));
+        }
+      }
+    }
+#pragma omp taskwait
+    // apply the row interchanges of the later panels to L
+    for (int k=1; k<K; k++)
+      blas::laswp(k*nb, F11_.data(), F11_.ld(), k*nb+1,
+                  k*nb+width(k), piv_.data(), 1);
+    STRUMPACK_FULL_RANK_FLOPS
+      (LU_flops(F11_) +
+       gemm_flops(Trans::N, Trans::N, scalar_t(-1.), F21_, F12_, scalar_t(1.)) +
+       trsm_flops(Side::L, scalar_t(1.), F11_, F12_) +
+       trsm_flops(Side::R, scalar_t(1.), F11_, F21_));
+    for (int k=0; k<K; k++)
+      if (info[k]) return ReturnCode::ZERO_PIVOT;
+    return ReturnCode::SUCCESS;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDense<scalar_t,integer_t>::fwd_solve_phase2
   (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
@@ -517,6 +772,8 @@ namespace strumpack {
     F21_ = DenseM_t();
     F22_ = DenseMW_t();
     piv_ = std::vector<int>();
+    keep_CB_ = false;
+    release_work_memory();
   }
 
 #if defined(STRUMPACK_USE_MPI)
@@ -52,6 +52,7 @@ namespace strumpack {
     using SpMat_t = CompressedSparseMatrix<scalar_t,integer_t>;
     using BLRM_t = BLR::BLRMatrix<scalar_t>;
     using Opts_t = SPOptions<scalar_t>;
+    using FD_t = FrontalMatrixDense<scalar_t,integer_t>;
 
   public:
     FrontalMatrixDense(integer_t sep, integer_t sep_begin, integer_t sep_end,
@@ -63,10 +64,11 @@ namespace strumpack {
     void extend_add_to_dense(DenseM_t& paF11, DenseM_t& paF12,
                              DenseM_t& paF21, DenseM_t& paF22,
                              const F_t* p, VectorPool<scalar_t>& workspace,
-                             int task_depth) override;
+                             int etree_level, int task_depth) override;
     void extend_add_to_dense(DenseM_t& paF11, DenseM_t& paF12,
                              DenseM_t& paF21, DenseM_t& paF22,
-                             const F_t* p, int task_depth) override;
+                             const F_t* p, int etree_level,
+                             int task_depth) override;
 
     void extend_add_to_blr(BLRM_t& paF11, BLRM_t& paF12, BLRM_t& paF21,
                            BLRM_t& paF22, const F_t* p, int task_depth,
@@ -100,6 +102,10 @@ namespace strumpack {
     virtual ReturnCode factor(const SpMat_t& A, const Opts_t& opts,
                               VectorPool<scalar_t>& workspace,
                               int etree_level=0, int task_depth=0) override;
+    ReturnCode refactor(const SpMat_t& A, const Opts_t& opts,
+                        const std::vector<bool>& changed,
+                        VectorPool<scalar_t>& workspace, int& refactored,
+                        int etree_level=0, int task_depth=0) override;
 
     void
     extract_CB_sub_matrix(const std::vector<std::size_t>& I,
@@ -132,6 +138,8 @@ namespace strumpack {
     DenseMW_t F22_;
     std::vector<scalar_t,NoInit<scalar_t>> CBstorage_;
     std::vector<int> piv_; // regular int because it is passed to BLAS
+    // keep F22_ after the extend-add, for incremental refactorization
+    bool keep_CB_ = false;
 
     FrontalMatrixDense(const FrontalMatrixDense&) = delete;
     FrontalMatrixDense& operator=(FrontalMatrixDense const&) = delete;
@@ -139,8 +147,27 @@ namespace strumpack {
     ReturnCode factor_phase1(const SpMat_t& A, const Opts_t& opts,
                              VectorPool<scalar_t>& workspace,
                              int etree_level, int task_depth);
-    ReturnCode factor_phase2(const SpMat_t& A, const Opts_t& opts,
-                             int etree_level, int task_depth);
+    virtual ReturnCode factor_phase2(const SpMat_t& A, const Opts_t& opts,
+                                     int etree_level, int task_depth);
+
+    void assemble_front(const SpMat_t& A, const Opts_t& opts,
+                        VectorPool<scalar_t>& workspace,
+                        int etree_level, int task_depth);
+
+    // tile size for the task graph (DAG) based factorization
+    static const int dense_tile_size = 128;
+
+    int dense_subtree_postorder(std::vector<FD_t*>& fronts,
+                                std::vector<int>& lvl,
+                                std::vector<int>& lch,
+                                std::vector<int>& rch, int etree_level);
+    ReturnCode factor_dag(const SpMat_t& A, const Opts_t& opts,
+                          VectorPool<scalar_t>& workspace,
+                          const std::vector<FD_t*>& fronts,
+                          const std::vector<int>& lvl,
+                          const std::vector<int>& lch,
+                          const std::vector<int>& rch);
+    ReturnCode factor_phase2_tiled(const Opts_t& opts, int etree_level);
 
     virtual void
     fwd_solve_phase2(DenseM_t& b, DenseM_t& bupd, int etree_level,
@@ -28,6 +28,7 @@
  */
 
 #include "FrontalMatrixHODLR.hpp"
+#include "misc/FrontTrace.hpp"
 #include "ExtendAdd.hpp"
 
 namespace strumpack {
@@ -98,9 +99,11 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixHODLR<scalar_t,integer_t>::extend_add_to_dense
   (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
-   const F_t* p, int task_depth) {
+   const F_t* p, int etree_level, int task_depth) {
     const std::size_t dupd = dim_upd();
     if (!dupd) return;
+    FrontTraceScope ts(FrontPhase::EXTEND_ADD, CompressionType::HODLR,
+                       etree_level, dim_sep(), dupd);
     const std::size_t pdsep = paF11.rows();
     std::size_t upd2sep;
     auto I = this->upd_to_parent(p, upd2sep);
@@ -432,6 +435,8 @@ namespace strumpack {
     if (!this->dim_blk()) return err_code;
     TaskTimer t("");
     if (opts.print_compressed_front_stats()) t.start();
+    FrontTraceScope ts(FrontPhase::FACTOR, CompressionType::HODLR,
+                       etree_level, dim_sep(), dim_upd());
     construct_hierarchy(A, opts, task_depth);
     switch (opts.HODLR_options().compression_algorithm()) {
     case HODLR::CompressionAlgorithm::RANDOM_SAMPLING:
@@ -455,6 +460,8 @@ namespace strumpack {
     if (F22_) HOD_mem += F22_->get_stat("Mem_Fill");
     STRUMPACK_ADD_MEMORY(HOD_mem*1.e6);
 #endif
+    if (ts.active()) ts.set_rank(F11_.get_stat("Rank_max"));
+    ts.stop();
     if (opts.print_compressed_front_stats()) {
       auto time = t.elapsed();
       float perbyte = 1.0e6 / sizeof(scalar_t);
@@ -28,6 +28,7 @@
  */
 
 #include "FrontalMatrixHSS.hpp"
+#include "misc/FrontTrace.hpp"
 #include "sparse/CSRGraph.hpp"
 
 namespace strumpack {
@@ -43,7 +44,8 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixHSS<scalar_t,integer_t>::release_work_memory() {
     ThetaVhatC_or_VhatCPhiC_.clear();
-    H_.delete_trailing_block();
+    if (warm_start_) H_.delete_trailing_block_generators();
+    else H_.delete_trailing_block();
     R1.clear();
     Sr2.clear();
     Sc2.clear();
@@ -53,7 +55,10 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixHSS<scalar_t,integer_t>::extend_add_to_dense
   (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
-   const FrontalMatrix<scalar_t,integer_t>* p, int task_depth) {
+   const FrontalMatrix<scalar_t,integer_t>* p, int etree_level,
+   int task_depth) {
+    FrontTraceScope ts(FrontPhase::EXTEND_ADD, CompressionType::HSS,
+                       etree_level, dim_sep(), dim_upd());
     const std::size_t pdsep = p->dim_sep();
     const std::size_t dupd = dim_upd();
     std::size_t upd2sep;
@@ -282,8 +287,11 @@ namespace strumpack {
     }
 
     TIMER_TIME(TaskType::FRONT_MULTIPLY_2D, 1, t_fmult);
-    A.front_multiply
-      (sep_begin_, sep_end_, this->upd_, Rr, Sr, Sc, task_depth);
+    if (auto M = this->assembly_map(A, opts))
+      A.front_multiply_mapped(dim_sep(), *M, Rr, Sr, Sc, task_depth);
+    else
+      A.front_multiply
+        (sep_begin_, sep_end_, this->upd_, Rr, Sr, Sc, task_depth);
     TIMER_STOP(t_fmult);
     TIMER_TIME(TaskType::UUTXR, 1, t_UUtxR);
     if (lchild_)
@@ -361,11 +369,14 @@ namespace strumpack {
     if (er != ReturnCode::SUCCESS) err_code = er;
     TaskTimer t("FrontalMatrixHSS_factor");
     if (opts.print_compressed_front_stats()) t.start();
+    FrontTraceScope ts(FrontPhase::FACTOR, CompressionType::HSS,
+                       etree_level, dim_sep(), dim_upd());
     H_.set_openmp_task_depth(task_depth);
     auto mult = [&](DenseM_t& Rr, DenseM_t& Rc, DenseM_t& Sr, DenseM_t& Sc) {
       TIMER_TIME(TaskType::RANDOM_SAMPLING, 0, t_sampling);
       random_sampling(A, opts, Rr, Rc, Sr, Sc, etree_level, task_depth);
       sampled_columns_ += Rr.cols();
+      samples_ += Rr.cols();
     };
     auto elem = [&](const std::vector<std::size_t>& I,
                     const std::vector<std::size_t>& J, DenseM_t& B) {
@@ -381,7 +392,18 @@ namespace strumpack {
     HSSopts.set_d0(std::max(child_samples - HSSopts.dd(), HSSopts.d0()));
     if (opts.indirect_sampling())
       HSSopts.set_user_defined_random(true);
-    H_.compress(mult, elem, HSSopts);
+    // H_ is still compressed if the separators were not partitioned
+    // again since the previous factorization. The warm start draws
+    // fewer samples than the children kept for indirect sampling.
+    samples_ = 0;
+    if (H_.is_compressed() && !opts.indirect_sampling())
+      H_.compress_warm(mult, elem, HSSopts);
+    else {
+      if (H_.is_compressed()) H_.reset();
+      H_.compress(mult, elem, HSSopts);
+    }
+    warm_start_ = opts.HSS_warm_start() &&
+      opts.compression() == CompressionType::HSS;
     if (lchild_) lchild_->release_work_memory();
     if (rchild_) rchild_->release_work_memory();
     if (dim_sep()) {
@@ -411,6 +433,8 @@ namespace strumpack {
         TIMER_STOP(t_fact);
       }
     }
+    if (ts.active()) ts.set_rank(H_.rank());
+    ts.stop();
     if (opts.print_compressed_front_stats()) {
       auto time = t.elapsed();
       auto rank = H_.rank();
@@ -49,7 +49,7 @@ namespace strumpack {
     void extend_add_to_dense(DenseM_t& paF11, DenseM_t& paF12,
                              DenseM_t& paF21, DenseM_t& paF22,
                              const FrontalMatrix<scalar_t,integer_t>* p,
-                             int task_depth) override;
+                             int etree_level, int task_depth) override;
 
     void sample_CB(const Opts_t& opts, const DenseM_t& R,
                    DenseM_t& Sr, DenseM_t& Sc,
@@ -87,6 +87,11 @@ namespace strumpack {
     std::string type() const override { return "FrontalMatrixHSS"; }
 
     int random_samples() const override { return R1.cols(); };
+    void node_HSS_compression_counts
+    (long long& samples, long long& reused) const override {
+      samples += samples_;
+      reused += H_.reused_nodes();
+    }
 
     void partition(const Opts_t& opts, const SpMat_t& A, integer_t* sorder,
                    bool is_root=true, int task_depth=0) override;
@@ -111,6 +116,11 @@ namespace strumpack {
     DenseM_t Sr2, Sc2;  /* bottom of the sample matrix used to
                            construct HSS matrix of this front */
     std::uint32_t sampled_columns_ = 0;
+    /* random samples drawn in the last compression of H_ */
+    int samples_ = 0;
+    /* keep the bases of H_ for the next factorization, see
+       SPOptions::enable_HSS_warm_start */
+    bool warm_start_ = false;
 
   private:
     FrontalMatrixHSS(const FrontalMatrixHSS&) = delete;
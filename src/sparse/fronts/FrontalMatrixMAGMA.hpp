@@ -61,7 +61,8 @@ namespace strumpack {
 
     void extend_add_to_dense(DenseM_t& paF11, DenseM_t& paF12,
                              DenseM_t& paF21, DenseM_t& paF22,
-                             const F_t* p, int task_depth) override;
+                             const F_t* p, int etree_level,
+                             int task_depth) override;
 
     ReturnCode multifrontal_factorization(const SpMat_t& A,
                                           const SPOptions<scalar_t>& opts,
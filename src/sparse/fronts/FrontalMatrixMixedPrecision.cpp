@@ -0,0 +1,238 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <limits>
+
+#include "FrontalMatrixMixedPrecision.hpp"
+#include "misc/FrontTrace.hpp"
+
+namespace strumpack {
+
+  template<typename scalar_t,typename integer_t>
+  FrontalMatrixMixedPrecision<scalar_t,integer_t>::FrontalMatrixMixedPrecision
+  (integer_t sep, integer_t sep_begin, integer_t sep_end,
+   std::vector<integer_t>& upd)
+    : FD_t(sep, sep_begin, sep_end, upd) {}
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixMixedPrecision<scalar_t,integer_t>::delete_factors() {
+    FD_t::delete_factors();
+    F11l_ = DenseMlow_t();
+    F12l_ = DenseMlow_t();
+    F21l_ = DenseMlow_t();
+    low_ = false;
+  }
+
+  template<typename scalar_t,typename integer_t> long long
+  FrontalMatrixMixedPrecision<scalar_t,integer_t>::node_factor_nonzeros()
+    const {
+    long long dsep = dim_sep(), dupd = dim_upd(),
+      nnz = dsep * (dsep + 2 * dupd);
+    // counted in units of scalar_t, as for the lossy fronts
+    return low_ ? nnz * sizeof(low_t) / sizeof(scalar_t) : nnz;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontalMatrixMixedPrecision<scalar_t,integer_t>::factor_phase2
+  (const SpMat_t& A, const Opts_t& opts, int etree_level, int task_depth) {
+    if (factor_lower_precision(opts, etree_level, task_depth))
+      return ReturnCode::SUCCESS;
+    return FD_t::factor_phase2(A, opts, etree_level, task_depth);
+  }
+
+  /*
+   * LU of F11 and Schur complement update in lower precision. This
+   * returns false, leaving F11_, F12_ and F21_ untouched, if the
+   * front is out of range for the lower precision, if the LU has a
+   * zero pivot, or if the entries of U (or of L21) are not finite or
+   * grew by more than a factor 1/sqrt(eps) of the lower
+   * precision. The caller then factors the front in the working
+   * precision.
+   */
+  template<typename scalar_t,typename integer_t> bool
+  FrontalMatrixMixedPrecision<scalar_t,integer_t>::factor_lower_precision
+  (const Opts_t& opts, int etree_level, int task_depth) {
+    using low_real_t = typename RealType<low_t>::value_type;
+    const std::size_t dsep = dim_sep(), dupd = dim_upd();
+    low_ = false;
+    if (!dsep) return false;
+    FrontTraceScope ts(FrontPhase::FACTOR, CompressionType::NONE,
+                       etree_level, dsep, dupd);
+    // the working precision factorization records its own event
+    auto fallback = [&ts]() { ts.discard(); return false; };
+    auto max_abs = [](const auto& M) {
+      low_real_t m(0.);
+      for (std::size_t j=0; j<M.cols(); j++)
+        for (std::size_t i=0; i<M.rows(); i++)
+          m = std::max(m, low_real_t(std::abs(M(i, j))));
+      return m;
+    };
+    const low_real_t growth =
+      low_real_t(1.) / std::sqrt(std::numeric_limits<low_real_t>::epsilon());
+    DenseMlow_t F11(dsep, dsep), F12(dsep, dupd), F21(dupd, dsep);
+    copy(this->F11_, F11);
+    copy(this->F12_, F12);
+    copy(this->F21_, F21);
+    const auto big = std::numeric_limits<low_real_t>::max();
+    auto Amax = std::max(max_abs(F11), max_abs(F12));
+    // out of range for the lower precision
+    if (!(Amax < big)) return fallback();
+    std::vector<int> piv;
+    if (F11.LU(piv, task_depth)) return fallback();
+    if (opts.replace_tiny_pivots()) {
+      auto thresh = low_real_t(opts.pivot_threshold());
+      for (std::size_t i=0; i<dsep; i++)
+        if (std::abs(F11(i,i)) < thresh)
+          F11(i,i) = (std::real(F11(i,i)) < 0) ? -thresh : thresh;
+    }
+    if (dupd) {
+      F12.laswp(piv, true);
+      trsm(Side::L, UpLo::L, Trans::N, Diag::U,
+           low_t(1.), F11, F12, task_depth);
+      trsm(Side::R, UpLo::U, Trans::N, Diag::N,
+           low_t(1.), F11, F21, task_depth);
+    }
+    auto Umax = std::max(max_abs(F11), max_abs(F12));
+    // negated comparisons also catch NaN and Inf
+    if (!(Umax <= growth * Amax) ||
+        !(max_abs(F21) < big))
+      return fallback();
+    if (dupd) {
+      // Schur complement in lower precision, added to the
+      // contribution block in the working precision, in column
+      // blocks to limit the workspace
+      const std::size_t nb = FD_t::dense_tile_size;
+      DenseMlow_t S(dupd, std::min(nb, dupd));
+      for (std::size_t c=0; c<dupd; c+=nb) {
+        auto w = std::min(nb, dupd-c);
+        DenseMatrixWrapper<low_t> Sc(dupd, w, S, 0, 0),
+          F12c(dsep, w, F12, 0, c);
+        gemm(Trans::N, Trans::N, low_t(-1.), F21, F12c,
+             low_t(0.), Sc, task_depth);
+        for (std::size_t j=0; j<w; j++)
+          for (std::size_t i=0; i<dupd; i++)
+            this->F22_(i, c+j) += scalar_t(Sc(i, j));
+      }
+    }
+    STRUMPACK_FULL_RANK_FLOPS
+      (LU_flops(F11) +
+       gemm_flops(Trans::N, Trans::N, low_t(-1.), F21, F12, low_t(1.)) +
+       trsm_flops(Side::L, low_t(1.), F11, F12) +
+       trsm_flops(Side::R, low_t(1.), F11, F21));
+    F11l_ = std::move(F11);
+    F12l_ = std::move(F12);
+    F21l_ = std::move(F21);
+    this->piv_ = std::move(piv);
+    this->F11_.clear();
+    this->F12_.clear();
+    this->F21_.clear();
+    low_ = true;
+    return true;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixMixedPrecision<scalar_t,integer_t>::fwd_solve_phase2
+  (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
+    if (!low_) {
+      FD_t::fwd_solve_phase2(b, bupd, etree_level, task_depth);
+      return;
+    }
+    if (dim_sep()) {
+      DenseMW_t bloc(dim_sep(), b.cols(), b, this->sep_begin_, 0);
+      bloc.laswp(this->piv_, true);
+      DenseMlow_t bl(bloc.rows(), bloc.cols());
+      copy(bloc, bl);
+      if (b.cols() == 1)
+        trsv(UpLo::L, Trans::N, Diag::U, F11l_, bl, task_depth);
+      else
+        trsm(Side::L, UpLo::L, Trans::N, Diag::U,
+             low_t(1.), F11l_, bl, task_depth);
+      copy(bl, bloc);
+      if (dim_upd()) {
+        DenseMlow_t u(dim_upd(), b.cols());
+        gemm(Trans::N, Trans::N, low_t(-1.), F21l_, bl,
+             low_t(0.), u, task_depth);
+        for (std::size_t j=0; j<u.cols(); j++)
+          for (std::size_t i=0; i<u.rows(); i++)
+            bupd(i, j) += scalar_t(u(i, j));
+      }
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixMixedPrecision<scalar_t,integer_t>::bwd_solve_phase1
+  (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
+    if (!low_) {
+      FD_t::bwd_solve_phase1(y, yupd, etree_level, task_depth);
+      return;
+    }
+    if (dim_sep()) {
+      DenseMW_t yloc(dim_sep(), y.cols(), y, this->sep_begin_, 0);
+      DenseMlow_t yl(yloc.rows(), yloc.cols());
+      copy(yloc, yl);
+      if (dim_upd()) {
+        DenseMlow_t yu(yupd.rows(), yupd.cols());
+        copy(yupd, yu);
+        gemm(Trans::N, Trans::N, low_t(-1.), F12l_, yu,
+             low_t(1.), yl, task_depth);
+      }
+      if (y.cols() == 1)
+        trsv(UpLo::U, Trans::N, Diag::N, F11l_, yl, task_depth);
+      else
+        trsm(Side::L, UpLo::U, Trans::N, Diag::N,
+             low_t(1.), F11l_, yl, task_depth);
+      copy(yl, yloc);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontalMatrixMixedPrecision<scalar_t,integer_t>::node_inertia
+  (integer_t& neg, integer_t& zero, integer_t& pos) const {
+    if (!low_) return FD_t::node_inertia(neg, zero, pos);
+    DenseM_t F11(F11l_.rows(), F11l_.cols());
+    copy(F11l_, F11);
+    return this->matrix_inertia(F11, neg, zero, pos);
+  }
+
+  // explicit template instantiations
+  template class FrontalMatrixMixedPrecision<float,int>;
+  template class FrontalMatrixMixedPrecision<double,int>;
+  template class FrontalMatrixMixedPrecision<std::complex<float>,int>;
+  template class FrontalMatrixMixedPrecision<std::complex<double>,int>;
+
+  template class FrontalMatrixMixedPrecision<float,long int>;
+  template class FrontalMatrixMixedPrecision<double,long int>;
+  template class FrontalMatrixMixedPrecision<std::complex<float>,long int>;
+  template class FrontalMatrixMixedPrecision<std::complex<double>,long int>;
+
+  template class FrontalMatrixMixedPrecision<float,long long int>;
+  template class FrontalMatrixMixedPrecision<double,long long int>;
+  template class FrontalMatrixMixedPrecision<std::complex<float>,long long int>;
+  template class FrontalMatrixMixedPrecision<std::complex<double>,long long int>;
+
+} // end namespace strumpack
@@ -0,0 +1,105 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef FRONTAL_MATRIX_MIXED_PRECISION_HPP
+#define FRONTAL_MATRIX_MIXED_PRECISION_HPP
+
+#include "FrontalMatrixDense.hpp"
+
+namespace strumpack {
+
+  /**
+   * Dense front which is assembled in the working precision
+   * (scalar_t), but factored in lower precision, float or
+   * std::complex<float>. The factors are stored in lower precision,
+   * the contribution block is added to the parent front in the
+   * working precision. If the lower precision LU hits a zero pivot,
+   * produces non-finite values or shows large pivot growth, the
+   * front is factored in the working precision instead.
+   *
+   * \see SPOptions::enable_mixed_precision_fronts
+   */
+  template<typename scalar_t,typename integer_t>
+  class FrontalMatrixMixedPrecision
+    : public FrontalMatrixDense<scalar_t,integer_t> {
+    using F_t = FrontalMatrix<scalar_t,integer_t>;
+    using FD_t = FrontalMatrixDense<scalar_t,integer_t>;
+    using DenseM_t = DenseMatrix<scalar_t>;
+    using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    using SpMat_t = CompressedSparseMatrix<scalar_t,integer_t>;
+    using Opts_t = SPOptions<scalar_t>;
+    using low_t = typename LowerPrecisionType<scalar_t>::value_type;
+    using DenseMlow_t = DenseMatrix<low_t>;
+
+  public:
+    FrontalMatrixMixedPrecision(integer_t sep, integer_t sep_begin,
+                                integer_t sep_end,
+                                std::vector<integer_t>& upd);
+
+    std::string type() const override {
+      return "FrontalMatrixMixedPrecision";
+    }
+
+    void delete_factors() override;
+
+    long long node_factor_nonzeros() const override;
+
+    /**
+     * Whether the factors of this front are stored in lower
+     * precision, false if it fell back to the working precision.
+     */
+    bool lower_precision() const { return low_; }
+
+  private:
+    DenseMlow_t F11l_, F12l_, F21l_;
+    bool low_ = false;
+
+    ReturnCode factor_phase2(const SpMat_t& A, const Opts_t& opts,
+                             int etree_level, int task_depth) override;
+    bool factor_lower_precision(const Opts_t& opts, int etree_level,
+                                int task_depth);
+
+    void fwd_solve_phase2(DenseM_t& b, DenseM_t& bupd,
+                          int etree_level, int task_depth) const override;
+    void bwd_solve_phase1(DenseM_t& y, DenseM_t& yupd,
+                          int etree_level, int task_depth) const override;
+
+    ReturnCode node_inertia(integer_t& neg, integer_t& zero,
+                            integer_t& pos) const override;
+
+    FrontalMatrixMixedPrecision(const FrontalMatrixMixedPrecision&) = delete;
+    FrontalMatrixMixedPrecision&
+    operator=(FrontalMatrixMixedPrecision const&) = delete;
+
+    using F_t::dim_sep;
+    using F_t::dim_upd;
+  };
+
+} // end namespace strumpack
+
+#endif // FRONTAL_MATRIX_MIXED_PRECISION_HPP
@@ -150,6 +150,39 @@ namespace strumpack {
     return 0;
   }
 
+  template<typename scalar_t,typename integer_t> int
+  MatrixReordering<scalar_t,integer_t>::set_separator_tree
+  (const Opts_t& opts, const CSR_t& A, const int* p,
+   const SeparatorTree<integer_t>& tree, int base) {
+    auto n = perm_.size();
+    assert(A.size() == integer_t(n));
+    if (base == 0) std::copy(p, p+n, perm_.data());
+    else for (std::size_t i=0; i<n; i++) perm_[i] = p[i] - base;
+    if (!check_sep_tree_ordering(tree, perm_, A.ptr(), A.ind(),
+                                 integer_t(0), A.size())) {
+      std::cerr << "# ERROR: separator tree does not match the"
+                << " permutation and the sparsity pattern" << std::endl;
+      return 1;
+    }
+    for (std::size_t i=0; i<n; i++) iperm_[perm_[i]] = i;
+    tree_ = tree;
+    nested_dissection_print(opts, A.nnz(), opts.verbose());
+    return 0;
+  }
+
+  template<typename scalar_t,typename integer_t> int
+  MatrixReordering<scalar_t,integer_t>::set_reordering
+  (const Opts_t& opts, const CSR_t& A, const std::vector<integer_t>& perm,
+   const std::vector<integer_t>& iperm, const SeparatorTree<integer_t>& tree) {
+    if (perm.size() != perm_.size() || iperm.size() != iperm_.size())
+      return 1;
+    perm_ = perm;
+    iperm_ = iperm;
+    tree_ = tree;
+    nested_dissection_print(opts, A.nnz(), opts.verbose());
+    return 0;
+  }
+
   template<typename scalar_t,typename integer_t> void
   MatrixReordering<scalar_t,integer_t>::clear_tree_data() {
     tree_ = SeparatorTree<integer_t>();
@@ -61,6 +61,16 @@ namespace strumpack {
     int set_permutation(const Opts_t& opts, const CSR_t& A,
                         const int* p, int base);
 
+    int set_separator_tree(const Opts_t& opts, const CSR_t& A,
+                           const int* p, const SeparatorTree<integer_t>& tree,
+                           int base);
+
+    // copy perm, iperm and tree from an earlier (symbolic) analysis
+    int set_reordering(const Opts_t& opts, const CSR_t& A,
+                       const std::vector<integer_t>& perm,
+                       const std::vector<integer_t>& iperm,
+                       const SeparatorTree<integer_t>& tree);
+
     void separator_reordering(const Opts_t& opts, CSR_t& A, F_t* F);
 
     virtual void clear_tree_data();
@@ -237,6 +237,35 @@ namespace strumpack {
     return 0;
   }
 
+  /**
+   * The tree should be the same on all processes, no communication
+   * is required to construct the global separator tree.
+   */
+  template<typename scalar_t,typename integer_t> int
+  MatrixReorderingMPI<scalar_t,integer_t>::set_separator_tree
+  (const Opts_t& opts, const CSRMPI_t& A, const int* p,
+   const SeparatorTree<integer_t>& tree, int base) {
+    auto n = perm_.size();
+    assert(A.size() == integer_t(n));
+    if (base == 0) std::copy(p, p+n, perm_.data());
+    else for (std::size_t i=0; i<n; i++) perm_[i] = p[i] - base;
+    int ok = check_sep_tree_ordering
+      (tree, perm_, A.ptr(), A.ind(), A.begin_row(), A.end_row());
+    if (!comm_->all_reduce(ok, MPI_MIN)) {
+      if (comm_->is_root())
+        std::cerr << "# ERROR: separator tree does not match the"
+                  << " permutation and the sparsity pattern" << std::endl;
+      return 1;
+    }
+    ltree_ = tree.subtree(comm_->rank(), comm_->size());
+    tree_ = tree.toptree(comm_->size());
+    for (std::size_t i=0; i<n; i++)
+      iperm_[perm_[i]] = i;
+    get_local_graphs(A);
+    nested_dissection_print(opts, A.nnz());
+    return 0;
+  }
+
   template<typename scalar_t,typename integer_t> void
   MatrixReorderingMPI<scalar_t,integer_t>::separator_reordering
   (const Opts_t& opts, CSM_t& A, F_t* F) {
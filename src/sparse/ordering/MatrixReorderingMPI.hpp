@@ -93,6 +93,10 @@ namespace strumpack {
     int set_permutation(const Opts_t& opts, const CSRMPI_t& A,
                         const int* p, int base);
 
+    int set_separator_tree(const Opts_t& opts, const CSRMPI_t& A,
+                           const int* p, const SeparatorTree<integer_t>& tree,
+                           int base);
+
     void separator_reordering(const Opts_t& opts, CSM_t& A, F_t* F);
 
     void clear_tree_data() override;
@@ -0,0 +1,254 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <algorithm>
+#include <iterator>
+using namespace std;
+
+#include "dense/DistributedMatrix.hpp"
+#include "clustering/Clustering.hpp"
+#include "clustering/NeighborSearch.hpp"
+#include "kernel/KernelRegression.hpp"
+#include "misc/RandomWrapper.hpp"
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+#define SOLVE_TOLERANCE 1e-12
+
+
+// the same points on every process, the random generator has a
+// fixed seed
+DenseMatrix<double> random_points(int d, int n) {
+  DenseMatrix<double> P(d, n);
+  auto rgen = random::make_default_random_generator<double>();
+  for (int j=0; j<n; j++)
+    for (int i=0; i<d; i++)
+      P(i, j) = rgen->get();
+  return P;
+}
+
+int test_neighbors(const MPIComm& c, int n) {
+  int d = 4, k = 32, iters = 5;
+  auto P = random_points(d, n);
+  DenseMatrix<unsigned int> nb, seq_nb, true_nb(k, n);
+  DenseMatrix<double> sc, seq_sc, true_sc(k, n);
+  find_approximate_neighbors(c, P, iters, k, nb, sc);
+  // all processes build the same trees as the sequential code, so
+  // the result should be identical
+  find_approximate_neighbors(P, iters, k, seq_nb, seq_sc);
+  vector<size_t> all(n);
+  iota(all.begin(), all.end(), 0);
+  find_true_nn(P, all, true_nb, true_sc);
+  double recall = 0.;
+  int diff = 0;
+  for (int j=0; j<n; j++) {
+    vector<unsigned int> a(nb.ptr(0, j), nb.ptr(0, j)+k),
+      t(true_nb.ptr(0, j), true_nb.ptr(0, j)+k);
+    sort(a.begin(), a.end());
+    sort(t.begin(), t.end());
+    vector<unsigned int> common;
+    set_intersection(a.begin(), a.end(), t.begin(), t.end(),
+                     back_inserter(common));
+    recall += double(common.size()) / k;
+    for (int i=0; i<k; i++)
+      if (nb(i, j) != seq_nb(i, j) || sc(i, j) != seq_sc(i, j))
+        diff++;
+  }
+  recall /= n;
+  diff = c.all_reduce(diff, MPI_SUM);
+  auto min_recall = c.all_reduce(recall, MPI_MIN);
+  if (c.is_root())
+    cout << "# ANN recall = " << min_recall
+         << ", entries different from sequential = " << diff << endl;
+  if (min_recall < 0.95) {
+    if (c.is_root())
+      cout << "ERROR: approximate neighbors are of poor quality" << endl;
+    return 1;
+  }
+  if (diff) {
+    if (c.is_root())
+      cout << "ERROR: neighbors differ from the sequential search" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int test_treecode(const MPIComm& c, int n) {
+  int d = 3, m = 500;
+  auto P = random_points(d, n);
+  auto test = random_points(d, m);
+  // the fit is done redundantly on every process
+  HSS::HSSOptions<double> opts;
+  opts.set_verbose(false);
+  opts.set_leaf_size(64);
+  kernel::GaussKernel<double> K(P, 0.3, 1.);
+  vector<double> labels(n);
+  for (int i=0; i<n; i++)
+    labels[i] = (P(0, i) > 0) ? 1. : -1.;
+  auto weights = K.fit_HSS(labels, opts);
+  auto direct = K.predict(test, weights);
+  double nrm = 0.;
+  for (auto p : direct) nrm += p * p;
+  nrm = sqrt(nrm);
+  double prev_err = 1.;
+  for (double tol : {1e-4, 1e-8}) {
+    kernel::Treecode<double> T(K, weights, tol);
+    auto tc = T.predict(c, test);
+    auto tc_seq = T.predict(test);
+    double err = 0.;
+    int diff = 0;
+    for (int i=0; i<m; i++) {
+      err += (tc[i] - direct[i]) * (tc[i] - direct[i]);
+      if (tc[i] != tc_seq[i]) diff++;
+    }
+    err = c.all_reduce(sqrt(err) / nrm, MPI_MAX);
+    diff = c.all_reduce(diff, MPI_SUM);
+    if (c.is_root())
+      cout << "# treecode rel_tol = " << tol << ", max rank = "
+           << T.max_rank() << ", relative error vs direct = "
+           << err << ", entries different from sequential = "
+           << diff << endl;
+    if (err > ERROR_TOLERANCE * tol || err > prev_err) {
+      if (c.is_root())
+        cout << "ERROR: treecode prediction error too big" << endl;
+      return 1;
+    }
+    if (diff) {
+      if (c.is_root())
+        cout << "ERROR: prediction differs from the sequential treecode"
+             << endl;
+      return 1;
+    }
+    prev_err = err;
+  }
+  return 0;
+}
+
+int test_clustering(const MPIComm& c, int n) {
+  int d = 3;
+  size_t cluster_size = 64;
+  auto P = random_points(d, n);
+  for (auto algo : {ClusteringAlgorithm::TWO_MEANS,
+                    ClusteringAlgorithm::KD_TREE,
+                    ClusteringAlgorithm::PCA,
+                    ClusteringAlgorithm::COBBLE}) {
+    for (bool balanced : {false, true}) {
+      DenseMatrix<double> Pseq(P), Pdist(P);
+      vector<int> seq_perm, perm;
+      auto seq_t = binary_tree_clustering
+        (algo, Pseq, seq_perm, cluster_size, balanced);
+      auto t = binary_tree_clustering
+        (c, algo, Pdist, perm, cluster_size, balanced);
+      // the distributed clustering should give the same result as
+      // the sequential clustering, on all processes
+      int diff = (perm != seq_perm || t.serialize() != seq_t.serialize() ||
+                  !equal(Pdist.data(), Pdist.data()+d*n, Pseq.data()));
+      diff = c.all_reduce(diff, MPI_SUM);
+      if (c.is_root())
+        cout << "# " << get_name(algo) << ", balanced = " << boolalpha
+             << balanced << ", leafs = " << t.leaf_sizes<int>().size()
+             << ", processes different from sequential = " << diff
+             << endl;
+      if (diff) {
+        if (c.is_root())
+          cout << "ERROR: clustering differs from the sequential clustering"
+               << endl;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+int run(int argc, char* argv[]) {
+  int n = 1000;
+  MPIComm c;
+
+  auto usage = [&]() {
+    if (!mpi_rank()) {
+      cout << "# Usage:\n"
+      << "#     OMP_NUM_THREADS=4 ./test_kernel_mpi problem n\n"
+      << "# where:\n"
+      << "#  - problem: a char that can be\n"
+      << "#      't': treecode prediction, compared to direct and to\n"
+      << "#           the sequential treecode prediction\n"
+      << "#      'n': approximate nearest neighbors, compared to the\n"
+      << "#           exact and the sequential nearest neighbors\n"
+      << "#      'c': clustering, compared to the sequential\n"
+      << "#           clustering\n"
+      << "#  - n: number of data points\n";
+    }
+    exit(1);
+  };
+
+  char test_problem = 'n';
+  if (argc > 1) test_problem = argv[1][0];
+  else usage();
+  if (argc > 2) n = stoi(argv[2]);
+  if (n <= 0) {
+    if (!mpi_rank())
+      cout << "# number of points should be positive integer" << endl;
+    usage();
+  }
+
+  switch (test_problem) {
+  case 'n': return test_neighbors(c, n);
+  case 't': return test_treecode(c, n);
+  case 'c': return test_clustering(c, n);
+  default: usage();
+  }
+  return 1;
+}
+
+
+int main(int argc, char* argv[]) {
+  MPI_Init(&argc, &argv);
+  if (!mpi_rank()) {
+    cout << "# Running with:\n# ";
+#if defined(_OPENMP)
+    cout << "OMP_NUM_THREADS=" << omp_get_max_threads()
+         << " mpirun -n " << mpi_nprocs() << " ";
+#else
+    cout << "mpirun -n " << mpi_nprocs() << " ";
+#endif
+    for (int i=0; i<argc; i++) cout << argv[i] << " ";
+    cout << endl;
+  }
+
+  int ierr;
+#pragma omp parallel
+#pragma omp single nowait
+  ierr = run(argc, argv);
+
+  scalapack::Cblacs_exit(1);
+  MPI_Finalize();
+  return ierr;
+}
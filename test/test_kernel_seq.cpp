@@ -0,0 +1,403 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <iterator>
+using namespace std;
+
+#include "kernel/KernelRegression.hpp"
+#include "kernel/Kernel.h"
+#include "clustering/Clustering.hpp"
+#include "clustering/NeighborSearch.hpp"
+#include "misc/RandomWrapper.hpp"
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+#define SOLVE_TOLERANCE 1e-12
+
+
+DenseMatrix<double> random_points(int d, int n) {
+  DenseMatrix<double> P(d, n);
+  auto rgen = random::make_default_random_generator<double>();
+  for (int j=0; j<n; j++)
+    for (int i=0; i<d; i++)
+      P(i, j) = rgen->get();
+  return P;
+}
+
+double max_diff(const DenseMatrix<double>& A, const DenseMatrix<double>& B) {
+  double e = 0.;
+  for (size_t j=0; j<A.cols(); j++)
+    for (size_t i=0; i<A.rows(); i++)
+      e = max(e, abs(A(i, j) - B(i, j)));
+  return e;
+}
+
+int test_mapped_data(int n, const HSS::HSSOptions<double>& opts) {
+  int d = 3;
+  string csv = "kernel_data.csv", bin = "kernel_data.bin";
+  auto P = random_points(d, n);
+  {
+    ofstream f(csv);
+    f.precision(17);
+    for (int j=0; j<n; j++)
+      for (int i=0; i<d; i++)
+        f << P(i, j) << ((i == d-1) ? "\n" : ",");
+  }
+  // small chunk, to test the streaming
+  if (kernel::MappedData<double>::from_csv(csv, bin, 7) != size_t(d)) {
+    cout << "ERROR: wrong dimension from from_csv" << endl;
+    return 1;
+  }
+  auto Q = random_points(d, 10);
+  kernel::MappedData<double>::append(bin, Q);
+  DenseMatrix<double> PQ(d, n+10);
+  copy(P, PQ, 0, 0);
+  copy(Q, PQ, 0, n);
+  {
+    kernel::MappedData<double> data(bin, d);
+    auto e = (data.n() == size_t(n+10)) ? max_diff(data.matrix(), PQ) : 1.;
+    cout << "# from_csv/append, max error = " << e << endl;
+    if (e > SOLVE_TOLERANCE) {
+      cout << "ERROR: mapped data does not match the input" << endl;
+      return 1;
+    }
+  }
+  for (bool shared : {false, true}) {
+    vector<int> perm;
+    {
+      kernel::MappedData<double> data(bin, d, shared);
+      kernel::GaussKernel<double> K(data.matrix(), 1., 1.);
+      vector<double> labels(K.n(), 1.);
+      K.fit_HSS(labels, opts);
+      perm = K.permutation();
+      bool identity = true;
+      for (size_t i=0; i<perm.size(); i++)
+        if (perm[i] != int(i)) identity = false;
+      if (perm.size() != K.n() || identity) {
+        cout << "ERROR: no permutation from the clustering" << endl;
+        return 1;
+      }
+      // the mapping itself is always reordered
+      DenseMatrix<double> PQperm(PQ);
+      PQperm.lapmt(perm, true);
+      auto e = max_diff(data.matrix(), PQperm);
+      cout << "# shared = " << boolalpha << shared
+           << ", mapped data permutation error = " << e << endl;
+      if (e > SOLVE_TOLERANCE) {
+        cout << "ERROR: mapped data not permuted" << endl;
+        return 1;
+      }
+      data.sync();
+    }
+    // a private mapping leaves the file untouched, a shared mapping
+    // writes the reordered points back to the file
+    kernel::MappedData<double> data(bin, d);
+    DenseMatrix<double> PQperm(PQ);
+    if (shared) PQperm.lapmt(perm, true);
+    auto e = max_diff(data.matrix(), PQperm);
+    cout << "# shared = " << boolalpha << shared
+         << ", file error = " << e << endl;
+    if (e > SOLVE_TOLERANCE) {
+      cout << "ERROR: file does not contain the expected data" << endl;
+      return 1;
+    }
+  }
+  remove(csv.c_str());
+  remove(bin.c_str());
+  return 0;
+}
+
+int test_neighbors(int n) {
+  int d = 4, k = 32, iters = 5;
+  auto P = random_points(d, n);
+  DenseMatrix<unsigned int> nb, true_nb(k, n);
+  DenseMatrix<double> sc, true_sc(k, n);
+  find_approximate_neighbors(P, iters, k, nb, sc);
+  vector<size_t> all(n);
+  iota(all.begin(), all.end(), 0);
+  find_true_nn(P, all, true_nb, true_sc);
+  // recall: fraction of the true k nearest neighbors which are found
+  double recall = 0., score_err = 0.;
+  for (int j=0; j<n; j++) {
+    vector<unsigned int> a(nb.ptr(0, j), nb.ptr(0, j)+k),
+      t(true_nb.ptr(0, j), true_nb.ptr(0, j)+k);
+    sort(a.begin(), a.end());
+    sort(t.begin(), t.end());
+    vector<unsigned int> common;
+    set_intersection(a.begin(), a.end(), t.begin(), t.end(),
+                     back_inserter(common));
+    recall += double(common.size()) / k;
+    for (int i=0; i<k; i++)
+      score_err = max
+        (score_err, abs(sc(i, j) - Euclidean_distance_squared
+                        (d, P.ptr(0, j), P.ptr(0, nb(i, j)))));
+  }
+  recall /= n;
+  cout << "# ANN recall = " << recall
+       << ", max score error = " << score_err << endl;
+  if (recall < 0.95) {
+    cout << "ERROR: approximate neighbors are of poor quality" << endl;
+    return 1;
+  }
+  if (score_err > SOLVE_TOLERANCE) {
+    cout << "ERROR: scores are not the distances to the neighbors" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int test_treecode(int n, const HSS::HSSOptions<double>& opts) {
+  int d = 3, m = 500;
+  auto P = random_points(d, n);
+  auto test = random_points(d, m);
+  kernel::GaussKernel<double> K(P, 0.3, 1.);
+  vector<double> labels(n);
+  for (int i=0; i<n; i++)
+    labels[i] = (P(0, i) > 0) ? 1. : -1.;
+  auto weights = K.fit_HSS(labels, opts);
+  auto direct = K.predict(test, weights);
+  double nrm = 0.;
+  for (auto p : direct) nrm += p * p;
+  nrm = sqrt(nrm);
+  double prev_err = 1.;
+  for (double tol : {1e-4, 1e-8}) {
+    kernel::Treecode<double> T(K, weights, tol);
+    auto tc = T.predict(test);
+    double err = 0.;
+    for (int i=0; i<m; i++)
+      err += (tc[i] - direct[i]) * (tc[i] - direct[i]);
+    err = sqrt(err) / nrm;
+    cout << "# treecode rel_tol = " << tol << ", max rank = "
+         << T.max_rank() << ", relative error vs direct = "
+         << err << endl;
+    if (err > ERROR_TOLERANCE * tol || err > prev_err) {
+      cout << "ERROR: treecode prediction error too big" << endl;
+      return 1;
+    }
+    prev_err = err;
+  }
+  // a wide kernel with little regularization, the weights are large
+  // and cancel, the error is controlled with the absolute tolerance
+  kernel::GaussKernel<double> Kw(P, 1., 1e-2);
+  weights = Kw.fit_HSS(labels, opts);
+  direct = Kw.predict(test, weights);
+  nrm = 0.;
+  double nrm_inf = 0.;
+  for (auto p : direct) {
+    nrm += p * p;
+    nrm_inf = std::max(nrm_inf, std::abs(p));
+  }
+  nrm = sqrt(nrm);
+  double tol = 1e-4;
+  kernel::Treecode<double> T(Kw, weights, 1e-14, tol * nrm_inf);
+  auto tc = T.predict(test);
+  double err = 0.;
+  for (int i=0; i<m; i++)
+    err += (tc[i] - direct[i]) * (tc[i] - direct[i]);
+  err = sqrt(err) / nrm;
+  cout << "# treecode abs_tol = " << tol * nrm_inf << ", max rank = "
+       << T.max_rank() << ", relative error vs direct = "
+       << err << endl;
+  if (err > ERROR_TOLERANCE * tol) {
+    cout << "ERROR: treecode prediction error too big" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int test_multi_output(int n, int argc, char* argv[]) {
+  int d = 3, m = 500, nc = 3;
+  // test points are the last m points
+  auto PT = random_points(d, n+m);
+  DenseMatrix<double> P(d, n), test(d, m);
+  for (int j=0; j<n+m; j++)
+    for (int i=0; i<d; i++)
+      if (j < n) P(i, j) = PT(i, j);
+      else test(i, j-n) = PT(i, j);
+  auto cls = [](double x) { return (x < -.5) ? 0 : ((x < .5) ? 1 : 2); };
+  // one-vs-all labels, +1 for the class, -1 for all others, stored
+  // column major n x nc, as in the python interface
+  DenseMatrix<double> labels(n, nc);
+  for (int c=0; c<nc; c++)
+    for (int i=0; i<n; i++)
+      labels(i, c) = (cls(P(0, i)) == c) ? 1. : -1.;
+  DenseMatrix<double> pred(m, nc), single(m, nc);
+  {
+    DenseMatrix<double> L(labels);
+    auto K = STRUMPACK_create_kernel_double(n, d, P.data(), 1., 1., 1, 0);
+    STRUMPACK_kernel_fit_HSS_multi_double(K, nc, L.data(), argc, argv);
+    STRUMPACK_kernel_predict_multi_double(K, m, test.data(), pred.data());
+    STRUMPACK_destroy_kernel_double(K);
+  }
+  // reference: a separate fit for every output
+  for (int c=0; c<nc; c++) {
+    vector<double> L(labels.ptr(0, c), labels.ptr(0, c)+n);
+    auto K = STRUMPACK_create_kernel_double(n, d, P.data(), 1., 1., 1, 0);
+    STRUMPACK_kernel_fit_HSS_double(K, L.data(), argc, argv);
+    STRUMPACK_kernel_predict_double(K, m, test.data(), single.ptr(0, c));
+    STRUMPACK_destroy_kernel_double(K);
+  }
+  auto e = max_diff(pred, single) / single.normF();
+  int correct = 0;
+  for (int i=0; i<m; i++) {
+    int c = 0;
+    for (int k=1; k<nc; k++)
+      if (pred(i, k) > pred(i, c)) c = k;
+    if (c == cls(test(0, i))) correct++;
+  }
+  double acc = double(correct) / m;
+  cout << "# multi-output vs single output, relative error = " << e
+       << ", one-vs-all accuracy = " << acc << endl;
+  if (e > ERROR_TOLERANCE * SOLVE_TOLERANCE) {
+    cout << "ERROR: multi-output fit differs from single output fits"
+         << endl;
+    return 1;
+  }
+  if (acc < 0.9) {
+    cout << "ERROR: one-vs-all classification accuracy too low" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+bool is_balanced(const structured::ClusterTree& t) {
+  if (t.c.empty()) return true;
+  return t.c[0].size == t.size / 2 &&
+    is_balanced(t.c[0]) && is_balanced(t.c[1]);
+}
+
+int test_clustering(int n) {
+  int d = 3;
+  size_t cluster_size = 64;
+  auto P = random_points(d, n);
+  for (auto algo : {ClusteringAlgorithm::TWO_MEANS,
+                    ClusteringAlgorithm::KD_TREE,
+                    ClusteringAlgorithm::PCA,
+                    ClusteringAlgorithm::COBBLE}) {
+    for (bool balanced : {false, true}) {
+      DenseMatrix<double> P1(P), Pt(P);
+      vector<int> perm1, perm;
+      structured::ClusterTree t1;
+      // reference, with a single thread
+#pragma omp parallel num_threads(1)
+#pragma omp single
+      t1 = binary_tree_clustering
+        (algo, P1, perm1, cluster_size, balanced);
+      auto t = binary_tree_clustering
+        (algo, Pt, perm, cluster_size, balanced);
+      DenseMatrix<double> Pperm(P);
+      Pperm.lapmt(perm, true);
+      auto e = max_diff(Pt, Pperm);
+      cout << "# " << get_name(algo) << ", balanced = " << boolalpha
+           << balanced << ", leafs = " << t.leaf_sizes<int>().size()
+           << ", permuted data error = " << e << endl;
+      if (perm != perm1 || t.serialize() != t1.serialize()) {
+        cout << "ERROR: clustering depends on the number of threads"
+             << endl;
+        return 1;
+      }
+      if (e != 0. || t.size != n || t.c.empty()) {
+        cout << "ERROR: wrong clustering" << endl;
+        return 1;
+      }
+      if (balanced && !is_balanced(t)) {
+        cout << "ERROR: balanced clustering is not balanced" << endl;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+int run(int argc, char* argv[]) {
+  int n = 1000;
+  HSS::HSSOptions<double> hss_opts;
+  hss_opts.set_verbose(false);
+
+  auto usage = [&]() {
+    cout << "# Usage:\n"
+    << "#     OMP_NUM_THREADS=4 ./test_kernel_seq problem n [HSS Options]\n"
+    << "# where:\n"
+    << "#  - problem: a char that can be\n"
+    << "#      'm': memory mapped data, from_csv, append and the\n"
+    << "#           reordering by the clustering\n"
+    << "#      't': treecode prediction, compared to direct prediction\n"
+    << "#      'n': approximate nearest neighbors, compared to the\n"
+    << "#           exact nearest neighbors\n"
+    << "#      'c': clustering, compared to clustering with a\n"
+    << "#           single thread, and balanced clustering\n"
+    << "#      'o': multi-output (one-vs-all) fit and prediction\n"
+    << "#           through the C interface, compared to single\n"
+    << "#           output fits\n"
+    << "#  - n: number of data points\n";
+    hss_opts.describe_options();
+    exit(1);
+  };
+
+  char test_problem = 'm';
+  if (argc > 1) test_problem = argv[1][0];
+  else usage();
+  if (argc > 2) n = stoi(argv[2]);
+  if (n <= 0) {
+    cout << "# number of points should be positive integer" << endl;
+    usage();
+  }
+  hss_opts.set_from_command_line(argc, argv);
+
+  switch (test_problem) {
+  case 'm': return test_mapped_data(n, hss_opts);
+  case 'n': return test_neighbors(n);
+  case 't': return test_treecode(n, hss_opts);
+  case 'o': return test_multi_output(n, argc, argv);
+  case 'c': return test_clustering(n);
+  default: usage();
+  }
+  return 1;
+}
+
+
+int main(int argc, char* argv[]) {
+  cout << "# Running with:\n# ";
+#if defined(_OPENMP)
+  cout << "OMP_NUM_THREADS=" << omp_get_max_threads() << " ";
+#endif
+  for (int i=0; i<argc; i++) cout << argv[i] << " ";
+  cout << endl;
+
+  int ierr;
+#pragma omp parallel
+#pragma omp single nowait
+  ierr = run(argc, argv);
+  return ierr;
+}
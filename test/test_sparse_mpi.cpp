@@ -29,6 +29,7 @@
 #include <iostream>
 #include <vector>
 #include <cstring>
+#include <functional>
 using namespace std;
 
 #define ERROR_TOLERANCE 1e2
@@ -49,6 +50,55 @@ void abort_MPI(MPI_Comm *c, int *error, ...) {
   abort();
 }
 
+/*
+ * Nested dissection of a regular nx x ny x nz mesh, used to test a
+ * user-supplied permutation and separator tree.
+ */
+template<typename integer_t> SeparatorTree<integer_t>
+mesh_separator_tree(int nx, int ny, int nz, vector<int>& perm) {
+  perm.resize(nx*ny*nz);
+  vector<Separator<integer_t>> seps;
+  integer_t next = 0;
+  auto number = [&](int x0, int x1, int y0, int y1, int z0, int z1) {
+    for (int z=z0; z<z1; z++)
+      for (int y=y0; y<y1; y++)
+        for (int x=x0; x<x1; x++)
+          perm[x+nx*(y+ny*z)] = next++;
+  };
+  function<integer_t(int,int,int,int,int,int)> nd =
+    [&](int x0, int x1, int y0, int y1, int z0, int z1) {
+      int dx = x1-x0, dy = y1-y0, dz = z1-z0;
+      if (dx*dy*dz <= 8 || std::max(dx, std::max(dy, dz)) < 3) {
+        number(x0, x1, y0, y1, z0, z1);
+        seps.emplace_back(next, -1, -1, -1);
+        return integer_t(seps.size()-1);
+      }
+      integer_t l, r;
+      if (dx >= dy && dx >= dz) {
+        int m = x0 + dx/2;
+        l = nd(x0, m, y0, y1, z0, z1);
+        r = nd(m+1, x1, y0, y1, z0, z1);
+        number(m, m+1, y0, y1, z0, z1);
+      } else if (dy >= dz) {
+        int m = y0 + dy/2;
+        l = nd(x0, x1, y0, m, z0, z1);
+        r = nd(x0, x1, m+1, y1, z0, z1);
+        number(x0, x1, m, m+1, z0, z1);
+      } else {
+        int m = z0 + dz/2;
+        l = nd(x0, x1, y0, y1, z0, m);
+        r = nd(x0, x1, y0, y1, m+1, z1);
+        number(x0, x1, y0, y1, m, m+1);
+      }
+      seps.emplace_back(next, -1, l, r);
+      integer_t sep = seps.size()-1;
+      seps[l].pa = seps[r].pa = sep;
+      return sep;
+    };
+  nd(0, nx, 0, ny, 0, nz);
+  return SeparatorTree<integer_t>(seps);
+}
+
 template<typename scalar_t,typename integer_t>
 int test_sparse_solver(int argc, const char* const argv[],
                        CSRMatrix<scalar_t,integer_t>& A) {
@@ -101,6 +151,44 @@ int test_sparse_solver(int argc, const char* const argv[],
       cout << "residual too large" << endl;
     MPI_Abort(MPI_COMM_WORLD, 1);
   }
+
+  bool test_user_separator_tree = false;
+  for (int i=1; i<argc; i++)
+    if (!strcmp(argv[i], "--test_user_separator_tree"))
+      test_user_separator_tree = true;
+  if (test_user_separator_tree) {
+    // nested dissection of the regular mesh, passed to a new solver
+    // as a user-supplied permutation and separator tree, the same on
+    // all processes
+    auto nx = spss.options().nx(), ny = spss.options().ny(),
+      nz = spss.options().nz();
+    if (nx*ny*nz != N) {
+      if (!rank)
+        cout << "--test_user_separator_tree requires --sp_nx/ny/nz." << endl;
+      MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    vector<int> perm;
+    auto tree = mesh_separator_tree<integer_t>(nx, ny, nz, perm);
+    StrumpackSparseSolverMPIDist<scalar_t,integer_t> spss_tree(MPI_COMM_WORLD);
+    spss_tree.options().set_from_command_line(argc, argv);
+    spss_tree.set_matrix(Adist);
+    if (spss_tree.reorder(perm.data(), tree) != ReturnCode::SUCCESS) {
+      if (!rank)
+        cout << "problem with user-supplied separator tree." << endl;
+      MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    Adist.spmv(x_exact.data(), b.data());
+    spss_tree.solve(b.data(), x.data());
+    scaled_res = Adist.max_scaled_residual(x.data(), b.data());
+    if (!rank)
+      cout << "# COMPONENTWISE SCALED RESIDUAL (USER SEPARATOR TREE) = "
+           << scaled_res << endl;
+    if (scaled_res > ERROR_TOLERANCE*spss.options().rel_tol()) {
+      if (!rank)
+        cout << "residual too large" << endl;
+      MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+  }
   return 0;
 }
 
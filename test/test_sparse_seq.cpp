@@ -27,18 +27,200 @@
  *
  */
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <cstring>
+#include <functional>
 using namespace std;
 
 #include "StrumpackSparseSolver.hpp"
+#include "StrumpackSparseSolverMixedPrecision.hpp"
 #include "sparse/CSRMatrix.hpp"
 #include "misc/RandomWrapper.hpp"
+#include "misc/FrontTrace.hpp"
 
 using namespace strumpack;
 
 #define ERROR_TOLERANCE 1e2
 #define SOLVE_TOLERANCE 1e-12
 
+template<typename scalar_t,typename integer_t> int
+compare_task_dag(int argc, const char* const argv[],
+                 const CSRMatrix<scalar_t,integer_t>& A,
+                 int nx=0, int ny=1, int nz=1) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  int N = A.size();
+  vector<scalar_t> b(N), x_dag(N), x_rec(N);
+  {
+    auto rgen = random::make_default_random_generator<real_t>();
+    for (auto& bi : b)
+      bi = rgen->get();
+  }
+  // factor with the task graph and with the recursive tree
+  // traversal, the results should agree up to roundoff
+  for (bool dag : {true, false}) {
+    StrumpackSparseSolver<scalar_t,integer_t> spss;
+    spss.options().set_from_command_line(argc, argv);
+    spss.options().set_Krylov_solver(KrylovSolver::DIRECT);
+    if (dag) spss.options().enable_task_dag();
+    else spss.options().disable_task_dag();
+    if (nx) spss.options().set_reordering_method
+              (ReorderingStrategy::GEOMETRIC);
+    spss.set_matrix(A);
+    if (spss.reorder(std::max(nx, 1), ny, nz) != ReturnCode::SUCCESS ||
+        spss.factor() != ReturnCode::SUCCESS) {
+      cout << "problem with the factorization." << endl;
+      return 1;
+    }
+    spss.solve(b.data(), dag ? x_dag.data() : x_rec.data());
+  }
+  auto nrm_x = blas::nrm2(N, x_rec.data(), 1);
+  blas::axpy(N, scalar_t(-1.), x_rec.data(), 1, x_dag.data(), 1);
+  auto rel_diff = blas::nrm2(N, x_dag.data(), 1) / nrm_x;
+  cout << "# RELATIVE DIFFERENCE TASK GRAPH/RECURSIVE = "
+       << rel_diff << endl;
+  if (rel_diff > SOLVE_TOLERANCE) {
+    cout << "TASK GRAPH FACTORIZATION DOES NOT MATCH!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+template<typename scalar_t,typename integer_t> int
+test_task_dag(int argc, const char* const argv[],
+              const CSRMatrix<scalar_t,integer_t>& A) {
+  if (compare_task_dag(argc, argv, A))
+    return 1;
+  // 3D Laplacian, the top separators are larger than the tile size
+  // and are factored with the tiled LU
+  int n = 20, N = n*n*n;
+  vector<integer_t> ptr(N+1), ind;
+  vector<scalar_t> val;
+  for (int z=0; z<n; z++)
+    for (int y=0; y<n; y++)
+      for (int x=0; x<n; x++) {
+        int i = x+n*(y+n*z);
+        if (z > 0)   { ind.push_back(i-n*n); val.push_back(-1.); }
+        if (y > 0)   { ind.push_back(i-n);   val.push_back(-1.); }
+        if (x > 0)   { ind.push_back(i-1);   val.push_back(-1.); }
+        ind.push_back(i); val.push_back(6.);
+        if (x < n-1) { ind.push_back(i+1);   val.push_back(-1.); }
+        if (y < n-1) { ind.push_back(i+n);   val.push_back(-1.); }
+        if (z < n-1) { ind.push_back(i+n*n); val.push_back(-1.); }
+        ptr[i+1] = ind.size();
+      }
+  CSRMatrix<scalar_t,integer_t> L(N, ptr.data(), ind.data(), val.data());
+  return compare_task_dag(argc, argv, L, n, n, n);
+}
+
+/*
+ * Check that the Chrome trace written by the factorization can be
+ * read back, that it contains all recorded events, and that every
+ * event has a valid elimination tree level.
+ */
+int test_front_trace(const string& fname) {
+  ifstream f(fname);
+  if (!f) {
+    cout << "ERROR: front trace " << fname << " was not written" << endl;
+    return 1;
+  }
+  stringstream ss;
+  ss << f.rdbuf();
+  auto t = ss.str();
+  const string head = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  auto last = t.find_last_not_of(" \n");
+  if (t.compare(0, head.size(), head) != 0 || last == string::npos ||
+      t.compare(last-1, 2, "]}") != 0) {
+    cout << "ERROR: front trace is not a Chrome trace" << endl;
+    return 1;
+  }
+  auto value = [](const string& e, const string& key) {
+    auto k = e.find("\"" + key + "\":");
+    if (k == string::npos) throw invalid_argument(key);
+    return e.substr(k + key.size() + 3);
+  };
+  size_t events = 0, factor = 0, extend_add = 0;
+  try {
+    for (auto b = t.find('{', head.size()); b != string::npos;
+         b = t.find('{', b)) {
+      auto e = t.find("}}", b);
+      if (e == string::npos) throw invalid_argument("}}");
+      auto ev = t.substr(b, e+2-b);
+      b = e + 2;
+      auto name = value(ev, "name");
+      name = name.substr(1, name.find('"', 1) - 1);
+      if (name == "factor") factor++;
+      else if (name == "extend_add") extend_add++;
+      else if (name != "assembly") throw invalid_argument(name);
+      if (value(ev, "ph").compare(0, 3, "\"X\"") != 0 ||
+          stod(value(ev, "ts")) < 0 || stod(value(ev, "dur")) < 0 ||
+          stoi(value(ev, "level")) < 0 || stoi(value(ev, "dim_sep")) < 0)
+        throw invalid_argument(ev);
+      events++;
+    }
+  } catch (std::exception& e) {
+    cout << "ERROR: could not parse front trace event: "
+         << e.what() << endl;
+    return 1;
+  }
+  cout << "# front trace: " << events << " events, " << factor
+       << " factor, " << extend_add << " extend_add" << endl;
+  if (events != FrontTrace::events().size() || !factor || !extend_add) {
+    cout << "ERROR: front trace is incomplete" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/*
+ * Nested dissection of a regular nx x ny x nz mesh, used to test a
+ * user-supplied permutation and separator tree.
+ */
+template<typename integer_t> SeparatorTree<integer_t>
+mesh_separator_tree(int nx, int ny, int nz, vector<int>& perm) {
+  perm.resize(nx*ny*nz);
+  vector<Separator<integer_t>> seps;
+  integer_t next = 0;
+  auto number = [&](int x0, int x1, int y0, int y1, int z0, int z1) {
+    for (int z=z0; z<z1; z++)
+      for (int y=y0; y<y1; y++)
+        for (int x=x0; x<x1; x++)
+          perm[x+nx*(y+ny*z)] = next++;
+  };
+  function<integer_t(int,int,int,int,int,int)> nd =
+    [&](int x0, int x1, int y0, int y1, int z0, int z1) {
+      int dx = x1-x0, dy = y1-y0, dz = z1-z0;
+      if (dx*dy*dz <= 8 || std::max(dx, std::max(dy, dz)) < 3) {
+        number(x0, x1, y0, y1, z0, z1);
+        seps.emplace_back(next, -1, -1, -1);
+        return integer_t(seps.size()-1);
+      }
+      integer_t l, r;
+      if (dx >= dy && dx >= dz) {
+        int m = x0 + dx/2;
+        l = nd(x0, m, y0, y1, z0, z1);
+        r = nd(m+1, x1, y0, y1, z0, z1);
+        number(m, m+1, y0, y1, z0, z1);
+      } else if (dy >= dz) {
+        int m = y0 + dy/2;
+        l = nd(x0, x1, y0, m, z0, z1);
+        r = nd(x0, x1, m+1, y1, z0, z1);
+        number(x0, x1, m, m+1, z0, z1);
+      } else {
+        int m = z0 + dz/2;
+        l = nd(x0, x1, y0, y1, z0, m);
+        r = nd(x0, x1, y0, y1, m+1, z1);
+        number(x0, x1, y0, y1, m, m+1);
+      }
+      seps.emplace_back(next, -1, l, r);
+      integer_t sep = seps.size()-1;
+      seps[l].pa = seps[r].pa = sep;
+      return sep;
+    };
+  nd(0, nx, 0, ny, 0, nz);
+  return SeparatorTree<integer_t>(seps);
+}
+
 template<typename scalar_t,typename integer_t> int
 test_sparse_solver(int argc, const char* const argv[],
                    CSRMatrix<scalar_t,integer_t>& A) {
@@ -79,6 +261,293 @@ test_sparse_solver(int argc, const char* const argv[],
     cout << "RESIDUAL TOO LARGE!" << endl;
     return 1;
   }
+  if (!spss.options().front_trace().empty() &&
+      test_front_trace(spss.options().front_trace()))
+    return 1;
+
+  if (spss.options().compression() == CompressionType::BLR &&
+      spss.options().BLR_options().CB_compression()) {
+    // factor again without CB compression, the compressed CBs should
+    // store fewer entries than the dense ones
+    StrumpackSparseSolver<scalar_t,integer_t> spss_dense_CB(false);
+    spss_dense_CB.options().set_from_command_line(argc, argv);
+    spss_dense_CB.options().BLR_options().disable_CB_compression();
+    spss_dense_CB.set_matrix(A);
+    if (spss_dense_CB.factor() != ReturnCode::SUCCESS) {
+      cout << "problem during factorization of the matrix." << endl;
+      return 1;
+    }
+    auto nnz_CB = spss.CB_nonzeros();
+    auto nnz_dense_CB = spss_dense_CB.CB_nonzeros();
+    cout << "# CB NONZEROS = " << nnz_CB << " (WITHOUT CB COMPRESSION "
+         << nnz_dense_CB << ")" << endl;
+    if (nnz_CB >= nnz_dense_CB) {
+      cout << "ERROR: CB compression did not reduce the CB memory"
+           << endl;
+      return 1;
+    }
+  }
+
+  if (spss.options().Krylov_solver() == KrylovSolver::PREC_GCRODR) {
+    // a second right-hand side, the space recycled from the first
+    // solve should reduce the number of iterations
+    auto its = spss.Krylov_iterations();
+    vector<scalar_t> b2(N), x2(N), x2_exact(N);
+    auto rgen = random::make_default_random_generator<real_t>();
+    rgen->seed(std::size_t(2));
+    for (auto& xi : x2_exact)
+      xi = rgen->get();
+    A.spmv(x2_exact.data(), b2.data());
+    spss.solve(b2.data(), x2.data());
+    comp_scal_res = A.max_scaled_residual(x2.data(), b2.data());
+    cout << "# COMPONENTWISE SCALED RESIDUAL (SECOND SOLVE) = "
+         << comp_scal_res << endl;
+    cout << "# KRYLOV ITERATIONS = " << its << ", "
+         << spss.Krylov_iterations() << " (SECOND SOLVE)" << endl;
+    if (comp_scal_res > ERROR_TOLERANCE*spss.options().rel_tol()) {
+      cout << "RESIDUAL TOO LARGE!" << endl;
+      return 1;
+    }
+    if (spss.Krylov_iterations() >= its) {
+      cout << "ERROR: the recycled space did not reduce the number "
+           << "of iterations" << endl;
+      return 1;
+    }
+  }
+
+  if (spss.options().incremental_factorization() ||
+      spss.options().HSS_warm_start() ||
+      spss.options().BLR_options().tiling() == BLR::Tiling::ADAPTIVE) {
+    // change a few diagonal entries, only the fronts containing these
+    // rows, and their ancestors, are refactored (incremental), the
+    // HSS fronts are recompressed from their old bases, or the BLR
+    // fronts are re-tiled using the observed tile ranks. This is done
+    // twice, the second update reuses the value map, or rebuilds it
+    // after the fronts were partitioned again.
+    auto fronts = spss.refactored_fronts();
+    auto cold_samples = spss.HSS_random_samples();
+    for (int r=0; r<2; r++) {
+      for (int i=10*r; i<std::min(N, 10*r+10); i++)
+        for (auto k=A.ptr(i); k<A.ptr(i+1); k++)
+          if (A.ind(k) == i) A.val(k) *= scalar_t(2.);
+      A.spmv(x_exact.data(), b.data());
+      spss.update_matrix_values(A);
+      if (spss.factor() != ReturnCode::SUCCESS) {
+        cout << "problem during refactorization of the matrix." << endl;
+        return 1;
+      }
+      if (spss.options().incremental_factorization()) {
+        auto refactored = spss.refactored_fronts();
+        cout << "# REFACTORED FRONTS = " << refactored
+             << " OF " << fronts << endl;
+        if (refactored <= 0 || refactored >= fronts) {
+          cout << "ERROR: incremental factorization did not skip "
+               << "any fronts" << endl;
+          return 1;
+        }
+      }
+      if (spss.options().HSS_warm_start() &&
+          spss.options().compression() == CompressionType::HSS) {
+        auto samples = spss.HSS_random_samples();
+        auto reused = spss.HSS_reused_nodes();
+        cout << "# HSS WARM START: REUSED NODES = " << reused
+             << ", SAMPLES = " << samples << " (COLD " << cold_samples
+             << ")" << endl;
+        if (reused <= 0 || samples >= cold_samples) {
+          cout << "ERROR: the HSS warm start did not reuse the bases"
+               << endl;
+          return 1;
+        }
+      }
+      spss.solve(b.data(), x.data());
+      comp_scal_res = A.max_scaled_residual(x.data(), b.data());
+      cout << "# COMPONENTWISE SCALED RESIDUAL (REFACTORED) = "
+           << comp_scal_res << endl;
+      if (comp_scal_res > ERROR_TOLERANCE*spss.options().rel_tol()) {
+        cout << "RESIDUAL TOO LARGE!" << endl;
+        return 1;
+      }
+    }
+  }
+  if (spss.options().compression() == CompressionType::NONE &&
+      spss.options().low_rank_update_max_rank() !=
+      SPOptions<scalar_t>().low_rank_update_max_rank()) {
+    // solve with A + U V^H, reusing the factorization of A. The
+    // same update is added twice, which results in a rank 4 update,
+    // which can be recompressed to rank 2.
+    const int k = 2;
+    real_t amax(0.);
+    for (integer_t i=0; i<A.nnz(); i++)
+      amax = std::max(amax, std::abs(A.val(i)));
+    DenseMatrix<scalar_t> U(N, k), V(N, k);
+    U.random();
+    V.random();
+    U.scale(scalar_t(amax / N));
+    for (int r=1; r<=2; r++) {
+      if (spss.add_low_rank_update(U, V) != ReturnCode::SUCCESS) {
+        cout << "problem adding low-rank update." << endl;
+        return 1;
+      }
+      cout << "# LOW-RANK UPDATE RANK = "
+           << spss.low_rank_update_rank() << endl;
+      // b = (A + r U V^H) x_exact
+      DenseMatrixWrapper<scalar_t> X(N, 1, x.data(), N),
+        Xe(N, 1, x_exact.data(), N), B(N, 1, b.data(), N);
+      DenseMatrix<scalar_t> z(k, 1);
+      A.spmv(x_exact.data(), b.data());
+      gemm(Trans::C, Trans::N, scalar_t(r), V, Xe, scalar_t(0.), z);
+      gemm(Trans::N, Trans::N, scalar_t(1.), U, z, scalar_t(1.), B);
+      spss.solve(B, X);
+      // residual b - (A + r U V^H) x
+      vector<scalar_t> Ax(N);
+      DenseMatrixWrapper<scalar_t> AX(N, 1, Ax.data(), N);
+      A.spmv(x.data(), Ax.data());
+      gemm(Trans::C, Trans::N, scalar_t(r), V, X, scalar_t(0.), z);
+      gemm(Trans::N, Trans::N, scalar_t(1.), U, z, scalar_t(1.), AX);
+      auto nrm_b = blas::nrm2(N, b.data(), 1);
+      blas::axpy(N, scalar_t(-1.), Ax.data(), 1, b.data(), 1);
+      auto rel_res = blas::nrm2(N, b.data(), 1) / nrm_b;
+      cout << "# RELATIVE RESIDUAL (LOW-RANK UPDATE) = "
+           << rel_res << endl;
+      if (rel_res > ERROR_TOLERANCE*spss.options().rel_tol()) {
+        cout << "RESIDUAL TOO LARGE!" << endl;
+        return 1;
+      }
+    }
+    if (spss.options().low_rank_update_max_rank() < 2*k &&
+        spss.low_rank_update_rank() != k) {
+      cout << "LOW-RANK UPDATE WAS NOT RECOMPRESSED!" << endl;
+      return 1;
+    }
+    // setting a new matrix drops the update
+    spss.set_matrix(A);
+    if (spss.low_rank_update_rank() != 0) {
+      cout << "LOW-RANK UPDATE WAS NOT CLEARED BY set_matrix!" << endl;
+      return 1;
+    }
+  }
+  if (spss.options().use_task_dag() && test_task_dag(argc, argv, A))
+    return 1;
+  bool test_symbolic_analysis = false;
+  for (int i=1; i<argc; i++)
+    if (!strcmp(argv[i], "--test_symbolic_analysis"))
+      test_symbolic_analysis = true;
+  if (test_symbolic_analysis) {
+    // reuse the symbolic analysis (matching, nested dissection and
+    // symbolic factorization) in a solver with a complex scalar type
+    using cplx_t = std::complex<real_t>;
+    auto symb = spss.symbolic_analysis();
+    vector<cplx_t> vals(A.nnz()), bc(N), xc(N), xc_exact(N);
+    for (integer_t i=0; i<A.nnz(); i++) vals[i] = cplx_t(A.val(i));
+    CSRMatrix<cplx_t,integer_t> Ac(N, A.ptr(), A.ind(), vals.data());
+    StrumpackSparseSolver<cplx_t,integer_t> spss_symb;
+    spss_symb.options().set_from_command_line(argc, argv);
+    spss_symb.set_matrix(Ac);
+    if (spss_symb.reorder(symb) != ReturnCode::SUCCESS ||
+        spss_symb.symbolic_analysis() != symb) {
+      cout << "problem reusing the symbolic analysis." << endl;
+      return 1;
+    }
+    for (int i=0; i<N; i++) xc_exact[i] = cplx_t(x_exact[i]);
+    Ac.spmv(xc_exact.data(), bc.data());
+    spss_symb.solve(bc.data(), xc.data());
+    comp_scal_res = Ac.max_scaled_residual(xc.data(), bc.data());
+    cout << "# COMPONENTWISE SCALED RESIDUAL (SYMBOLIC ANALYSIS) = "
+         << comp_scal_res << endl;
+    if (comp_scal_res > ERROR_TOLERANCE*spss.options().rel_tol()) {
+      cout << "RESIDUAL TOO LARGE!" << endl;
+      return 1;
+    }
+    // a cyclic shift of the rows and columns has the same size and
+    // number of nonzeros, but a different sparsity pattern
+    vector<integer_t> shift(N), ishift(N);
+    for (int i=0; i<N; i++) {
+      shift[i] = (i + 1) % N;
+      ishift[shift[i]] = i;
+    }
+    CSRMatrix<scalar_t,integer_t> Ashift(A);
+    Ashift.permute(ishift, shift);
+    StrumpackSparseSolver<scalar_t,integer_t> spss_shift(false);
+    spss_shift.options().set_from_command_line(argc, argv);
+    spss_shift.set_matrix(Ashift);
+    if (spss_shift.reorder(symb) != ReturnCode::REORDERING_ERROR) {
+      cout << "SYMBOLIC ANALYSIS ACCEPTED FOR A DIFFERENT PATTERN!" << endl;
+      return 1;
+    }
+  }
+  bool test_mixed_precision = false;
+  for (int i=1; i<argc; i++)
+    if (!strcmp(argv[i], "--test_mixed_precision"))
+      test_mixed_precision = true;
+  if (test_mixed_precision) {
+    // by default flexible GMRES in working precision, preconditioned
+    // with an inner GMRES solve using a lower precision
+    // factorization. With an explicit outer solver (for instance
+    // --sp_Krylov_solver gmres_ir) the inner solver is a single
+    // solve with the lower precision factorization.
+    using factor_t = typename LowerPrecisionType<scalar_t>::value_type;
+    SparseSolverMixedPrecision<factor_t,scalar_t,integer_t> spmp(false);
+    spmp.options().set_from_command_line(argc, argv);
+    spmp.solver().options().set_from_command_line(argc, argv);
+    if (spmp.options().Krylov_solver() == KrylovSolver::AUTO) {
+      spmp.options().set_Krylov_solver(KrylovSolver::PREC_FGMRES);
+      spmp.solver().options().set_Krylov_solver(KrylovSolver::PREC_GMRES);
+    } else
+      spmp.solver().options().set_Krylov_solver(KrylovSolver::DIRECT);
+    auto inner_rtol = spmp.solver().options().rel_tol();
+    spmp.set_matrix(A);
+    if (spmp.reorder() != ReturnCode::SUCCESS ||
+        spmp.factor() != ReturnCode::SUCCESS) {
+      cout << "problem with the mixed precision solver." << endl;
+      return 1;
+    }
+    A.spmv(x_exact.data(), b.data());
+    spmp.solve(b.data(), x.data());
+    comp_scal_res = A.max_scaled_residual(x.data(), b.data());
+    cout << "# COMPONENTWISE SCALED RESIDUAL (MIXED PRECISION) = "
+         << comp_scal_res << ", outer Krylov iterations = "
+         << spmp.Krylov_iterations() << endl;
+    if (comp_scal_res > ERROR_TOLERANCE*spmp.options().rel_tol()) {
+      cout << "RESIDUAL TOO LARGE!" << endl;
+      return 1;
+    }
+    if (spmp.solver().options().rel_tol() != inner_rtol) {
+      cout << "INNER TOLERANCE WAS NOT RESTORED!" << endl;
+      return 1;
+    }
+  }
+  bool test_user_separator_tree = false;
+  for (int i=1; i<argc; i++)
+    if (!strcmp(argv[i], "--test_user_separator_tree"))
+      test_user_separator_tree = true;
+  if (test_user_separator_tree) {
+    // nested dissection of the regular mesh, passed to a new solver
+    // as a user-supplied permutation and separator tree
+    auto nx = spss.options().nx(), ny = spss.options().ny(),
+      nz = spss.options().nz();
+    if (nx*ny*nz != N) {
+      cout << "--test_user_separator_tree requires --sp_nx/ny/nz." << endl;
+      return 1;
+    }
+    vector<int> perm;
+    auto tree = mesh_separator_tree<integer_t>(nx, ny, nz, perm);
+    StrumpackSparseSolver<scalar_t,integer_t> spss_tree;
+    spss_tree.options().set_from_command_line(argc, argv);
+    spss_tree.set_matrix(A);
+    if (spss_tree.reorder(perm.data(), tree) != ReturnCode::SUCCESS) {
+      cout << "problem with user-supplied separator tree." << endl;
+      return 1;
+    }
+    A.spmv(x_exact.data(), b.data());
+    spss_tree.solve(b.data(), x.data());
+    comp_scal_res = A.max_scaled_residual(x.data(), b.data());
+    cout << "# COMPONENTWISE SCALED RESIDUAL (USER SEPARATOR TREE) = "
+         << comp_scal_res << endl;
+    if (comp_scal_res > ERROR_TOLERANCE*spss.options().rel_tol()) {
+      cout << "RESIDUAL TOO LARGE!" << endl;
+      return 1;
+    }
+  }
   return 0;
 }
 